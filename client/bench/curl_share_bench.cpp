@@ -0,0 +1,140 @@
+/**
+ * @file curl_share_bench.cpp
+ * @brief New connections and time with private vs. shared curl caches
+ *
+ * English:
+ * Runs the same request mix with HttpClient(true, false) (private DNS/TLS
+ * session caches per client) and HttpClient(true, true) (the CurlGlobal
+ * share handle, DNS and TLS sessions only - connections stay per client):
+ * - sequential: N short-lived clients one after another, one GET each
+ *   (like the dedicated client of every streaming install)
+ * - concurrent: T threads, each with its own client doing R GETs
+ * and prints the new connections and the elapsed time. A CurlGlobal
+ * reference is held for the whole run, as main() would. The shared cases
+ * open as many connections as the private ones; with HTTPS their new
+ * connections resume a shared TLS session instead of a full handshake
+ * (count the resumptions on the server). Also times creating clients
+ * against the previous per-instance curl_global_init().
+ *
+ *   ./build/bench/curl_share_bench http://localhost:8000/rest/v1/ddi/v1/controller/device/device001 200 8 50
+ *
+ * 한국어:
+ * client별 캐시와 CurlGlobal share handle(DNS/TLS session만 공유, 연결은 client별)을
+ * 사용했을 때의 새 연결 수와 소요 시간을 비교합니다. 짧게 쓰고 버리는 client를 순서대로 만드는 경우와 여러 스레드가 각자 client를
+ * 쓰는 경우를 측정하며, 이전 방식(인스턴스마다 curl_global_init)과 client 생성 비용도
+ * 비교합니다.
+ */
+#include "curl_global.h"
+#include "http_client.h"
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result {
+    unsigned long requests = 0;
+    unsigned long failures = 0;
+    unsigned long new_connections = 0;
+    double seconds = 0;
+};
+
+void print(const char* name, const Result& result) {
+    std::printf("%-24s %8lu %8lu %8lu %9.3f s\n", name, result.requests, result.new_connections,
+                result.failures, result.seconds);
+}
+
+Result run_sequential(const std::string& url, int clients, bool shared) {
+    Result result;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < clients; ++i) {
+        HttpClient client(true, shared);
+        HttpResponse response = client.get(url);
+        result.requests++;
+        result.failures += response.status_code == 0 ? 1 : 0;
+        result.new_connections += client.connection_stats().new_connections;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+Result run_concurrent(const std::string& url, int threads, int requests, bool shared) {
+    std::atomic<unsigned long> failures(0);
+    std::atomic<unsigned long> new_connections(0);
+    std::vector<std::thread> workers;
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            HttpClient client(true, shared);
+            for (int r = 0; r < requests; ++r) {
+                if (client.get(url).status_code == 0) {
+                    failures++;
+                }
+            }
+            new_connections += client.connection_stats().new_connections;
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    Result result;
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.requests = static_cast<unsigned long>(threads) * requests;
+    result.failures = failures;
+    result.new_connections = new_connections;
+    return result;
+}
+
+/** @brief client 생성/소멸 비용 (요청 없음) */
+template <typename Fn>
+double microseconds_per_client(int clients, Fn create) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < clients; ++i) {
+        create();
+    }
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / clients;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <url> [sequential_clients] [threads] [requests_per_thread]"
+                  << std::endl;
+        return 1;
+    }
+    std::string url = argv[1];
+    int clients = argc > 2 ? std::atoi(argv[2]) : 200;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 8;
+    int requests = argc > 4 ? std::atoi(argv[4]) : 50;
+
+    std::printf("%-24s %8s %8s %8s %11s\n", "case", "requests", "connects", "failed", "time");
+    std::shared_ptr<CurlGlobal> curl_global = CurlGlobal::acquire();
+    print("sequential private", run_sequential(url, clients, false));
+    print("sequential shared", run_sequential(url, clients, true));
+    print("concurrent private", run_concurrent(url, threads, requests, false));
+    print("concurrent shared", run_concurrent(url, threads, requests, true));
+    curl_global.reset();
+
+    // 이전 방식: 인스턴스마다 curl_global_init/cleanup (다른 참조가 없는 상태)
+    const int kCreateClients = 1000;
+    double legacy_us = microseconds_per_client(kCreateClients, []() {
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        CURL* handle = curl_easy_init();
+        curl_easy_cleanup(handle);
+        curl_global_cleanup();
+    });
+    curl_global = CurlGlobal::acquire();
+    double refcounted_us = microseconds_per_client(kCreateClients, []() { HttpClient client; });
+    std::printf("\nclient create+destroy: %.1f us per-instance curl_global_init, %.1f us refcounted\n",
+                legacy_us, refcounted_us);
+    return 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file ddi_parser_bench.cpp
+ * @brief DDI response parse time and heap allocations per parse
+ *
+ * English:
+ * Builds a large multi-chunk deploymentBase response and parses it repeatedly
+ * with the previous find/substr approach and with parse_ddi_response().
+ * Heap allocations are counted by replacing the global operator new.
+ * Needs no server:
+ *
+ *   ./build/bench/ddi_parser_bench [chunks] [artifacts_per_chunk] [iterations]
+ *
+ * 한국어:
+ * chunk가 많은 큰 deploymentBase 응답을 만들어 이전 find/substr 방식과
+ * parse_ddi_response()로 반복 파싱하고, 파싱 1회당 시간과 heap 할당 횟수를 출력합니다.
+ * 전역 operator new를 교체하여 할당 횟수를 셉니다. 서버가 필요 없습니다.
+ */
+#include "ddi_parser.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::atomic<unsigned long> g_allocations(0);
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+/** @brief chunks × artifacts 크기의 DDI deploymentBase 응답 생성 */
+std::string build_response(int chunks, int artifacts_per_chunk) {
+    std::ostringstream json;
+    json << "{\"config\":{\"polling\":{\"sleep\":\"00:05:00\"}},"
+         << "\"_links\":{\"configData\":{\"href\":\"http://localhost:8000/configData\"}},"
+         << "\"deploymentBase\":{\"id\":\"12345\",\"deployment\":{"
+         << "\"download\":\"forced\",\"update\":\"forced\",\"maintenanceWindow\":\"available\","
+         << "\"chunks\":[";
+    for (int c = 0; c < chunks; ++c) {
+        json << (c ? "," : "") << "{\"part\":\"module" << c << "\",\"version\":\"1.0." << c
+             << "\",\"name\":\"module-" << c << "\","
+             << "\"metadata\":[{\"key\":\"size\",\"value\":\"not-a-number\"},"
+             << "{\"key\":\"href\",\"value\":\"http://metadata.invalid\"}],"
+             << "\"artifacts\":[";
+        for (int a = 0; a < artifacts_per_chunk; ++a) {
+            json << (a ? "," : "") << "{\"filename\":\"artifact-" << c << "-" << a << ".bin\","
+                 << "\"size\":" << (1048576 + c * 4096 + a) << ","
+                 << "\"hashes\":{\"sha1\":\"2d86c2a659e364e9abba49ea6ffcd53dd5559f05\","
+                 << "\"md5\":\"0d1b08c34858921bc7c662b228acb7ba\","
+                 << "\"sha256\":\"a03b221c6c6eae7122ca51695d456d5222e524889136394944b2f9763b483615\"},"
+                 << "\"_links\":{\"download\":{\"href\":\"https://localhost:8000/files/" << c << "/" << a
+                 << "\"},\"download-http\":{\"href\":\"http://localhost:8000/files/" << c << "/" << a
+                 << "\"},\"md5sum-http\":{\"href\":\"http://localhost:8000/files/" << c << "/" << a
+                 << ".MD5SUM\"}}}";
+        }
+        json << "]}";
+    }
+    json << "]}}}";
+    return json.str();
+}
+
+/**
+ * @brief 이전 HawkbitClient의 find/substr 파싱 (비교 기준)
+ *
+ * 첫 번째 일치만 찾고 멈추므로 빠르지만, 문서 앞쪽의 다른 "href"를 다운로드 URL로
+ * 잘못 읽고 첫 artifact 외에는 보지 못합니다.
+ */
+std::string legacy_field(const std::string& json, const std::string& key, size_t from) {
+    size_t key_pos = json.find("\"" + key + "\":", from);
+    if (key_pos == std::string::npos) {
+        return std::string();
+    }
+    size_t value_start = json.find("\"", key_pos + key.size() + 3);
+    size_t value_end = json.find("\"", value_start + 1);
+    return json.substr(value_start + 1, value_end - value_start - 1);
+}
+
+size_t legacy_parse(const std::string& json, std::string* url_out = nullptr) {
+    size_t deployment_pos = json.find("\"deploymentBase\"");
+    size_t id_pos = json.find("\"id\":", deployment_pos);
+    size_t id_start = json.find("\"", id_pos + 5) + 1;
+    std::string id = json.substr(id_start, json.find("\"", id_start) - id_start);
+    size_t href_pos = json.find("\"href\":");
+    size_t url_start = json.find("\"", href_pos + 7) + 1;
+    std::string url = json.substr(url_start, json.find("\"", url_start) - url_start);
+    std::string sha256 = legacy_field(json, "sha256", deployment_pos);
+    std::string sha1 = legacy_field(json, "sha1", deployment_pos);
+    std::string md5 = legacy_field(json, "md5", deployment_pos);
+    if (url_out) {
+        *url_out = url;
+    }
+    return id.size() + url.size() + sha256.size() + sha1.size() + md5.size();
+}
+
+template <typename Fn>
+void run(const char* name, int iterations, size_t bytes, Fn fn) {
+    volatile size_t sink = 0;
+    unsigned long allocations_before = g_allocations.load();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink = sink + fn();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    unsigned long allocations = g_allocations.load() - allocations_before;
+    std::printf("%-22s %10.2f us/parse %9.1f MB/s %8.1f allocs/parse\n", name,
+                seconds * 1e6 / iterations, bytes * iterations / seconds / (1024.0 * 1024.0),
+                static_cast<double>(allocations) / iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int chunks = argc >= 2 ? std::atoi(argv[1]) : 16;
+    int artifacts_per_chunk = argc >= 3 ? std::atoi(argv[2]) : 4;
+    int iterations = argc >= 4 ? std::atoi(argv[3]) : 2000;
+
+    std::string json = build_response(chunks, artifacts_per_chunk);
+    std::printf("response: %zu bytes, %d chunks x %d artifacts, %d iterations\n",
+                json.size(), chunks, artifacts_per_chunk, iterations);
+
+    // 파싱 결과는 poll마다 재사용 (HawkbitClient::ddi_view_와 동일)
+    static DdiDeploymentView view;
+    if (!parse_ddi_response(json, view) || !view.has_deployment) {
+        std::fprintf(stderr, "parse_ddi_response failed\n");
+        return 1;
+    }
+    std::printf("parsed: %zu chunks, %zu artifacts%s, first href %.*s\n", view.chunk_count,
+                view.artifact_count, view.truncated ? " (truncated)" : "",
+                static_cast<int>(view.primary_artifact()->href().size()),
+                view.primary_artifact()->href().data());
+
+    std::string legacy_url;
+    legacy_parse(json, &legacy_url);
+    std::printf("legacy first href: %s\n", legacy_url.c_str());
+
+    run("find/substr (legacy)", iterations, json.size(), [&]() { return legacy_parse(json); });
+    run("parse_ddi_response", iterations, json.size(), [&]() {
+        parse_ddi_response(json, view);
+        return view.artifact_count;
+    });
+    return 0;
+}
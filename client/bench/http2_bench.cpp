@@ -0,0 +1,124 @@
+/**
+ * @file http2_bench.cpp
+ * @brief Connections and control-request latency during a bulk download
+ *
+ * English:
+ * Starts a large artifact download on an AsyncHttpEngine and, while it
+ * runs, sends a poll request every 100 ms (stream weight 256 in the HTTP/2
+ * modes, like HawkbitClient's polls and status reports). Prints the
+ * connections the engine opened, the download throughput and the latency
+ * percentiles of the control requests. Modes:
+ * - h1:  HttpVersion::kAuto on http:// (every concurrent request needs its own connection)
+ * - h2:  HttpVersion::kHttp2 (https://, ALPN)
+ * - h2c: HttpVersion::kHttp2PriorKnowledge (http://, local testing)
+ * The optional weight argument overrides the control stream weight (16 =
+ * same as the download) to show what the priorities contribute. Shape the
+ * link first, otherwise loopback hides all queueing, e.g.:
+ *
+ *   sudo tc qdisc add dev lo root tbf rate 200mbit burst 512kb latency 100ms
+ *   ./build/bench/http2_bench http://localhost:8443 /files/big.bin /rest/v1/ddi/v1/controller/device/device001 h2c 50
+ *
+ * 한국어:
+ * 큰 artifact를 내려받는 동안 100 ms마다 poll 요청을 보내, 엔진이 연 연결 수와 다운로드
+ * 처리량, 제어 요청의 지연 시간 백분위를 출력합니다. h1/h2/h2c 모드와 제어 stream weight를
+ * 바꿔 가며 비교합니다. loopback은 대기열이 생기지 않으므로 tc로 대역폭/지연을 제한한 뒤
+ * 측정하세요.
+ */
+#include "async_http_engine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(values.size() * fraction));
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "Usage: " << argv[0] << " <base_url> <artifact_path> <poll_path> <h1|h2|h2c>"
+                  << " [samples] [control_weight]" << std::endl;
+        return 1;
+    }
+    std::string base = argv[1];
+    std::string artifact_url = base + argv[2];
+    std::string poll_url = base + argv[3];
+    std::string mode = argv[4];
+    int samples = argc > 5 ? std::atoi(argv[5]) : 50;
+    long control_weight = argc > 6 ? std::atol(argv[6]) : 256;
+
+    HttpVersion version = HttpVersion::kAuto;
+    if (mode == "h2") {
+        version = HttpVersion::kHttp2;
+    } else if (mode == "h2c") {
+        version = HttpVersion::kHttp2PriorKnowledge;
+    } else if (mode != "h1") {
+        std::cerr << "Unknown mode: " << mode << std::endl;
+        return 1;
+    }
+    AsyncHttpEngine engine(0, version);
+
+    // 측정이 끝나면 on_data가 false를 돌려 다운로드를 중단
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> downloaded(0);
+    AsyncRequest download;
+    download.url = artifact_url;
+    download.on_data = [&stop, &downloaded](const char* data, size_t size) {
+        (void)data;
+        downloaded += size;
+        return !stop.load();
+    };
+    Clock::time_point start = Clock::now();
+    std::future<HttpResponse> download_done = engine.submit(std::move(download));
+
+    // 다운로드가 실제로 데이터를 받기 시작한 뒤에 측정
+    while (downloaded.load() == 0 &&
+           download_done.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready) {
+    }
+
+    std::vector<double> latencies;
+    unsigned long failures = 0;
+    while (static_cast<int>(latencies.size()) < samples &&
+           download_done.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+        AsyncRequest poll;
+        poll.url = poll_url;
+        poll.timeout_seconds = 30;
+        poll.stream_weight = control_weight;
+        Clock::time_point before = Clock::now();
+        HttpResponse response = engine.submit(std::move(poll)).get();
+        if (response.status_code != 200) {
+            failures++;
+            continue;
+        }
+        latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - before).count());
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t bytes = downloaded.load();
+    stop = true;
+    download_done.wait();
+
+    HttpConnectionStats stats = engine.connection_stats();
+    std::printf("%-4s weight %3ld: %lu connections, %lu/%lu requests over HTTP/2, download %.1f MB/s, "
+                "poll p50 %.1f ms p99 %.1f ms max %.1f ms (%zu samples, %lu failed)\n",
+                mode.c_str(), control_weight, stats.new_connections, stats.http2_requests, stats.requests,
+                bytes / seconds / (1024.0 * 1024.0), percentile(latencies, 0.5), percentile(latencies, 0.99),
+                percentile(latencies, 1.0), latencies.size(), failures);
+    return 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file poll_alloc_bench.cpp
+ * @brief Heap allocations per poll with a fresh vs. a reused response
+ *
+ * English:
+ * Repeats a GET (a poll URL, or any larger resource to stand in for a big
+ * poll response) and counts heap allocations made by this process while
+ * each request runs, by replacing the global operator new:
+ * - get:      HttpClient::get(), a new HttpResponse per request
+ * - get_into: HttpClient::get_into() with one HttpResponse kept alive
+ * The first request of each case is a warm-up (connection, buffer growth)
+ * and is not counted. libcurl's own malloc() calls are not C++ allocations
+ * and are not included.
+ *
+ *   ./build/bench/poll_alloc_bench http://localhost:8000/rest/v1/ddi/v1/controller/device/device001 1000
+ *
+ * 한국어:
+ * 같은 GET을 반복하며 요청 1회당 heap 할당 횟수와 할당 바이트 수를 출력합니다.
+ * 매번 새 HttpResponse를 쓰는 get()과 응답 객체를 재사용하는 get_into()를 비교합니다.
+ * 전역 operator new를 교체하여 할당을 세며, libcurl 내부의 malloc()은 포함되지 않습니다.
+ */
+#include "http_client.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<unsigned long> g_allocations(0);
+std::atomic<unsigned long> g_allocated_bytes(0);
+
+} // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result {
+    unsigned long failures = 0;
+    unsigned long allocations = 0;
+    unsigned long allocated_bytes = 0;
+    size_t body_size = 0;
+    size_t header_count = 0;
+    double seconds = 0;
+};
+
+template <typename Fn>
+Result run(int requests, Fn request) {
+    Result result;
+    request();   // warm-up: connection, DNS, buffer growth
+    unsigned long allocations = g_allocations.load();
+    unsigned long bytes = g_allocated_bytes.load();
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < requests; ++i) {
+        const HttpResponse& response = request();
+        if (response.status_code != 200) {
+            result.failures++;
+        }
+        result.body_size = response.body.size();
+        result.header_count = response.headers.size();
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.allocations = g_allocations.load() - allocations;
+    result.allocated_bytes = g_allocated_bytes.load() - bytes;
+    return result;
+}
+
+void print(const char* name, const Result& result, int requests) {
+    std::printf("%-10s %10zu %8zu %12.1f %14.1f %10.1f %8lu\n", name, result.body_size, result.header_count,
+                static_cast<double>(result.allocations) / requests,
+                static_cast<double>(result.allocated_bytes) / requests, result.seconds * 1e6 / requests,
+                result.failures);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <url> [requests]" << std::endl;
+        return 1;
+    }
+    std::string url = argv[1];
+    int requests = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    HttpClient client;
+    HttpResponse fresh;
+    Result fresh_result = run(requests, [&]() -> const HttpResponse& {
+        fresh = client.get(url);
+        return fresh;
+    });
+
+    HttpResponse reused;
+    Result reused_result = run(requests, [&]() -> const HttpResponse& {
+        client.get_into(url, reused);
+        return reused;
+    });
+
+    std::printf("%-10s %10s %8s %12s %14s %10s %8s\n", "case", "body", "headers", "allocs/req", "bytes/req",
+                "us/req", "failed");
+    print("get", fresh_result, requests);
+    print("get_into", reused_result, requests);
+    return 0;
+}
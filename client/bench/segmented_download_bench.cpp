@@ -0,0 +1,71 @@
+/**
+ * @file segmented_download_bench.cpp
+ * @brief Single-stream vs. N-segment download throughput
+ *
+ * English:
+ * Downloads the same artifact with HttpClient::download_file (one stream) and
+ * with SegmentedDownloader using 1, 2, 4 and 8 segments, and prints MB/s.
+ * Start the stand-in server with an injected latency so that each stream is
+ * RTT-bound, e.g.:
+ *
+ *   cd server && HAWKBIT_LATENCY_MS=50 uv run main.py
+ *   ./build/bench/segmented_download_bench http://localhost:8000/files/firmware.bin 1048576
+ *
+ * 한국어:
+ * 같은 artifact를 단일 스트림과 1/2/4/8개 segment로 내려받아 처리량(MB/s)을 비교합니다.
+ * 서버에 지연을 주입해야 스트림 하나가 RTT에 묶이는 환경이 재현됩니다.
+ */
+#include "http_client.h"
+#include "segmented_downloader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+template <typename Fn>
+double measure_seconds(Fn fn, bool* ok) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    *ok = fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void print_row(const std::string& name, size_t bytes, double seconds, bool ok) {
+    std::printf("%-18s %8.3f s %10.2f MB/s %s\n", name.c_str(), seconds,
+                bytes / seconds / (1024.0 * 1024.0), ok ? "" : "(FAILED)");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <artifact_url> <file_size> [repeats]" << std::endl;
+        return 1;
+    }
+    std::string url = argv[1];
+    size_t file_size = std::strtoull(argv[2], nullptr, 10);
+    int repeats = argc >= 4 ? std::atoi(argv[3]) : 3;
+    const std::string path = "segmented_bench.bin";
+
+    HttpClient http_client;
+    AsyncHttpEngine engine;
+
+    for (int r = 0; r < repeats; ++r) {
+        bool ok = false;
+        double seconds = measure_seconds([&]() { return http_client.download_file(url, path, ArtifactHashes(), file_size); }, &ok);
+        print_row("single-stream", file_size, seconds, ok);
+
+        const size_t segment_counts[] = {1, 2, 4, 8};
+        for (size_t segments : segment_counts) {
+            SegmentedDownloader downloader(engine, segments);
+            seconds = measure_seconds([&]() { return downloader.download(url, path, file_size).get(); }, &ok);
+            print_row(std::to_string(segments) + "-segment", file_size, seconds, ok);
+        }
+        std::printf("\n");
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
@@ -23,6 +23,7 @@ if [ -f "build/client" ]; then
     echo ""
     echo "Usage:"
     echo "  ./build/client [server_url] [controller_id]"
+    echo "  ./build/client --fleet N [--duration S] [--connections C] [server_url]"
     echo ""
     echo "Example:"
     echo "  ./build/client http://localhost:8000 device001"
@@ -0,0 +1,204 @@
+/**
+ * @file artifact_cache.h
+ * @brief Content-addressed cache of downloaded artifacts
+ *
+ * English:
+ * Keeps verified artifacts under their strongest DDI digest
+ * ("<dir>/sha256-<hex>.artifact"), so an artifact that is assigned again -
+ * a rollback, a re-assignment, or several controllers behind one gateway -
+ * is copied from local storage instead of being downloaded. Entries are
+ * only added after the download verified every digest (written to a
+ * temporary name and renamed), and a cache hit is checked against the
+ * digests again while it is copied into the sink; a corrupt entry is
+ * removed and the caller downloads instead.
+ * The cache is bounded by total bytes and by entry count and evicts the
+ * least recently used entry first. The LRU order is the files'
+ * modification time (touched on every hit), so it survives restarts.
+ *
+ * 한국어:
+ * 검증된 artifact를 DDI 해시 이름으로 보관하여, 같은 artifact가 다시 배포되면
+ * (rollback, 재할당, gateway 뒤의 여러 controller) 다운로드하지 않고 로컬에서 복사합니다.
+ * 다운로드가 모든 해시를 확인한 뒤에만 임시 이름으로 쓴 파일을 rename하여 추가하고,
+ * 캐시에서 꺼낼 때도 sink로 복사하면서 다시 해시를 확인합니다 (손상된 항목은 삭제 후
+ * 다운로드). 전체 크기와 항목 수 제한을 넘으면 가장 오래 사용하지 않은 항목부터
+ * 삭제합니다. 사용 순서는 파일 수정 시각(hit마다 갱신)이라 재시작 후에도 유지됩니다.
+ */
+
+#ifndef ARTIFACT_CACHE_H
+#define ARTIFACT_CACHE_H
+
+#include "artifact_hasher.h"
+#include "download_sink.h"
+#include "file_writer.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @struct ArtifactCacheOptions
+ * @brief Cache location and limits / 캐시 위치와 제한
+ */
+struct ArtifactCacheOptions {
+    std::string directory;                      ///< Cache directory (created if missing)
+    uint64_t max_bytes = 1024ULL * 1024 * 1024; ///< Total size limit (0 = unlimited)
+    size_t max_entries = 16;                    ///< Entry count limit (0 = unlimited)
+};
+
+/**
+ * @struct ArtifactCacheStats
+ * @brief Cache counters since open() / 캐시 통계
+ */
+struct ArtifactCacheStats {
+    unsigned long hits = 0;         ///< Artifacts delivered from the cache
+    unsigned long misses = 0;       ///< Lookups that had to download
+    unsigned long insertions = 0;   ///< Verified artifacts added
+    unsigned long evictions = 0;    ///< Entries removed for the size/count limits
+    uint64_t bytes_saved = 0;       ///< Artifact bytes delivered instead of downloaded
+    size_t entries = 0;             ///< Current entry count
+    uint64_t bytes = 0;             ///< Current total size
+};
+
+/**
+ * @class ArtifactCache
+ * @brief LRU, size-limited artifact store keyed by digest / 해시 기반 artifact 캐시
+ *
+ * Thread-safe: background downloads fill it while the polling loop (or
+ * other controllers sharing it) looks entries up.
+ */
+class ArtifactCache {
+public:
+    explicit ArtifactCache(const ArtifactCacheOptions& options);
+
+    ArtifactCache(const ArtifactCache&) = delete;
+    ArtifactCache& operator=(const ArtifactCache&) = delete;
+
+    /**
+     * @brief Creates the directory, loads existing entries and applies the limits
+     *
+     * Leftover temporary files of interrupted insertions are removed.
+     */
+    bool open();
+
+    /**
+     * @brief Cache key of an artifact: strongest digest, e.g. "sha256-<hex>"
+     *
+     * @return empty if the deployment has no usable digest (not cached)
+     */
+    static std::string key(const ArtifactHashes& hashes);
+
+    /**
+     * @brief Whether the artifact is cached with the given size / 캐시 여부 확인
+     *
+     * Counts a miss when it is not. size 0 accepts any size.
+     */
+    bool lookup(const ArtifactHashes& hashes, uint64_t size);
+
+    /**
+     * @brief Path of a cached entry (for serving it directly), marks it used
+     *
+     * @return empty if not cached; the file may be evicted afterwards, so
+     *         open it right away (an open descriptor stays valid)
+     */
+    std::string entry_path(const ArtifactHashes& hashes);
+
+    /**
+     * @brief Copies a cached artifact into sink, verifying the digests
+     *
+     * @return true if the sink was committed (counts a hit); false if the
+     *         entry is missing, corrupt (then removed, counts a miss) or the
+     *         sink failed - the sink is aborted in that case
+     */
+    bool deliver(const ArtifactHashes& hashes, uint64_t size, DownloadSink& sink);
+
+    /**
+     * @brief Adds a verified file by copying it / 검증된 파일을 복사하여 추가
+     *
+     * For downloads that are not written sequentially (parallel ranges); the
+     * original file stays untouched.
+     */
+    bool insert_file(const ArtifactHashes& hashes, const std::string& path);
+
+    /** @brief New temporary file name for an entry being written / 임시 파일 이름 */
+    std::string temp_path(const std::string& key);
+
+    /**
+     * @brief Moves a complete, verified temporary file into the cache
+     *
+     * Evicts least recently used entries to stay within the limits; an
+     * artifact larger than max_bytes is not kept.
+     */
+    bool commit(const std::string& temp_path, const std::string& key);
+
+    ArtifactCacheStats stats() const;
+
+    const std::string& directory() const { return options_.directory; }
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t size;
+    };
+    typedef std::list<Entry> LruList;   ///< Most recently used first
+
+    ArtifactCacheOptions options_;
+    mutable std::mutex mutex_;
+    LruList lru_;
+    std::unordered_map<std::string, LruList::iterator> entries_;
+    ArtifactCacheStats stats_;
+    unsigned long temp_counter_;
+
+    std::string entry_file(const std::string& key) const;
+
+    /** @brief Moves an entry to the front and touches its file (mutex_ held) */
+    void mark_used(LruList::iterator entry);
+
+    /** @brief Removes an entry and its file (mutex_ held) */
+    void remove_entry(LruList::iterator entry);
+
+    /** @brief Evicts from the back until within the limits (mutex_ held) */
+    void enforce_limits();
+};
+
+/**
+ * @class CachingSink
+ * @brief Passes a download to another sink and keeps a copy in the cache
+ *
+ * English:
+ * Writes every byte to the inner sink and to a temporary cache file. The
+ * copy is committed only when the download finishes (i.e. after it was
+ * verified) and the inner sink committed too; abort() discards it. A cache
+ * write error never fails the download - the artifact is just not cached.
+ * Wrap it outside a DecompressingSink: the cache keeps the received bytes,
+ * which are what the digests describe.
+ *
+ * 한국어:
+ * 받은 데이터를 안쪽 sink와 캐시 임시 파일에 함께 기록합니다. 다운로드가 검증되어
+ * finish()가 불린 뒤에만 캐시에 추가하고, abort()는 임시 파일을 버립니다. 캐시 쓰기
+ * 오류는 다운로드를 실패시키지 않습니다.
+ */
+class CachingSink : public DownloadSink {
+public:
+    CachingSink(std::unique_ptr<DownloadSink> inner, std::shared_ptr<ArtifactCache> cache,
+                const ArtifactHashes& hashes);
+    ~CachingSink() override;
+
+    bool open(uint64_t expected_size) override;
+    bool write(const char* data, size_t size) override;
+    bool finish() override;
+    void abort() override;
+    std::string describe() const override { return inner_->describe() + " (+ cache)"; }
+
+private:
+    std::unique_ptr<DownloadSink> inner_;
+    std::shared_ptr<ArtifactCache> cache_;
+    std::string key_;
+    std::string temp_path_;
+    FileWriter writer_;
+    bool caching_;          ///< Copy still being written (false after an error)
+};
+
+#endif // ARTIFACT_CACHE_H
@@ -0,0 +1,198 @@
+/**
+ * @file artifact_gateway.h
+ * @brief Gateway mode: fetch each artifact once, serve it to sibling devices
+ *
+ * English:
+ * Devices behind one uplink usually download the same bundle. In gateway
+ * mode one client also runs a small HTTP server on the LAN; the sibling
+ * controllers keep polling the hawkBit server themselves but download
+ * their artifacts through the gateway (HawkbitClient::set_gateway_url):
+ *
+ *   GET /artifact/<key>?size=<bytes>&url=<percent-encoded artifact URL>
+ *
+ * <key> is the artifact's cache key ("sha256-<hex>", see ArtifactCache).
+ * A cached artifact is sent from the cache file with sendfile(); single
+ * byte ranges are supported, so siblings keep their parallel range and
+ * resume logic. The first request for an uncached artifact starts one
+ * upstream download into the cache, verified against the digest in the
+ * key; every request for it - the first and all concurrent ones - is
+ * served from the growing file as bytes arrive, so nothing is fetched
+ * twice and no sibling waits for the whole download.
+ * Only artifact URLs below the configured upstream prefix are fetched
+ * (same scheme, host and port, path below the prefix path, no user info),
+ * so the gateway is not an open proxy.
+ *
+ * 한국어:
+ * 같은 uplink 뒤의 기기들은 대부분 같은 bundle을 받습니다. gateway 모드에서는 한 클라이언트가
+ * LAN에 작은 HTTP 서버를 함께 실행하고, 다른 controller들은 polling은 그대로 hawkBit 서버에
+ * 하면서 artifact만 gateway를 통해 받습니다. 캐시에 있는 artifact는 캐시 파일에서
+ * sendfile()로 보내고 단일 Range를 지원합니다. 캐시에 없으면 첫 요청이 upstream 다운로드를
+ * 하나 시작하고(키의 해시로 검증), 그 요청과 동시에 들어온 요청 모두 받는 중인 파일에서
+ * 도착한 만큼씩 전송합니다. 설정된 upstream prefix 아래의 URL만 받습니다 (open proxy 방지).
+ *
+ * @dot
+ * digraph Gateway {
+ *   rankdir=LR;
+ *   node [shape=box, style=filled, fillcolor=lightblue];
+ *   server [label="hawkBit server"];
+ *   gateway [label="gateway\n(ArtifactCache)", fillcolor=lightgreen];
+ *   a [label="device A"]; b [label="device B"]; c [label="device C"];
+ *   server -> gateway [label="1x artifact"];
+ *   gateway -> a; gateway -> b; gateway -> c;
+ *   a -> server [style=dashed, label="poll/status"];
+ * }
+ * @enddot
+ */
+
+#ifndef ARTIFACT_GATEWAY_H
+#define ARTIFACT_GATEWAY_H
+
+#include "artifact_cache.h"
+#include "rate_limiter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @struct GatewayOptions
+ * @brief Listening address and upstream restriction / gateway 설정
+ */
+struct GatewayOptions {
+    std::string bind_address = "0.0.0.0";  ///< IPv4 address to listen on
+    unsigned short port = 8080;             ///< 0 = any free port (see ArtifactGateway::port())
+    std::string upstream_prefix;            ///< Allowed upstream: scheme://host[:port][/path] (empty = serve cache only)
+    int idle_timeout_seconds = 60;          ///< Close kept-alive connections idle this long
+    RateLimitOptions uplink_rate_limit;     ///< Shared by all upstream fetches (LAN side is never limited)
+};
+
+/**
+ * @struct GatewayStats
+ * @brief Counters since start() / gateway 통계
+ */
+struct GatewayStats {
+    unsigned long connections = 0;
+    unsigned long requests = 0;             ///< Artifact requests answered with 200/206
+    unsigned long range_requests = 0;       ///< ... of which 206
+    unsigned long cache_hits = 0;           ///< Served from a complete cache entry
+    unsigned long fetches = 0;              ///< Upstream downloads started
+    unsigned long failed_fetches = 0;
+    uint64_t bytes_served = 0;              ///< Body bytes sent to siblings
+    uint64_t bytes_fetched = 0;             ///< Artifact bytes downloaded from upstream
+
+    /** @brief Uplink bytes saved compared with every sibling downloading itself */
+    int64_t saved_bytes() const {
+        return static_cast<int64_t>(bytes_served) - static_cast<int64_t>(bytes_fetched);
+    }
+};
+
+/**
+ * @class ArtifactGateway
+ * @brief HTTP/1.1 artifact server for sibling controllers / 형제 기기용 artifact 서버
+ *
+ * One thread accepts connections and one thread per connection serves
+ * kept-alive requests (a plant has dozens of siblings, not thousands);
+ * each upstream download runs on its own thread.
+ */
+class ArtifactGateway {
+public:
+    ArtifactGateway(const std::shared_ptr<ArtifactCache>& cache, const GatewayOptions& options);
+    ~ArtifactGateway();
+
+    ArtifactGateway(const ArtifactGateway&) = delete;
+    ArtifactGateway& operator=(const ArtifactGateway&) = delete;
+
+    /** @brief Binds, listens and starts the accept thread / 서버 시작 */
+    bool start();
+
+    /** @brief Closes every connection, cancels fetches and joins all threads / 서버 종료 */
+    void stop();
+
+    /** @brief Listening port (after start()) / 실제 port */
+    unsigned short port() const { return port_; }
+
+    /**
+     * @brief Gateway URL of an artifact for a sibling / 형제 기기가 요청할 URL
+     *
+     * @param gateway_url e.g. "http://192.168.1.10:8080"
+     * @return empty if the artifact has no usable digest (download directly)
+     */
+    static std::string artifact_url(const std::string& gateway_url, const std::string& download_url,
+                                    uint64_t size, const ArtifactHashes& hashes);
+
+    GatewayStats stats() const;
+
+private:
+    /** @brief Upstream download in progress, shared by the requests reading it */
+    struct Fetch {
+        std::string key;
+        std::string url;
+        std::string temp_path;      ///< Cache temporary file being written
+        uint64_t size = 0;
+        uint64_t written = 0;       ///< Bytes in temp_path so far
+        bool done = false;
+        bool ok = false;
+        std::thread thread;
+    };
+
+    struct Connection {
+        int fd;
+        std::string peer;                   ///< Sibling address for logs
+        std::atomic<bool> finished;         ///< Set last by the connection thread
+        std::thread thread;
+    };
+
+    std::shared_ptr<ArtifactCache> cache_;
+    GatewayOptions options_;
+    std::shared_ptr<RateLimiter> uplink_limiter_;   ///< nullptr = unlimited
+    int listen_fd_;
+    unsigned short port_;
+    std::atomic<bool> stopping_;
+    std::thread accept_thread_;
+
+    mutable std::mutex mutex_;          ///< Guards everything below
+    std::condition_variable progress_;  ///< A fetch wrote bytes or finished
+    std::list<Connection> connections_;
+    std::map<std::string, std::shared_ptr<Fetch>> fetches_;     ///< By key, in progress only
+    std::list<std::shared_ptr<Fetch>> finished_fetches_;        ///< Threads still to join
+    GatewayStats stats_;
+
+    void accept_loop();
+    void serve_connection(Connection* connection);
+
+    /**
+     * @brief Answers one parsed request / 요청 하나 처리
+     *
+     * @param sent body bytes sent
+     * @return false to close the connection
+     */
+    bool handle_request(int fd, const std::string& method, const std::string& target,
+                        const std::string& range, bool keep_alive, uint64_t& sent);
+
+    /**
+     * @brief Cached entry or in-progress fetch of an artifact (starts a fetch if neither)
+     *
+     * @param fd opened for reading on success
+     * @param fetch set while the artifact is still being downloaded
+     * @return HTTP status: 200, or the error to answer with
+     */
+    int open_artifact(const std::string& key, const std::string& url, uint64_t size, int& fd,
+                      uint64_t& length, std::shared_ptr<Fetch>& fetch);
+
+    void run_fetch(std::shared_ptr<Fetch> fetch);
+
+    /** @brief Sends [offset, offset + length) of fd, waiting for a fetch to provide it */
+    bool send_body(int socket, int fd, uint64_t offset, uint64_t length, const std::shared_ptr<Fetch>& fetch,
+                   uint64_t& sent);
+
+    /** @brief Joins finished connection/fetch threads (mutex_ not held) */
+    void reap_threads();
+};
+
+#endif // ARTIFACT_GATEWAY_H
@@ -0,0 +1,92 @@
+/**
+ * @file artifact_hasher.h
+ * @brief Streaming artifact hash verification (SHA-256 / SHA-1 / MD5)
+ *
+ * English:
+ * Computes artifact digests incrementally while bytes arrive from the
+ * network, so verification needs no extra read of the file from flash.
+ * Uses OpenSSL's EVP interface, which selects hardware-accelerated code
+ * paths (SHA-NI, AVX2, ARMv8 crypto extensions) at runtime.
+ *
+ * 한국어:
+ * 네트워크에서 데이터가 도착하는 즉시 artifact 해시를 점진적으로 계산하므로
+ * 다운로드 후 flash에서 파일을 다시 읽을 필요가 없습니다. OpenSSL EVP 인터페이스를
+ * 사용하며, 실행 시점에 CPU가 지원하는 하드웨어 가속 경로(SHA-NI, AVX2,
+ * ARMv8 crypto extension)가 자동으로 선택됩니다.
+ */
+
+#ifndef ARTIFACT_HASHER_H
+#define ARTIFACT_HASHER_H
+
+#include <string>
+
+/**
+ * @struct ArtifactHashes
+ * @brief Hex digests from the DDI deployment descriptor / 배포 정보의 해시 값
+ *
+ * hawkBit은 artifact마다 "hashes": {"sha1", "md5", "sha256"}를 제공합니다.
+ * 비어 있는 필드는 검증하지 않습니다.
+ */
+struct ArtifactHashes {
+    std::string sha256;     ///< Lowercase hex SHA-256 (64 chars)
+    std::string sha1;       ///< Lowercase hex SHA-1 (40 chars)
+    std::string md5;        ///< Lowercase hex MD5 (32 chars)
+
+    /** @brief true if no digest is known / 검증할 해시가 없는지 여부 */
+    bool empty() const { return sha256.empty() && sha1.empty() && md5.empty(); }
+};
+
+/**
+ * @class StreamingHasher
+ * @brief Incremental digest computation and comparison / 점진적 해시 계산 및 비교
+ *
+ * English:
+ * Only the algorithms with an expected value are computed. update() must be
+ * fed the artifact bytes strictly in order; verify() finalizes the digests.
+ *
+ * 한국어:
+ * 기대값이 있는 알고리즘만 계산합니다. update()에는 artifact를 처음부터 순서대로
+ * 전달해야 하며, verify()에서 최종 해시를 계산해 비교합니다.
+ */
+class StreamingHasher {
+public:
+    explicit StreamingHasher(const ArtifactHashes& expected);
+    ~StreamingHasher();
+
+    StreamingHasher(const StreamingHasher&) = delete;
+    StreamingHasher& operator=(const StreamingHasher&) = delete;
+
+    /** @brief true if at least one digest is verified / 검증할 해시가 있는지 여부 */
+    bool enabled() const { return enabled_; }
+
+    /** @brief Feeds the next bytes of the artifact / 다음 데이터 전달 */
+    void update(const void* data, size_t size);
+
+    /** @brief Number of bytes hashed so far / 지금까지 해시한 byte 수 */
+    size_t bytes_hashed() const { return bytes_; }
+
+    /**
+     * @brief Finalizes all digests and compares them with the expected values
+     *
+     * @return true if every expected digest matches (also true when disabled);
+     *         false if a digest with an expected value could not be computed
+     *         (e.g. MD5/SHA-1 rejected by a FIPS provider)
+     */
+    bool verify();
+
+    /** @brief Digests computed by verify() / verify()가 계산한 실제 해시 */
+    const ArtifactHashes& actual() const { return actual_; }
+
+private:
+    enum { kSha256 = 0, kSha1, kMd5, kAlgorithmCount };
+
+    ArtifactHashes expected_;
+    ArtifactHashes actual_;
+    void* contexts_[kAlgorithmCount];   ///< EVP_MD_CTX* per algorithm (nullptr = unused)
+    bool enabled_;
+    bool failed_;                       ///< A digest with an expected value could not be computed
+    bool finalized_;
+    size_t bytes_;
+};
+
+#endif // ARTIFACT_HASHER_H
@@ -0,0 +1,253 @@
+/**
+ * @file async_http_engine.h
+ * @brief Asynchronous HTTP engine on the curl multi interface
+ *
+ * English:
+ * Runs many HTTP transfers concurrently on a single event-loop thread
+ * (curl multi + epoll) and delivers completions through callbacks or
+ * std::future. Complements the blocking HttpClient for long transfers such
+ * as firmware downloads, so polling and status reporting are never stalled.
+ *
+ * 한국어:
+ * curl multi 인터페이스와 epoll을 이용해 하나의 이벤트 루프 스레드에서 여러 HTTP
+ * 전송을 동시에 처리하고, 완료 결과를 callback 또는 std::future로 전달합니다.
+ * 펌웨어 다운로드처럼 오래 걸리는 전송이 polling/상태 보고를 막지 않도록
+ * 블로킹 HttpClient를 보완합니다.
+ *
+ * HTTP/2 mode: all transfers to a server become streams of one connection
+ * (CURLPIPE_MULTIPLEX + CURLOPT_PIPEWAIT), and each request's stream weight
+ * tells the server how to share the connection, so a small status report
+ * is not queued behind a bulk download.
+ * HTTP/2 모드에서는 서버당 연결 하나에 모든 전송을 stream으로 다중화하고, 요청별
+ * stream weight로 대역폭 배분을 서버에 알립니다.
+ *
+ * @dot
+ * digraph AsyncEngineFlow {
+ *   rankdir=LR;
+ *   node [shape=box, style=filled, fillcolor=lightblue];
+ *
+ *   caller [label="caller thread\n(submit)", fillcolor=lightgreen];
+ *   queue [label="pending queue\n+ eventfd"];
+ *   loop [label="event loop thread\n(epoll_wait)"];
+ *   multi [label="curl_multi_socket_action"];
+ *   done [label="completion\n(callback / future)", fillcolor=lightcoral];
+ *
+ *   caller -> queue -> loop -> multi -> done;
+ *   multi -> loop [label="socket/timer\ncallbacks"];
+ * }
+ * @enddot
+ *
+ * Key C++ Learning Points / 핵심 C++ 학습 포인트:
+ * - std::thread, std::mutex, std::atomic 기반 스레드 간 통신
+ * - std::promise / std::future 로 비동기 결과 전달
+ * - std::function 으로 callback 저장
+ * - C 라이브러리 callback과 static 멤버 함수 연결
+ */
+
+#ifndef ASYNC_HTTP_ENGINE_H
+#define ASYNC_HTTP_ENGINE_H
+
+#include "curl_global.h"
+#include "http_client.h"
+#include "file_writer.h"
+#include "rate_limiter.h"
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct AsyncRequest
+ * @brief Description of one asynchronous transfer / 비동기 전송 요청 정보
+ *
+ * English:
+ * When on_data is set, the response body is streamed to it instead of being
+ * collected in HttpResponse::body. Returning false aborts the transfer.
+ * expected_status guards on_data against bodies of unexpected responses
+ * (e.g. a 200 full body answering a Range request).
+ * With rate_limiter set, the transfer is paused whenever the limiter is in
+ * debt and resumed by the event loop when it has paid it back; transfers
+ * sharing a limiter share its rate.
+ * can_accept lets a consumer with bounded buffers (a writer thread) push
+ * back without blocking the event loop: when it returns false the transfer
+ * is paused with the chunk kept by curl, and the consumer calls
+ * AsyncHttpEngine::resume_receiving() once it has room again.
+ *
+ * 한국어:
+ * on_data가 설정되면 응답 body를 HttpResponse::body에 모으지 않고 바로 전달합니다.
+ * false를 반환하면 전송이 중단됩니다. expected_status를 지정하면 다른 status의
+ * body(예: Range 요청에 대한 200 전체 응답)는 on_data에 전달되기 전에 중단됩니다.
+ * rate_limiter를 지정하면 limiter의 token이 모자랄 때 전송을 일시 정지하고, 이벤트 루프가
+ * 시간이 되면 재개합니다 (같은 limiter를 쓰는 전송들이 속도를 나눠 씀).
+ * can_accept가 false를 반환하면 이벤트 루프를 막지 않고 전송을 일시 정지하며(데이터는
+ * curl이 보관), 소비자가 공간이 생겼을 때 AsyncHttpEngine::resume_receiving()을 호출하면
+ * 같은 데이터부터 다시 전달됩니다.
+ */
+struct AsyncRequest {
+    std::string url;                                    // Target URL
+    std::string method = "GET";                         // "GET" or "POST"
+    std::string body;                                   // POST body
+    std::vector<std::string> headers;                   // Extra "Name: value" headers
+    std::function<bool(const char*, size_t)> on_data;   // Optional streaming body handler
+    std::function<bool(size_t)> can_accept;             // Optional: false pauses before on_data (see above)
+    long timeout_seconds = 0;                           // 0 = no overall timeout (stalls still abort)
+    long expected_status = 0;                           // Non-zero: abort before on_data on any other status
+    long stream_weight = 16;                            // HTTP/2 stream weight 1-256 (16 = protocol default)
+    bool accept_encoding = false;                       // Send Accept-Encoding; body arrives decoded
+    bool compress_body = false;                         // gzip the POST body if that makes it smaller
+    std::shared_ptr<RateLimiter> rate_limiter;          // Optional receive bandwidth limit (shared)
+};
+
+/**
+ * @brief HTTP version policy of an AsyncHttpEngine / HTTP 버전 정책
+ */
+enum class HttpVersion {
+    kAuto,                  ///< curl default: HTTP/1.1 on http://, HTTP/2 via ALPN on https://
+    kHttp2,                 ///< HTTP/2 via ALPN on https:// (HTTP/1.1 fallback), multiplexed
+    kHttp2PriorKnowledge    ///< h2c without upgrade on http:// (local testing), multiplexed
+};
+
+/**
+ * @class AsyncHttpEngine
+ * @brief Event-loop driven HTTP engine / 이벤트 루프 기반 HTTP 엔진
+ *
+ * English:
+ * The constructor starts the event-loop thread, the destructor stops it and
+ * completes any unfinished transfer with status code 0. Completion callbacks
+ * run on the event-loop thread and must not block; they may submit new
+ * transfers.
+ *
+ * 한국어:
+ * 생성자에서 이벤트 루프 스레드를 시작하고 소멸자에서 종료합니다(RAII). 끝나지 않은
+ * 전송은 status code 0으로 완료 처리됩니다. 완료 callback은 이벤트 루프 스레드에서
+ * 실행되므로 블로킹하면 안 되며, callback 안에서 새 전송을 submit할 수 있습니다.
+ */
+class AsyncHttpEngine {
+public:
+    /** @brief Completion callback type / 완료 callback 타입 */
+    typedef std::function<void(HttpResponse&)> Completion;
+
+    /**
+     * @brief Creates the multi handle, epoll instance and event-loop thread
+     *
+     * @param max_host_connections connection pool size per host (0 = curl default,
+     *        unlimited). Transfers beyond the limit wait for a free connection.
+     * @param http_version kHttp2/kHttp2PriorKnowledge multiplex every transfer
+     *        to a server over one connection and apply AsyncRequest::stream_weight
+     */
+    explicit AsyncHttpEngine(long max_host_connections = 0, HttpVersion http_version = HttpVersion::kAuto);
+
+    /**
+     * @brief Stops the event loop and releases all curl/epoll resources
+     */
+    ~AsyncHttpEngine();
+
+    AsyncHttpEngine(const AsyncHttpEngine&) = delete;
+    AsyncHttpEngine& operator=(const AsyncHttpEngine&) = delete;
+
+    /**
+     * @brief Queues a transfer; on_complete runs on the event-loop thread
+     *
+     * Thread-safe. Returns immediately. Transfers submitted during shutdown
+     * (e.g. by a completion callback) are completed with status code 0 like
+     * the others; once the loop has exited, that happens on the calling thread.
+     */
+    void submit(AsyncRequest request, Completion on_complete);
+
+    /**
+     * @brief Queues a transfer and returns a future for its response
+     */
+    std::future<HttpResponse> submit(AsyncRequest request);
+
+    /** @brief Asynchronous GET / 비동기 GET */
+    std::future<HttpResponse> get(const std::string& url);
+
+    /** @brief Asynchronous POST / 비동기 POST */
+    std::future<HttpResponse> post(const std::string& url,
+                                   const std::string& data,
+                                   const std::string& content_type = "application/json");
+
+    /**
+     * @brief Streams a file to disk in the background
+     *
+     * Written through a FileWriter; a failed download removes the file.
+     *
+     * @param expected_size bytes to preallocate (0 = unknown)
+     * @return future that becomes true on HTTP 200 and a complete, synced write
+     */
+    std::future<bool> download_file(const std::string& url, const std::string& filepath,
+                                    const FileWriteOptions& options = FileWriteOptions(),
+                                    uint64_t expected_size = 0);
+
+    /**
+     * @brief Resumes transfers paused by AsyncRequest::can_accept / 공간 부족으로 멈춘 전송 재개
+     *
+     * Thread-safe; called by consumers when buffer space was freed. Each paused
+     * transfer asks can_accept again and pauses again if there is still no room.
+     */
+    void resume_receiving();
+
+    /** @brief Number of queued or running transfers / 진행 중인 전송 수 */
+    size_t active_transfers() const { return active_.load(); }
+
+    /** @brief Connection reuse counters (snapshot) / 연결 재사용 통계 */
+    HttpConnectionStats connection_stats() const;
+
+    /**
+     * @brief Wire vs. decoded byte counters (snapshot) / 압축 절감 통계
+     *
+     * Counts buffered responses (no on_data) and POST bodies.
+     */
+    HttpCompressionStats compression_stats() const;
+
+    /** @brief Configured HTTP version policy / HTTP 버전 정책 */
+    HttpVersion http_version() const { return http_version_; }
+
+private:
+    /** @brief Per-transfer state, defined in the implementation file */
+    struct Transfer;
+
+    std::shared_ptr<CurlGlobal> curl_global_;  ///< Keeps libcurl initialized
+    void* multi_handle_;        ///< CURLM* (opaque, curl headers not exposed)
+    int epoll_fd_;              ///< epoll instance watching curl sockets
+    int wake_fd_;               ///< eventfd used to wake the loop on submit/stop
+    long timer_deadline_ms_;    ///< Absolute curl timer deadline, -1 = none
+    HttpVersion http_version_;
+
+    std::atomic<bool> stop_;
+    std::atomic<size_t> active_;
+    std::atomic<bool> resume_requested_;     ///< Set by resume_receiving()
+
+    std::mutex queue_mutex_;                 ///< Guards pending_ and closed_
+    std::vector<Transfer*> pending_;         ///< Submitted, not yet added to multi
+    bool closed_;                            ///< Loop finished; submit() completes immediately
+    std::vector<Transfer*> running_;         ///< Owned by the event-loop thread (unordered)
+
+    mutable std::mutex stats_mutex_;         ///< Guards stats_ and compression_stats_
+    HttpConnectionStats stats_;
+    HttpCompressionStats compression_stats_;
+
+    std::thread loop_thread_;
+
+    void run_loop();
+    void add_pending_transfers();
+    void compress_request_body(AsyncRequest& request);
+    void process_completed_transfers();
+    long resume_paused_transfers();
+    void resume_blocked_transfers();
+    void unpause(const std::vector<Transfer*>& transfers);
+    void finish_transfer(Transfer* transfer, int curl_code);
+    void wake();
+
+    // libcurl C callbacks (static, userp carries the engine/transfer)
+    static int SocketCallback(void* easy, int sockfd, int what, void* userp, void* socketp);
+    static int TimerCallback(void* multi, long timeout_ms, void* userp);
+    static size_t StreamCallback(void* contents, size_t size, size_t nmemb, void* userp);
+};
+
+#endif // ASYNC_HTTP_ENGINE_H
@@ -0,0 +1,146 @@
+/**
+ * @file chunk_index.h
+ * @brief Content-defined chunking and the delta-update chunk index
+ *
+ * English:
+ * An artifact is split into chunks whose boundaries are chosen by a gear
+ * rolling hash over the content (FastCDC-style), not by fixed offsets. A
+ * change in a new image therefore only alters the chunks around it; every
+ * other chunk keeps its SHA-256 even when data before it was inserted or
+ * removed. The server publishes the chunk list of an artifact as a text
+ * index ("<artifact URL>.cidx", generated by server/chunk_index.py); the
+ * client chunks its installed image with the same parameters and only has
+ * to download the chunks it does not have.
+ *
+ * The chunker must produce exactly the boundaries of server/chunk_index.py:
+ * gear table = 256 splitmix64 values (seed 0); no cut in the first
+ * min_size bytes of a chunk, then h = (h << 1) + gear[byte] and a cut after
+ * the byte where the top avg_bits bits of h are zero, or at max_size.
+ *
+ * 한국어:
+ * artifact를 고정 offset이 아니라 내용에 따라(gear rolling hash) chunk로 나눕니다. 새
+ * 이미지에서 바뀐 부분 주변의 chunk만 달라지고, 앞쪽에 데이터가 삽입/삭제되어도 나머지
+ * chunk의 SHA-256은 그대로입니다. 서버는 artifact의 chunk 목록을 텍스트 index로 제공하고
+ * ("<artifact URL>.cidx"), 클라이언트는 설치된 이미지를 같은 방식으로 나누어 없는 chunk만
+ * 받습니다. chunker는 server/chunk_index.py와 같은 경계를 만들어야 합니다.
+ *
+ * Index format / index 형식:
+ * @code
+ * hawkbit-cidx 1 <size> <min_size> <avg_bits> <max_size>
+ * <offset> <length> <sha256 hex>
+ * ...
+ * @endcode
+ */
+
+#ifndef CHUNK_INDEX_H
+#define CHUNK_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/** @brief Raw SHA-256 of a chunk / chunk의 SHA-256 (32 bytes) */
+typedef std::array<uint8_t, 32> ChunkDigest;
+
+/** @brief Hash functor for ChunkDigest keys (the digest is already uniform) */
+struct ChunkDigestHash {
+    size_t operator()(const ChunkDigest& digest) const {
+        size_t value;
+        std::memcpy(&value, digest.data(), sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * @struct ChunkingParams
+ * @brief Chunk size limits / chunk 크기 설정
+ *
+ * Taken from the index header, so server and client always agree.
+ */
+struct ChunkingParams {
+    size_t min_size = 16 * 1024;    ///< No boundary before this many bytes
+    unsigned avg_bits = 16;         ///< Average chunk size 2^avg_bits (64 KiB)
+    size_t max_size = 256 * 1024;   ///< Forced boundary
+};
+
+/** @brief One chunk of the target artifact / 대상 artifact의 chunk 하나 */
+struct ChunkIndexEntry {
+    uint64_t offset;
+    uint32_t length;
+    ChunkDigest digest;
+};
+
+/** @brief Parsed chunk index / 파싱된 chunk index */
+struct ChunkIndex {
+    uint64_t size = 0;                      ///< Artifact size (sum of all chunk lengths)
+    ChunkingParams params;
+    std::vector<ChunkIndexEntry> chunks;    ///< In artifact order, without gaps
+};
+
+/**
+ * @brief Parses an index document / index 문서 파싱
+ *
+ * @return false if the header is unknown, a line is malformed, the chunks
+ *         are not contiguous or do not add up to the declared size
+ */
+bool parse_chunk_index(std::string_view text, ChunkIndex& index);
+
+/** @brief SHA-256 of data / 데이터의 SHA-256 */
+ChunkDigest chunk_digest(const void* data, size_t size);
+
+/** @brief Lowercase hex form (for file names and logs) / 16진수 문자열 */
+std::string chunk_digest_hex(const ChunkDigest& digest);
+
+/**
+ * @class ContentChunker
+ * @brief Gear-hash chunk boundary finder / gear hash chunk 경계 탐색
+ */
+class ContentChunker {
+public:
+    explicit ContentChunker(const ChunkingParams& params);
+
+    /**
+     * @brief Length of the chunk starting at data[0]
+     *
+     * @param size bytes available at data
+     * @param end_of_data true if nothing follows data[size - 1]
+     * @return chunk length, or 0 if more data is needed to decide
+     *         (size < max_size and not end_of_data)
+     */
+    size_t next_chunk(const uint8_t* data, size_t size, bool end_of_data) const;
+
+    const ChunkingParams& params() const { return params_; }
+
+private:
+    ChunkingParams params_;
+    uint64_t mask_;             ///< Top avg_bits bits set
+};
+
+/** @brief Where a chunk lies in a local image / 로컬 이미지 안의 chunk 위치 */
+struct SeedChunk {
+    uint64_t offset;
+    uint32_t length;
+};
+
+/** @brief Chunks of a local image by digest / digest로 찾는 로컬 이미지 chunk */
+typedef std::unordered_map<ChunkDigest, SeedChunk, ChunkDigestHash> SeedIndex;
+
+/**
+ * @brief Chunks a local image (file or block device) / 로컬 이미지를 chunk로 나누어 색인
+ *
+ * Reads the image once in large blocks and records every chunk under its
+ * SHA-256. Duplicate chunks keep the first location.
+ *
+ * @param size bytes to index (0 = whole file; for a slot device pass the
+ *        installed image size if known, so trailing free space is skipped)
+ * @return false if the image cannot be read
+ */
+bool index_seed_image(const std::string& path, const ChunkingParams& params, SeedIndex& seed,
+                      uint64_t size = 0);
+
+#endif // CHUNK_INDEX_H
@@ -0,0 +1,61 @@
+/**
+ * @file chunk_store.h
+ * @brief Local content-addressed chunk directory for delta updates
+ *
+ * English:
+ * Keeps chunks downloaded by earlier delta updates under their SHA-256
+ * ("<dir>/ab/abcdef....chunk", like a casync chunk store), so a chunk that
+ * is not in the installed image is downloaded only once - e.g. when an
+ * update is retried, or when several artifacts share it. Files are
+ * written to a temporary name and renamed, so a power cut never leaves a
+ * partial chunk under a valid name, and every read is checked against its
+ * digest.
+ *
+ * 한국어:
+ * 이전 delta 업데이트에서 받은 chunk를 SHA-256 이름으로 보관합니다 (casync chunk
+ * 저장소와 같은 구조). 재시도하거나 여러 artifact가 같은 chunk를 쓸 때 다시 받지
+ * 않습니다. 임시 이름으로 쓴 뒤 rename하므로 전원이 꺼져도 잘린 chunk가 남지 않고,
+ * 읽을 때마다 digest를 확인합니다.
+ */
+
+#ifndef CHUNK_STORE_H
+#define CHUNK_STORE_H
+
+#include "chunk_index.h"
+
+#include <string>
+
+/**
+ * @class ChunkStore
+ * @brief Chunk files named by digest / digest 이름의 chunk 파일 저장소
+ */
+class ChunkStore {
+public:
+    explicit ChunkStore(const std::string& directory) : directory_(directory) {}
+
+    /** @brief Creates the directory if needed / 디렉터리 생성 */
+    bool open();
+
+    /** @brief Whether a chunk file exists (not verified) / chunk 존재 여부 */
+    bool contains(const ChunkDigest& digest) const;
+
+    /**
+     * @brief Reads a chunk into out / chunk 읽기
+     *
+     * @return false if missing, unreadable or not matching the digest
+     *         (a corrupt file is removed)
+     */
+    bool read(const ChunkDigest& digest, std::string& out) const;
+
+    /** @brief Stores a verified chunk / 검증된 chunk 저장 */
+    bool put(const ChunkDigest& digest, const char* data, size_t size);
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string directory_;
+
+    std::string chunk_path(const ChunkDigest& digest) const;
+};
+
+#endif // CHUNK_STORE_H
@@ -0,0 +1,198 @@
+/**
+ * @file compression.h
+ * @brief HTTP content coding helpers and byte-savings counters
+ *
+ * English:
+ * Response decoding is done by libcurl: with CURLOPT_ACCEPT_ENCODING set to
+ * "" it advertises every coding it was built with (gzip, deflate and, when
+ * available, br and zstd) and decodes the body while it streams in, so the
+ * write callbacks only ever see decoded bytes. Request bodies are not
+ * compressed by libcurl; gzip_compress() produces a gzip member for
+ * "Content-Encoding: gzip" POST bodies (status reports).
+ *
+ * 한국어:
+ * 응답 디코딩은 libcurl이 담당합니다. CURLOPT_ACCEPT_ENCODING을 ""로 설정하면 빌드에
+ * 포함된 모든 coding(gzip, deflate, 가능하면 br, zstd)을 Accept-Encoding으로 알리고
+ * 수신하면서 스트리밍으로 풀어 write callback에는 디코딩된 바이트만 전달합니다. 요청
+ * body는 libcurl이 압축하지 않으므로 gzip_compress()로 "Content-Encoding: gzip" POST
+ * body(상태 보고)를 만듭니다.
+ *
+ * Compressed artifacts:
+ * An artifact can also arrive compressed in two ways. With decode_downloads
+ * the download sends Accept-Encoding and libcurl decodes a
+ * "Content-Encoding: gzip" body; the DDI digests describe the original
+ * image, so they are checked on the decoded bytes. An artifact stored
+ * compressed on the server ("firmware.bin.gz", "rootfs.ext4.zst") is
+ * identified by its file name; StreamDecompressor expands it while it is
+ * written (DecompressingSink). Its DDI digests describe the stored .gz/.zst
+ * file and are checked on the received bytes; the decoded stream is covered
+ * by the format's own check (gzip CRC-32 and length, zstd content checksum).
+ * zstd needs libzstd at build time (HAWKBIT_HAVE_ZSTD).
+ *
+ * 압축 artifact는 두 가지 방식으로 받습니다. decode_downloads를 켜면 다운로드에도
+ * Accept-Encoding을 보내고 libcurl이 "Content-Encoding: gzip" body를 풀어 주며, DDI 해시는
+ * 원본 이미지의 해시이므로 디코딩된 바이트로 검증합니다. 서버에 압축된 채로 저장된
+ * artifact(.gz/.zst 파일 이름)는 StreamDecompressor가 기록 경로에서 바로 풀고
+ * (DecompressingSink), DDI 해시는 저장된 압축 파일 기준이므로 수신 바이트로 검증합니다.
+ * 풀린 데이터는 포맷 자체의 검사(gzip CRC-32/길이, zstd checksum)로 확인합니다.
+ */
+
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+/**
+ * @struct HttpCompressionOptions
+ * @brief Content coding negotiation settings / 압축 협상 설정
+ */
+struct HttpCompressionOptions {
+    bool accept_encoding = true;        ///< Send Accept-Encoding for API requests, decode responses
+    bool compress_requests = false;     ///< gzip POST bodies (server must accept Content-Encoding: gzip)
+    size_t min_request_size = 256;      ///< Smaller POST bodies are sent as-is
+    bool decode_downloads = false;      ///< Accept-Encoding on artifact downloads (single stream, no Range)
+};
+
+/**
+ * @struct HttpCompressionStats
+ * @brief Byte-savings counters / 압축으로 줄어든 전송량 통계
+ *
+ * API requests (poll, status report) and artifact downloads streamed with
+ * HttpClient::download_to_sink() are counted separately.
+ */
+struct HttpCompressionStats {
+    unsigned long responses = 0;            ///< Responses with a body
+    unsigned long compressed_responses = 0; ///< ... of which had a Content-Encoding
+    uint64_t response_wire_bytes = 0;       ///< Body bytes as received
+    uint64_t response_body_bytes = 0;       ///< Body bytes after decoding
+    unsigned long compressed_requests = 0;  ///< POST bodies sent with Content-Encoding: gzip
+    uint64_t request_body_bytes = 0;        ///< POST body bytes before compression
+    uint64_t request_wire_bytes = 0;        ///< POST body bytes sent
+    unsigned long downloads = 0;            ///< Completed artifact downloads
+    unsigned long compressed_downloads = 0; ///< ... of which had a Content-Encoding
+    uint64_t download_wire_bytes = 0;       ///< Artifact bytes as received
+    uint64_t download_body_bytes = 0;       ///< Artifact bytes after decoding
+
+    /** @brief Adds another counter set (e.g. HttpClient + AsyncHttpEngine) */
+    void add(const HttpCompressionStats& other) {
+        responses += other.responses;
+        compressed_responses += other.compressed_responses;
+        response_wire_bytes += other.response_wire_bytes;
+        response_body_bytes += other.response_body_bytes;
+        compressed_requests += other.compressed_requests;
+        request_body_bytes += other.request_body_bytes;
+        request_wire_bytes += other.request_wire_bytes;
+        downloads += other.downloads;
+        compressed_downloads += other.compressed_downloads;
+        download_wire_bytes += other.download_wire_bytes;
+        download_body_bytes += other.download_body_bytes;
+    }
+
+    /** @brief Bytes not transferred thanks to compression (negative if it cost bytes) */
+    int64_t saved_bytes() const {
+        return static_cast<int64_t>(response_body_bytes + request_body_bytes + download_body_bytes) -
+               static_cast<int64_t>(response_wire_bytes + request_wire_bytes + download_wire_bytes);
+    }
+};
+
+/**
+ * @brief gzip-compresses data into out / 데이터를 gzip으로 압축
+ *
+ * @param level zlib level 1 (fast) .. 9 (small)
+ * @return false on zlib error (out is then unspecified)
+ */
+bool gzip_compress(const char* data, size_t size, std::string& out, int level = 6);
+
+/**
+ * @brief Whether a Content-Encoding value means the body was encoded
+ *
+ * Empty and "identity" mean no coding.
+ */
+bool is_content_encoded(std::string_view content_encoding);
+
+/** @brief Compression format of a stored artifact / artifact 압축 형식 */
+enum class ContentCoding {
+    kIdentity,
+    kGzip,
+    kZstd
+};
+
+/**
+ * @brief Coding from an artifact file name suffix (".gz", ".zst")
+ *
+ * Case-insensitive; anything else is kIdentity.
+ */
+ContentCoding coding_from_filename(std::string_view filename);
+
+/** @brief "gzip", "zstd" or "identity" (for logs) */
+const char* coding_name(ContentCoding coding);
+
+/** @brief Whether this build can decode the coding (zstd needs HAWKBIT_HAVE_ZSTD) */
+bool coding_supported(ContentCoding coding);
+
+/**
+ * @class StreamDecompressor
+ * @brief Incremental gzip/zstd decoder / 스트리밍 압축 해제
+ *
+ * Feed compressed bytes in any split with update(); decoded bytes are
+ * handed to the output callback in pieces of at most kOutputSize as soon
+ * as they are available, so memory use does not depend on the artifact
+ * size. Concatenated gzip members and zstd frames are decoded in sequence.
+ * finished() tells whether the input ended exactly at the end of a
+ * complete member/frame, i.e. whether a truncated download can be told
+ * apart from a complete one.
+ */
+class StreamDecompressor {
+public:
+    /** @brief Receives decoded bytes; return false to stop (e.g. sink write failed) */
+    typedef std::function<bool(const char* data, size_t size)> Output;
+
+    static const size_t kOutputSize = 64 * 1024;   ///< Decode buffer per update step
+
+    StreamDecompressor(ContentCoding coding, Output output);
+    ~StreamDecompressor();
+
+    StreamDecompressor(const StreamDecompressor&) = delete;
+    StreamDecompressor& operator=(const StreamDecompressor&) = delete;
+
+    /** @brief Allocates the decoder state; false if unsupported or out of memory */
+    bool init();
+
+    /**
+     * @brief Decodes the next compressed bytes
+     *
+     * @return false on corrupt input (including a failed CRC/checksum) or
+     *         when the output callback returned false
+     */
+    bool update(const char* data, size_t size);
+
+    /** @brief Input ended at a member/frame boundary / 압축 스트림이 완결되었는지 */
+    bool finished() const { return finished_; }
+
+    uint64_t bytes_in() const { return bytes_in_; }     ///< Compressed bytes consumed
+    uint64_t bytes_out() const { return bytes_out_; }   ///< Decoded bytes produced
+
+    ContentCoding coding() const { return coding_; }
+
+private:
+    struct State;
+
+    bool update_gzip(const char* data, size_t size);
+    bool update_zstd(const char* data, size_t size);
+    bool emit(size_t size);
+
+    ContentCoding coding_;
+    Output output_;
+    std::unique_ptr<State> state_;
+    std::unique_ptr<char[]> buffer_;    ///< kOutputSize decode buffer
+    bool finished_;
+    uint64_t bytes_in_;
+    uint64_t bytes_out_;
+};
+
+#endif // COMPRESSION_H
@@ -0,0 +1,68 @@
+/**
+ * @file curl_global.h
+ * @brief Process-wide libcurl initialization and shared caches
+ *
+ * English:
+ * curl_global_init()/curl_global_cleanup() must run once per process, not
+ * once per client: calling them from every HttpClient constructor and
+ * destructor is not thread-safe and repeats the TLS library setup for every
+ * short-lived client. CurlGlobal is a reference-counted owner of that state:
+ * the first acquire() initializes libcurl, the last released reference
+ * cleans it up.
+ *
+ * It also owns a CURLSH share handle. HttpClient instances attached to it
+ * use one DNS cache and one TLS session cache, so a client created for a
+ * single download skips the DNS lookup and resumes the TLS session the
+ * polling client already negotiated instead of a full handshake. Access from
+ * several threads is serialized by per-data mutexes in the share's lock
+ * callbacks. The connection pool is deliberately not shared: libcurl does
+ * not support one connection cache used by concurrent threads, so every
+ * handle keeps reusing its own connections.
+ *
+ * Keep one reference for the lifetime of the program (e.g. in main) so the
+ * caches survive between short-lived clients.
+ *
+ * 한국어:
+ * curl_global_init()/curl_global_cleanup()은 client마다가 아니라 프로세스에서 한 번만
+ * 호출해야 합니다. CurlGlobal은 이 상태를 참조 카운트로 관리하여 첫 acquire()에서
+ * 초기화하고 마지막 참조가 사라질 때 정리합니다. 또한 CURLSH share handle을 가지고 있어,
+ * 여기에 연결된 HttpClient들은 DNS 캐시와 TLS session 캐시를 공유합니다. 다운로드 하나를
+ * 위해 만든 client도 DNS 조회를 생략하고 polling client의 TLS session을 재개하므로 전체
+ * handshake가 줄어듭니다. 여러 스레드의 접근은 lock callback의 데이터별 mutex로
+ * 직렬화됩니다. 연결 풀은 공유하지 않습니다 - libcurl은 여러 스레드가 동시에 쓰는 연결
+ * 캐시를 지원하지 않으므로 연결 재사용은 handle별로 유지됩니다.
+ */
+
+#ifndef CURL_GLOBAL_H
+#define CURL_GLOBAL_H
+
+#include <memory>
+
+/**
+ * @class CurlGlobal
+ * @brief Reference-counted libcurl global state / 참조 카운트 기반 libcurl 전역 상태
+ */
+class CurlGlobal {
+public:
+    /**
+     * @brief Returns the process-wide instance, creating it if needed
+     *
+     * Thread-safe. Throws std::runtime_error if libcurl cannot be initialized.
+     */
+    static std::shared_ptr<CurlGlobal> acquire();
+
+    ~CurlGlobal();
+
+    CurlGlobal(const CurlGlobal&) = delete;
+    CurlGlobal& operator=(const CurlGlobal&) = delete;
+
+    /** @brief CURLSH* for CURLOPT_SHARE (opaque, nullptr if unavailable) */
+    void* share_handle() const { return share_handle_; }
+
+private:
+    CurlGlobal();
+
+    void* share_handle_;
+};
+
+#endif // CURL_GLOBAL_H
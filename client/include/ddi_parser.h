@@ -0,0 +1,154 @@
+/**
+ * @file ddi_parser.h
+ * @brief Zero-copy, allocation-free parser for hawkBit DDI responses
+ *
+ * English:
+ * Single-pass recursive-descent JSON parser that understands the DDI polling
+ * and deploymentBase schema (config, _links, chunks, artifacts, hashes).
+ * All strings are std::string_view slices of the response buffer and all
+ * containers are fixed-capacity arrays, so parsing performs no heap
+ * allocation. Unknown members are skipped structurally, so keys such as
+ * "href" or "size" elsewhere in the document cannot be mistaken for
+ * deployment fields.
+ *
+ * 한국어:
+ * DDI polling 응답과 deploymentBase 스키마(config, _links, chunks, artifacts, hashes)를
+ * 이해하는 단일 패스 재귀 하강 JSON 파서입니다. 모든 문자열은 응답 버퍼를 가리키는
+ * std::string_view이고 컨테이너는 고정 크기 배열이므로 파싱 중 heap 할당이 없습니다.
+ * 모르는 멤버는 구조적으로 건너뛰므로 다른 위치의 "href", "size"를 배포 정보로
+ * 잘못 읽는 일이 없습니다.
+ *
+ * Supported document / 지원하는 문서 구조:
+ * @code
+ * {
+ *   "config": {"polling": {"sleep": "00:05:00"}},
+ *   "_links": {"deploymentBase": {"href": "..."}, "configData": {...}, "cancelAction": {...}},
+ *   "deploymentBase": {
+ *     "id": "12345",
+ *     "deployment": {
+ *       "download": "forced", "update": "forced", "maintenanceWindow": "available",
+ *       "chunks": [{
+ *         "part": "os", "version": "1.0", "name": "firmware",
+ *         "artifacts": [{
+ *           "filename": "firmware.bin", "size": 1048576,
+ *           "hashes": {"sha1": "...", "md5": "...", "sha256": "..."},
+ *           "_links": {"download": {"href": "..."}, "download-http": {"href": "..."},
+ *                      "md5sum": {"href": "..."}, "md5sum-http": {"href": "..."}}
+ *         }]
+ *       }]
+ *     }
+ *   }
+ * }
+ * @endcode
+ * 초기 mock 서버의 "download": {"links": {"<name>": {"href", "size", "hashes"}}} 형식도
+ * artifact로 변환하여 지원합니다.
+ */
+
+#ifndef DDI_PARSER_H
+#define DDI_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/** @brief Artifact digests (raw JSON string contents) / artifact 해시 */
+struct DdiHashes {
+    std::string_view sha1;
+    std::string_view md5;
+    std::string_view sha256;
+};
+
+/**
+ * @struct DdiArtifact
+ * @brief One artifact of a chunk / chunk에 속한 artifact 하나
+ */
+struct DdiArtifact {
+    std::string_view filename;
+    uint64_t size = 0;
+    DdiHashes hashes;
+    std::string_view download_href;         ///< _links.download (HTTPS)
+    std::string_view download_http_href;    ///< _links.download-http (HTTP)
+    std::string_view md5sum_href;           ///< _links.md5sum
+    std::string_view md5sum_http_href;      ///< _links.md5sum-http
+
+    /** @brief Preferred download URL (HTTPS first) / 우선 다운로드 URL */
+    std::string_view href() const {
+        return download_href.empty() ? download_http_href : download_href;
+    }
+};
+
+/**
+ * @struct DdiChunk
+ * @brief Software module of a deployment / 배포에 포함된 software module
+ *
+ * artifacts는 DdiDeploymentView::artifacts 배열의 [first_artifact, first_artifact + artifact_count) 구간입니다.
+ */
+struct DdiChunk {
+    std::string_view part;
+    std::string_view version;
+    std::string_view name;
+    size_t first_artifact = 0;
+    size_t artifact_count = 0;
+};
+
+/**
+ * @struct DdiDeploymentView
+ * @brief Parsed view into a DDI response buffer / 응답 버퍼를 가리키는 파싱 결과
+ *
+ * English:
+ * Valid only while the parsed buffer is alive and unmodified. Designed to be
+ * kept as a member and reused across polls (no per-poll allocation).
+ *
+ * 한국어:
+ * 파싱한 버퍼가 살아 있고 변경되지 않는 동안에만 유효합니다. 멤버로 두고 poll마다
+ * 재사용하도록 설계되었습니다 (poll마다 할당 없음).
+ */
+struct DdiDeploymentView {
+    static const size_t kMaxChunks = 16;
+    static const size_t kMaxArtifacts = 64;
+
+    // Polling resource (root)
+    std::string_view polling_sleep;             ///< config.polling.sleep ("HH:MM:SS")
+    std::string_view deployment_base_href;      ///< _links.deploymentBase.href
+    std::string_view config_data_href;          ///< _links.configData.href
+    std::string_view cancel_action_href;        ///< _links.cancelAction.href
+
+    // deploymentBase
+    std::string_view id;
+    std::string_view download_type;             ///< "skip" | "attempt" | "forced"
+    std::string_view update_type;               ///< "skip" | "attempt" | "forced"
+    std::string_view maintenance_window;        ///< "available" | "unavailable"
+
+    DdiChunk chunks[kMaxChunks];
+    size_t chunk_count = 0;
+    DdiArtifact artifacts[kMaxArtifacts];
+    size_t artifact_count = 0;
+
+    bool truncated = false;         ///< More chunks/artifacts than capacity (extras ignored)
+    bool has_deployment = false;    ///< id present and at least one downloadable artifact
+
+    /** @brief Resets all fields for reuse / 재사용을 위한 초기화 */
+    void clear();
+
+    /** @brief First downloadable artifact or nullptr / 첫 번째 다운로드 가능 artifact */
+    const DdiArtifact* primary_artifact() const;
+};
+
+/**
+ * @brief Parses a DDI polling or deploymentBase response
+ *
+ * @param json response body (must outlive the view)
+ * @param view output, cleared first
+ * @return false on malformed JSON (view contents are then unspecified)
+ */
+bool parse_ddi_response(std::string_view json, DdiDeploymentView& view);
+
+/**
+ * @brief Decodes JSON string escapes into an owned string
+ *
+ * 이스케이프가 없으면 그대로 복사합니다 (일반적인 URL/해시의 fast path).
+ */
+std::string ddi_unescape(std::string_view raw);
+
+#endif // DDI_PARSER_H
@@ -0,0 +1,140 @@
+/**
+ * @file delta_updater.h
+ * @brief casync/zsync-style delta download: only the chunks the device lacks
+ *
+ * English:
+ * For a new artifact the updater fetches its chunk index ("<URL>.cidx", see
+ * chunk_index.h), chunks the currently installed image (the seed: the last
+ * downloaded file or the active slot device) with the same parameters, and
+ * assembles the new image in order into a DownloadSink:
+ * - chunks found in the seed are copied from it,
+ * - chunks found in the local ChunkStore are read from there,
+ * - runs of adjacent missing chunks are fetched with one Range request
+ *   each (up to max_range_size bytes), checked against their digests and
+ *   added to the store.
+ * The assembled stream is verified against the DDI artifact digests like a
+ * full download before the sink is committed. An update that changes a few
+ * MB of a large image therefore transfers little more than those MB plus
+ * the index.
+ *
+ * 한국어:
+ * 새 artifact의 chunk index("<URL>.cidx")를 받고, 현재 설치된 이미지(seed: 마지막으로
+ * 받은 파일 또는 활성 slot 장치)를 같은 방식으로 chunk로 나눈 뒤 새 이미지를 순서대로
+ * 조립하여 DownloadSink에 기록합니다. seed에 있는 chunk는 복사하고, 로컬 chunk 저장소에
+ * 있으면 거기서 읽고, 없는 chunk는 인접한 것끼리 묶어 Range 요청으로 받아 digest를
+ * 확인한 뒤 저장소에 추가합니다. 조립된 결과는 일반 다운로드처럼 DDI 해시로 검증한 뒤에만
+ * sink를 확정합니다. 큰 이미지에서 몇 MB만 바뀌었다면 그 부분과 index만 전송됩니다.
+ *
+ * @dot
+ * digraph DeltaUpdate {
+ *   rankdir=LR;
+ *   node [shape=box, style=filled, fillcolor=lightblue];
+ *   index [label="GET <URL>.cidx"];
+ *   seed [label="installed image\n(chunked locally)"];
+ *   store [label="ChunkStore"];
+ *   range [label="Range: missing chunks"];
+ *   sink [label="DownloadSink\n(+ artifact digests)", fillcolor=lightgreen];
+ *   index -> seed; seed -> sink; store -> sink; range -> sink; range -> store;
+ * }
+ * @enddot
+ */
+
+#ifndef DELTA_UPDATER_H
+#define DELTA_UPDATER_H
+
+#include "artifact_hasher.h"
+#include "chunk_index.h"
+#include "chunk_store.h"
+#include "download_sink.h"
+#include "http_client.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @struct DeltaOptions
+ * @brief Delta update settings / delta 업데이트 설정
+ */
+struct DeltaOptions {
+    bool enabled = false;                       ///< Try "<URL>.cidx" before a full download
+    std::string seed_path;                      ///< Installed image (file or slot device), empty = none
+    uint64_t seed_size = 0;                     ///< Bytes of seed_path to chunk (0 = up to EOF)
+    std::string store_dir;                      ///< ChunkStore directory, empty = none
+    size_t max_range_size = 4 * 1024 * 1024;    ///< Adjacent missing chunks merged per Range request
+};
+
+/**
+ * @struct DeltaStats
+ * @brief Where the bytes of one delta update came from / delta 업데이트 통계
+ */
+struct DeltaStats {
+    uint64_t artifact_bytes = 0;            ///< Size of the new image
+    unsigned long chunks = 0;
+    unsigned long seed_chunks = 0;          ///< Copied from the installed image
+    uint64_t seed_bytes = 0;
+    unsigned long store_chunks = 0;         ///< Read from the chunk store
+    uint64_t store_bytes = 0;
+    unsigned long downloaded_chunks = 0;    ///< Fetched with Range requests
+    uint64_t downloaded_bytes = 0;
+    unsigned long range_requests = 0;
+    uint64_t index_bytes = 0;               ///< Index body bytes as received
+
+    /** @brief Bytes not downloaded compared with a full download (index included) */
+    int64_t saved_bytes() const {
+        return static_cast<int64_t>(artifact_bytes) - static_cast<int64_t>(downloaded_bytes + index_bytes);
+    }
+};
+
+/**
+ * @class DeltaUpdater
+ * @brief Assembles an artifact from local chunks and Range requests
+ *
+ * Uses the given HttpClient (and its kept-alive connection) for the index
+ * and all Range requests; one update at a time.
+ */
+class DeltaUpdater {
+public:
+    DeltaUpdater(HttpClient& client, const DeltaOptions& options);
+
+    /** @brief Index URL of an artifact: ".cidx" appended to the path / index URL */
+    static std::string index_url(const std::string& artifact_url);
+
+    /**
+     * @brief Downloads and parses the chunk index / chunk index 다운로드
+     *
+     * @return false if the server has no index (e.g. 404) or it is invalid;
+     *         the caller then falls back to a full download
+     */
+    bool fetch_index(const std::string& index_url, ChunkIndex& index);
+
+    /**
+     * @brief Builds the artifact into sink / artifact 조립
+     *
+     * @param url artifact URL (Range requests for missing chunks)
+     * @param expected_hashes DDI digests of the whole artifact
+     * @return true if every chunk was obtained, the digests matched and
+     *         sink.finish() succeeded; otherwise the sink is aborted
+     */
+    bool apply(const std::string& url, const ChunkIndex& index, DownloadSink& sink,
+               const ArtifactHashes& expected_hashes);
+
+    /** @brief Counters of the last fetch_index()/apply() / 마지막 업데이트 통계 */
+    const DeltaStats& stats() const { return stats_; }
+
+private:
+    HttpClient& client_;
+    DeltaOptions options_;
+    DeltaStats stats_;
+    HttpResponse response_;         ///< Reused for the index and every Range request
+    std::string chunk_;             ///< Seed/store chunk buffer
+
+    /**
+     * @brief Fetches index.chunks[first, end) with one Range request, checks
+     *        each chunk's digest, stores and writes them
+     */
+    bool fetch_chunks(const std::string& url, const ChunkIndex& index, size_t first, size_t end,
+                      ChunkStore* store, DownloadSink& sink, StreamingHasher& hasher);
+};
+
+#endif // DELTA_UPDATER_H
@@ -0,0 +1,96 @@
+/**
+ * @file download_journal.h
+ * @brief On-disk progress journal for resumable downloads
+ *
+ * English:
+ * Records which byte ranges of a partially downloaded file are known to be
+ * on disk, in a small text file next to the target ("<file>.journal").
+ * After a failed transfer or a process restart only the missing ranges are
+ * requested again with HTTP Range requests.
+ *
+ * 한국어:
+ * 다운로드 중인 파일에서 디스크에 확실히 기록된 byte 구간을 대상 파일 옆의 작은
+ * 텍스트 파일("<파일>.journal")에 기록합니다. 전송이 실패하거나 프로세스가 재시작되어도
+ * 빠진 구간만 HTTP Range 요청으로 다시 받으면 됩니다.
+ *
+ * Journal format / 저널 형식:
+ * @code
+ * hawkbit-download-journal 1
+ * key http://server/files/firmware.bin
+ * size 1048576
+ * range 0 524288
+ * @endcode
+ * 구간은 [begin, end) 반열린 구간이며, 저장은 임시 파일 + rename으로 원자적으로 수행됩니다.
+ */
+
+#ifndef DOWNLOAD_JOURNAL_H
+#define DOWNLOAD_JOURNAL_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class DownloadJournal
+ * @brief Completed byte ranges of one download / 다운로드 완료 구간 기록
+ *
+ * English:
+ * Callers must make the data durable (fdatasync) before recording a range
+ * and calling save(); the journal never claims bytes that could be lost.
+ *
+ * 한국어:
+ * 구간을 기록하고 save()를 호출하기 전에 데이터를 fdatasync로 디스크에 반영해야 합니다.
+ * 그래야 저널이 전원 차단 후 사라질 수 있는 데이터를 완료로 기록하지 않습니다.
+ */
+class DownloadJournal {
+public:
+    /** @brief Half-open byte range [first, second) / 반열린 byte 구간 */
+    typedef std::pair<size_t, size_t> Range;
+
+    /**
+     * @param target_path 다운로드 대상 파일 경로 (저널은 target_path + ".journal")
+     */
+    explicit DownloadJournal(const std::string& target_path);
+
+    /**
+     * @brief Loads an existing journal for the same artifact
+     *
+     * @param key artifact identity (URL or content hash)
+     * @param total_size artifact size in bytes
+     * @return true if a matching journal was found; otherwise the journal
+     *         starts empty for this key/size
+     */
+    bool load(const std::string& key, size_t total_size);
+
+    /** @brief Marks [begin, end) as written and durable / 구간을 완료로 기록 */
+    void add_range(size_t begin, size_t end);
+
+    /** @brief Atomically writes the journal to disk / 저널을 원자적으로 저장 */
+    bool save() const;
+
+    /** @brief Deletes the journal file (download complete) / 저널 파일 삭제 */
+    void remove() const;
+
+    /** @brief Ranges still to be downloaded / 아직 받지 않은 구간 */
+    std::vector<Range> missing_ranges() const;
+
+    /** @brief Ranges recorded as complete / 완료된 구간 */
+    const std::vector<Range>& completed_ranges() const { return completed_; }
+
+    /** @brief Artifact size given to load() / 전체 artifact 크기 */
+    size_t total_size() const { return total_size_; }
+
+    /** @brief Number of bytes recorded as complete / 완료된 byte 수 */
+    size_t completed_bytes() const;
+
+    /** @brief Journal file path / 저널 파일 경로 */
+    const std::string& path() const { return journal_path_; }
+
+private:
+    std::string journal_path_;
+    std::string key_;
+    size_t total_size_;
+    std::vector<Range> completed_;      ///< Sorted, non-overlapping, merged
+};
+
+#endif // DOWNLOAD_JOURNAL_H
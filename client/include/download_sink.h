@@ -0,0 +1,284 @@
+/**
+ * @file download_sink.h
+ * @brief Destinations for streamed artifact bytes (e.g. a RAUC install process)
+ *
+ * English:
+ * A DownloadSink receives the artifact bytes in order while they arrive, so
+ * the firmware never has to be stored in a temporary file first. The sink
+ * may block in write(): the download then stops reading from the socket and
+ * TCP flow control slows the server down (backpressure).
+ *
+ * The download only commits the sink (finish()) after the HTTP status and
+ * every expected digest were verified; on any error it calls abort()
+ * instead, so a corrupted artifact is never confirmed.
+ *
+ * 한국어:
+ * DownloadSink는 artifact 데이터를 도착하는 순서대로 받아 처리하므로 firmware를 임시
+ * 파일에 먼저 저장할 필요가 없습니다. write()가 대기하면 다운로드가 소켓 읽기를 멈추고
+ * TCP 흐름 제어로 서버 전송 속도가 줄어듭니다(backpressure).
+ *
+ * HTTP 상태와 모든 해시가 확인된 뒤에만 finish()를 호출하고, 오류가 있으면 abort()를
+ * 호출하므로 손상된 artifact가 확정되지 않습니다.
+ */
+
+#ifndef DOWNLOAD_SINK_H
+#define DOWNLOAD_SINK_H
+
+#include "compression.h"
+#include "file_writer.h"
+
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @class DownloadSink
+ * @brief Sequential consumer of a download / 다운로드 데이터를 순서대로 받는 대상
+ *
+ * Call order: open() -> write()* -> finish() or abort().
+ * Used from one thread at a time.
+ */
+class DownloadSink {
+public:
+    virtual ~DownloadSink() {}
+
+    /**
+     * @brief Prepares the sink / 출력 준비
+     *
+     * @param expected_size artifact size in bytes (0 = unknown)
+     */
+    virtual bool open(uint64_t expected_size) = 0;
+
+    /**
+     * @brief Consumes the next bytes; may block (backpressure)
+     *
+     * @return false to cancel the download
+     */
+    virtual bool write(const char* data, size_t size) = 0;
+
+    /** @brief All bytes written and verified: commit / 검증 완료 - 확정 */
+    virtual bool finish() = 0;
+
+    /** @brief Download failed or did not verify: discard / 실패 - 폐기 */
+    virtual void abort() = 0;
+
+    /** @brief Short description for logs / 로그용 이름 */
+    virtual std::string describe() const = 0;
+};
+
+/**
+ * @class FileSink
+ * @brief Regular file through a FileWriter / 일반 파일 (FileWriter)
+ *
+ * Preallocates the expected size, writes through a large buffer and syncs
+ * according to options.sync_policy (fdatasync at the end by default).
+ * abort() removes the partial file so no half-written firmware is left.
+ */
+class FileSink : public DownloadSink {
+public:
+    explicit FileSink(const std::string& path, const FileWriteOptions& options = FileWriteOptions());
+
+    bool open(uint64_t expected_size) override { return writer_.open(path_, expected_size); }
+    bool write(const char* data, size_t size) override { return writer_.write(data, size); }
+    bool finish() override { return writer_.finish(); }
+    void abort() override { writer_.abort(); }
+    std::string describe() const override { return "file: " + path_; }
+
+    const FileWriteStats& stats() const { return writer_.stats(); }
+
+private:
+    std::string path_;
+    FileWriter writer_;
+};
+
+/**
+ * @class BlockDeviceSink
+ * @brief Raw partition (e.g. the inactive A/B slot) written with O_DIRECT
+ *
+ * English:
+ * Bypasses the page cache: data is collected in an aligned buffer and
+ * written in large aligned blocks, so a firmware image does not evict the
+ * running system's cache and is not written twice. The unaligned tail is
+ * written after clearing O_DIRECT, and finish() flushes with fdatasync().
+ * open() fails if the image is larger than the device. Falls back to
+ * buffered I/O where O_DIRECT is not supported (e.g. tmpfs image files).
+ *
+ * 한국어:
+ * page cache를 거치지 않고 정렬된 버퍼에 모아 큰 단위로 기록하므로 실행 중인 시스템의
+ * 캐시를 밀어내지 않습니다. 정렬되지 않은 마지막 조각은 O_DIRECT를 끄고 기록하며
+ * finish()에서 fdatasync()로 디스크 반영을 보장합니다. 이미지가 장치보다 크면 open()이
+ * 실패합니다.
+ */
+class BlockDeviceSink : public DownloadSink {
+public:
+    static const size_t kAlignment = 4096;          ///< Covers 512 and 4K logical sectors
+    static const size_t kBufferSize = 1024 * 1024;  ///< Bytes per O_DIRECT write
+
+    explicit BlockDeviceSink(const std::string& device);
+    ~BlockDeviceSink() override;
+
+    BlockDeviceSink(const BlockDeviceSink&) = delete;
+    BlockDeviceSink& operator=(const BlockDeviceSink&) = delete;
+
+    bool open(uint64_t expected_size) override;
+    bool write(const char* data, size_t size) override;
+    bool finish() override;
+    void abort() override;
+    std::string describe() const override { return "block device: " + device_; }
+
+    /** @brief true if writes bypass the page cache / O_DIRECT 사용 여부 */
+    bool direct_io() const { return direct_; }
+
+private:
+    std::string device_;
+    int fd_;
+    bool direct_;
+    char* buffer_;          ///< kAlignment-aligned, kBufferSize bytes
+    size_t buffered_;
+    uint64_t offset_;       ///< Device offset of buffer_[0]
+
+    bool flush_buffer(size_t size);
+};
+
+/**
+ * @class PipeSink
+ * @brief Existing pipe, FIFO or socket descriptor (not owned) / 기존 fd로 출력
+ *
+ * write() blocks while the reader is slow, which throttles the download.
+ * The descriptor is left open by finish() and abort().
+ */
+class PipeSink : public DownloadSink {
+public:
+    explicit PipeSink(int fd) : fd_(fd) {}
+
+    bool open(uint64_t) override { return fd_ >= 0; }
+    bool write(const char* data, size_t size) override;
+    bool finish() override { return true; }
+    void abort() override {}
+    std::string describe() const override { return "fd " + std::to_string(fd_); }
+
+private:
+    int fd_;
+};
+
+/**
+ * @class MemorySink
+ * @brief In-memory buffer, reserved once from the expected size / 메모리 버퍼
+ *
+ * Intended for small artifacts (configs, delta indexes) and tests. Rejects
+ * artifacts above max_size so a wrong size cannot exhaust memory.
+ */
+class MemorySink : public DownloadSink {
+public:
+    explicit MemorySink(size_t max_size = 64 * 1024 * 1024) : max_size_(max_size) {}
+
+    bool open(uint64_t expected_size) override;
+    bool write(const char* data, size_t size) override;
+    bool finish() override { return true; }
+    void abort() override { data_.clear(); }
+    std::string describe() const override { return "memory"; }
+
+    /** @brief Received bytes (valid after finish()) / 받은 데이터 */
+    const std::string& data() const { return data_; }
+
+private:
+    size_t max_size_;
+    std::string data_;
+};
+
+/**
+ * @class ProcessSink
+ * @brief Pipes the artifact into the stdin of an install command
+ *
+ * English:
+ * Runs the command with /bin/sh -c and writes the artifact to its stdin.
+ * finish() closes stdin and succeeds only if the command exits with 0;
+ * abort() terminates the command before it ever sees end-of-input. The command
+ * runs in its own process group and abort() signals the whole group, so the
+ * children of a wrapper script (dd, the installer) never see a clean EOF either.
+ *
+ * RAUC itself needs a seekable bundle, so the command is typically a small
+ * wrapper around the installer, or a raw writer such as
+ * "dd of=/dev/mmcblk0p3 bs=1M" for A/B partition images.
+ *
+ * 한국어:
+ * 명령을 /bin/sh -c로 실행하고 artifact를 stdin으로 전달합니다. finish()는 stdin을
+ * 닫고 종료 코드가 0일 때만 성공하며, abort()는 명령이 입력 끝(EOF)을 보기 전에
+ * 종료시킵니다. 명령은 자체 process group으로 실행되며 abort()는 group 전체를
+ * 종료시킵니다. 파이프가 가득 차면 write()가 대기하여 backpressure가 됩니다.
+ */
+class ProcessSink : public DownloadSink {
+public:
+    explicit ProcessSink(const std::string& command);
+    ~ProcessSink() override;
+
+    ProcessSink(const ProcessSink&) = delete;
+    ProcessSink& operator=(const ProcessSink&) = delete;
+
+    bool open(uint64_t expected_size) override;
+    bool write(const char* data, size_t size) override;
+    bool finish() override;
+    void abort() override;
+    std::string describe() const override { return "process: " + command_; }
+
+    /** @brief Bytes accepted by the command / 명령에 전달한 byte 수 */
+    uint64_t bytes_written() const { return bytes_written_; }
+
+    /** @brief Time spent waiting for the command to drain the pipe / 파이프 대기 시간 */
+    std::chrono::milliseconds blocked_time() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(blocked_);
+    }
+
+private:
+    std::string command_;
+    pid_t pid_;
+    int stdin_fd_;                  ///< Write end of the command's stdin pipe
+    uint64_t bytes_written_;
+    std::chrono::steady_clock::duration blocked_;
+
+    /** @brief Waits for the command and returns its exit status (-1 = abnormal) */
+    int wait_for_exit();
+};
+
+/**
+ * @class DecompressingSink
+ * @brief Expands a .gz/.zst artifact on its way into another sink
+ *
+ * English:
+ * Wraps any sink (file, slot device, install command) and passes it the
+ * decoded image, so a compressed artifact is never stored compressed and
+ * never needs a second decompression pass. The digests checked by the
+ * download apply to the received (compressed) bytes; the decoded stream is
+ * checked by the format itself, and finish() fails - aborting the inner
+ * sink - if the compressed stream was truncated. The decoded size is not
+ * known in advance, so the inner sink is opened with expected_size 0.
+ *
+ * 한국어:
+ * 받은 압축 데이터를 풀어서 안쪽 sink로 넘기므로 압축 파일을 따로 저장하거나 다시 풀
+ * 필요가 없습니다. 다운로드의 해시 검증은 받은 압축 바이트 기준이고, 풀린 데이터는
+ * 포맷의 CRC/checksum으로 확인합니다. 압축 스트림이 중간에 끊겼으면 finish()가 실패하고
+ * 안쪽 sink를 abort()합니다.
+ */
+class DecompressingSink : public DownloadSink {
+public:
+    DecompressingSink(std::unique_ptr<DownloadSink> inner, ContentCoding coding);
+
+    bool open(uint64_t expected_size) override;
+    bool write(const char* data, size_t size) override;
+    bool finish() override;
+    void abort() override { inner_->abort(); }
+    std::string describe() const override;
+
+    uint64_t bytes_in() const { return decoder_.bytes_in(); }     ///< Compressed bytes received
+    uint64_t bytes_out() const { return decoder_.bytes_out(); }   ///< Decoded bytes written
+
+private:
+    std::unique_ptr<DownloadSink> inner_;
+    StreamDecompressor decoder_;
+};
+
+#endif // DOWNLOAD_SINK_H
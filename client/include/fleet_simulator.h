@@ -0,0 +1,179 @@
+/**
+ * @file fleet_simulator.h
+ * @brief Many virtual controllers in one process for server capacity tests
+ *
+ * English:
+ * Runs N virtual controllers (e.g. device000001..device100000) on one shared
+ * AsyncHttpEngine: a single event-loop thread and one bounded connection
+ * pool. Each controller has its own PollScheduler (server interval, jitter,
+ * backoff), ETag and action state machine:
+ *
+ *   IDLE -> POLL -> (new action) DOWNLOAD -> REPORT -> IDLE (immediate re-poll)
+ *                -> (no action / 304)                 -> IDLE (scheduled poll)
+ *
+ * Artifacts are streamed and discarded, so only the network and the server
+ * are measured. The report gives polls/sec, download throughput and
+ * latency percentiles for sizing the backend.
+ *
+ * 한국어:
+ * N개의 가상 컨트롤러를 하나의 AsyncHttpEngine(이벤트 루프 스레드 1개, 크기가 제한된
+ * 연결 풀)에서 실행합니다. 컨트롤러마다 PollScheduler(서버 간격, jitter, 백오프),
+ * ETag, action 상태 머신을 따로 가집니다. artifact는 받아서 버리므로 네트워크와
+ * 서버만 측정됩니다. 결과로 초당 poll 수, 다운로드 처리량, 지연 시간 백분위를
+ * 출력하여 백엔드 용량 산정에 사용합니다.
+ */
+
+#ifndef FLEET_SIMULATOR_H
+#define FLEET_SIMULATOR_H
+
+#include "async_http_engine.h"
+#include "ddi_parser.h"
+#include "poll_scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct FleetOptions
+ * @brief Fleet run configuration / fleet 실행 설정
+ */
+struct FleetOptions {
+    std::string server_url = "http://localhost:8000";
+    size_t controllers = 1000;                          ///< Number of virtual devices
+    std::string id_prefix = "device";                   ///< IDs are prefix + 6-digit index
+    std::chrono::seconds duration = std::chrono::seconds(60);
+    long max_connections = 64;                          ///< Shared connection pool size
+    size_t max_in_flight = 1024;                        ///< Controllers busy at the same time
+    bool download_artifacts = true;                     ///< false: poll and report only
+    bool accept_encoding = true;                        ///< Ask for compressed poll/report responses
+    bool compress_reports = false;                      ///< gzip status report bodies
+};
+
+/**
+ * @struct LatencySummary
+ * @brief Latency percentiles in milliseconds / 지연 시간 백분위 (ms)
+ */
+struct LatencySummary {
+    size_t samples = 0;
+    double p50 = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+
+/**
+ * @struct FleetReport
+ * @brief Aggregate results of a run / 실행 결과 집계
+ */
+struct FleetReport {
+    double elapsed_seconds = 0;
+    size_t controllers = 0;
+    unsigned long polls = 0;
+    unsigned long polls_not_modified = 0;
+    unsigned long poll_failures = 0;
+    unsigned long downloads = 0;
+    unsigned long download_failures = 0;
+    uint64_t download_bytes = 0;
+    unsigned long reports = 0;
+    unsigned long report_failures = 0;
+    LatencySummary poll_latency;        ///< Submit to completion (includes pool queueing)
+    LatencySummary download_latency;
+    LatencySummary report_latency;
+    HttpConnectionStats connections;
+    HttpCompressionStats compression;   ///< Poll/report bytes on the wire vs. decoded
+
+    double polls_per_second() const { return elapsed_seconds > 0 ? polls / elapsed_seconds : 0; }
+    double download_mib_per_second() const {
+        return elapsed_seconds > 0 ? download_bytes / elapsed_seconds / (1024.0 * 1024.0) : 0;
+    }
+};
+
+/** @brief Prints a human-readable report / 결과 출력 */
+void print_fleet_report(const FleetReport& report, std::ostream& out);
+
+/**
+ * @class FleetSimulator
+ * @brief Drives the virtual controllers / 가상 컨트롤러 실행기
+ *
+ * English:
+ * A dispatcher thread (the caller of run()) pops due controllers from a
+ * time-ordered heap and submits their poll. Completions run on the engine's
+ * event-loop thread, advance the state machine and push the controller back
+ * with its next poll time. A controller is therefore only touched by one
+ * thread at a time and needs no lock of its own.
+ *
+ * 한국어:
+ * run()을 호출한 dispatcher 스레드가 시간순 heap에서 poll할 차례인 컨트롤러를 꺼내
+ * 요청을 보냅니다. 완료 callback은 엔진의 이벤트 루프 스레드에서 상태 머신을 진행하고
+ * 다음 poll 시각과 함께 컨트롤러를 heap에 다시 넣습니다. 컨트롤러는 한 번에 한 스레드만
+ * 다루므로 개별 lock이 필요 없습니다.
+ */
+class FleetSimulator {
+public:
+    explicit FleetSimulator(const FleetOptions& options);
+
+    FleetSimulator(const FleetSimulator&) = delete;
+    FleetSimulator& operator=(const FleetSimulator&) = delete;
+
+    /**
+     * @brief Runs the fleet for options.duration and returns the results
+     *
+     * Blocks the calling thread. Initial polls are spread over the first
+     * default polling interval so the fleet does not start as one burst.
+     */
+    FleetReport run();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /** @brief One virtual device / 가상 기기 하나 */
+    struct Controller {
+        std::string id;                     ///< Controller ID (e.g. device000001)
+        std::string poll_url;
+        std::string etag;
+        std::string action_id;              ///< Action being processed
+        std::string completed_action_id;    ///< Last reported action
+        PollScheduler scheduler;
+    };
+
+    /** @brief Heap entry: (next poll time, controller index) */
+    typedef std::pair<Clock::time_point, size_t> Due;
+
+    FleetOptions options_;
+    std::vector<Controller> controllers_;
+
+    std::mutex mutex_;                      ///< Guards due_, in_flight_, report_, *_ms_
+    std::condition_variable changed_;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due_;
+    size_t in_flight_;
+    std::atomic<bool> stopping_;            ///< Duration over: start no new requests
+    std::atomic<uint64_t> downloaded_bytes_;
+
+    DdiDeploymentView view_;                ///< Event-loop thread only
+    FleetReport report_;                    ///< Counters, guarded by mutex_
+    std::vector<float> poll_ms_;            ///< Latency samples, guarded by mutex_
+    std::vector<float> download_ms_;
+    std::vector<float> report_ms_;
+
+    AsyncHttpEngine engine_;                ///< Declared last: destroyed (and drained) first
+
+    void start_poll(size_t index);
+    void on_poll(size_t index, Clock::time_point started, HttpResponse& response);
+    void start_download(size_t index, const std::string& url);
+    void start_report(size_t index, const std::string& status);
+    void finish_cycle(size_t index);
+
+    static LatencySummary summarize(std::vector<float>& samples_ms);
+    static float elapsed_ms(Clock::time_point started);
+};
+
+#endif // FLEET_SIMULATOR_H
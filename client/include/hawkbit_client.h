@@ -27,8 +27,31 @@
 
 // 의존성 포함 - HTTP 통신을 위한 클라이언트
 #include "http_client.h"
-// 표준 라이브러리 - 문자열 처리
+// 비동기 다운로드를 위한 이벤트 루프 엔진
+#include "async_http_engine.h"
+// 대용량 artifact용 병렬 range 다운로더
+#include "segmented_downloader.h"
+// 할당 없는 DDI 응답 파서
+#include "ddi_parser.h"
+// 서버 지정 polling 간격 + 백오프 스케줄러
+#include "poll_scheduler.h"
+// 스트리밍 설치 대상 (파일/블록 장치/파이프/프로세스)
+#include "download_sink.h"
+// 설치된 이미지와 다른 chunk만 받는 delta 업데이트
+#include "delta_updater.h"
+// 같은 artifact를 다시 받지 않는 해시 기반 캐시
+#include "artifact_cache.h"
+// LAN gateway를 통한 artifact 다운로드
+#include "artifact_gateway.h"
+// 다운로드 대역폭 제한 (token bucket, 시간대, 저우선순위)
+#include "rate_limiter.h"
+// 표준 라이브러리 - 문자열 처리, 비동기 결과, sink 생성 함수
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+#include <future>
 
 /**
  * @struct DeploymentInfo
@@ -48,12 +71,20 @@ struct DeploymentInfo {
     std::string id;             ///< 배포 고유 식별자 (deployment ID)
     std::string download_url;   ///< firmware 다운로드 URL
     size_t file_size;          ///< 파일 크기 (bytes 단위)
+    ArtifactHashes hashes;     ///< artifact 해시 (sha256/sha1/md5, 다운로드 중 검증)
     bool has_deployment;       ///< 유효한 배포 정보 여부를 나타내는 flag
+    /// artifact 자체의 압축 형식 (파일 이름이 .gz/.zst이면 받으면서 풀어서 기록)
+    ContentCoding artifact_coding = ContentCoding::kIdentity;
+    /// DDI "download": "forced" - 바로 받아야 하므로 다운로드 시간대/저우선순위 모드를 적용하지 않음
+    bool forced = false;
     
     // 구조체는 기본적으로 모든 멤버가 public이며
     // 자동으로 default constructor, copy constructor, assignment operator가 생성됨
 };
 
+/** @brief 다운로드마다 새 DownloadSink를 만드는 함수 */
+typedef std::function<std::unique_ptr<DownloadSink>()> DownloadSinkFactory;
+
 /**
  * @class HawkbitClient
  * @brief hawkBit DDI 클라이언트의 메인 클래스
@@ -80,6 +111,8 @@ public:
      * 
      * @param server_url hawkBit 서버의 base URL (예: "http://localhost:8000")
      * @param controller_id 이 기기의 고유 식별자 (예: "device001")
+     * @param http_version kHttp2/kHttp2PriorKnowledge이면 poll, 상태 보고, 다운로드를
+     *        서버당 HTTP/2 연결 하나에 stream으로 다중화 (상태 보고/poll은 높은 weight)
      * 
      * 생성자에서 하는 일:
      * - 서버 URL과 controller ID 저장
@@ -91,7 +124,8 @@ public:
      * - 멤버 초기화 리스트 (member initializer list) 사용 권장
      * - explicit 키워드로 암시적 변환 방지 가능
      */
-    HawkbitClient(const std::string& server_url, const std::string& controller_id);
+    HawkbitClient(const std::string& server_url, const std::string& controller_id,
+                  HttpVersion http_version = HttpVersion::kAuto);
     
     /**
      * @brief 서버에 업데이트 polling 요청 수행
@@ -103,11 +137,19 @@ public:
      * 
      * HTTP 엔드포인트: GET /rest/v1/ddi/v1/controller/device/{controller_id}
      * 
+     * 조건부 요청:
+     * - 이전 200 응답의 ETag/Last-Modified를 If-None-Match/If-Modified-Since로 전송
+     * - 서버가 304 Not Modified로 응답하면 body를 받지도 파싱하지도 않고
+     *   마지막 DeploymentInfo를 그대로 반환
+     * 
      * 응답 처리:
-     * 1. HTTP 응답 코드 확인 (200 OK)
+     * 1. HTTP 응답 코드 확인 (200 OK / 304 Not Modified)
      * 2. JSON 응답 body 파싱
      * 3. 배포 정보 추출 및 DeploymentInfo 구조체로 변환
      * 
+     * 응답의 config.polling.sleep은 poll 스케줄러에 적용되고,
+     * 성공/실패 여부는 백오프 계산에 반영됩니다.
+     * 
      * 에러 처리:
      * - 네트워크 오류시 has_deployment = false
      * - JSON 파싱 실패시 has_deployment = false
@@ -131,14 +173,117 @@ public:
      * - HTTP 응답 코드 확인 (200 OK)
      * - 파일 크기 검증 (deployment.file_size와 비교)
      * - 파일 쓰기 권한 확인
+     * - deployment.hashes의 SHA-256/SHA-1/MD5를 수신 중에 계산하여 비교
+     *   (다운로드 후 파일을 다시 읽지 않음)
+     * 
+     * 이어받기 (resume):
+     * - 진행 상황이 "<local_path>.journal"에 기록되므로 실패 후 다시 호출하면
+     *   (프로세스 재시작 후에도) 빠진 구간만 Range 요청으로 받습니다.
      * 
      * 실제 IoT 환경에서 추가할 사항:
-     * - 체크섬 검증 (MD5, SHA256)
-     * - 재시도 로직 (네트워크 불안정 대응)
      * - 진행률 콜백 (progress callback)
      */
     bool download_firmware(const DeploymentInfo& deployment, const std::string& local_path);
     
+    /**
+     * @brief firmware 다운로드를 백그라운드에서 시작
+     * 
+     * @param deployment 다운로드할 배포 정보
+     * @param local_path 저장할 로컬 파일 경로
+     * @return 다운로드 성공 여부를 전달할 std::future
+     * 
+     * AsyncHttpEngine의 이벤트 루프 스레드에서 다운로드가 진행되므로
+     * 호출 스레드는 그동안 polling과 상태 보고를 계속할 수 있습니다.
+     * file_size를 알면 저널 기반 이어받기를 사용하고, 충분히 크면
+     * SegmentedDownloader로 여러 range를 동시에 받습니다.
+     * 
+     * 압축 artifact(.gz/.zst)나 decode_downloads 설정시에는 풀린 데이터의 위치가
+     * 받은 바이트의 offset과 다르므로 range/이어받기 대신 한 스트림으로 받아
+     * 기록 경로에서 바로 풉니다 (start_streaming_install과 같은 경로).
+     */
+    std::future<bool> start_firmware_download(const DeploymentInfo& deployment,
+                                              const std::string& local_path);
+    
+    /**
+     * @brief firmware를 임시 파일 없이 바로 기록할 대상 설정
+     * 
+     * @param factory 다운로드마다 새 DownloadSink를 만드는 함수 (빈 함수 = 파일로 저장, 기본값)
+     * 
+     * 설정하면 start_firmware_download()는 local_path에 저장하지 않고 받은 데이터를
+     * sink로 흘려보냅니다. 예:
+     * - BlockDeviceSink("/dev/mmcblk0p3"): 비활성 A/B slot에 O_DIRECT로 직접 기록
+     * - ProcessSink("..."): 설치 명령의 stdin으로 전달
+     * flash 쓰기가 절반으로 줄고 bundle 크기만큼의 여유 공간이 필요 없습니다. sink가
+     * 느리면 다운로드도 같이 느려집니다 (backpressure). 해시가 맞고 sink의 finish()가
+     * 성공해야 성공입니다.
+     */
+    void set_download_sink_factory(const DownloadSinkFactory& factory) { sink_factory_ = factory; }
+    
+    /**
+     * @brief poll 응답과 상태 보고 body의 압축 설정
+     * 
+     * 기본값은 Accept-Encoding으로 압축된 poll 응답을 받는 것만 켜져 있습니다.
+     * compress_requests를 켜면 상태 보고 POST body를 gzip으로 보냅니다 (서버가
+     * "Content-Encoding: gzip" 요청을 지원해야 함). decode_downloads를 켜면 firmware
+     * 다운로드도 압축 전송을 받아 풀면서 기록하고 해시는 풀린 데이터로 검증합니다.
+     * 절감량은 polling loop의 로그에 출력됩니다.
+     */
+    void set_compression_options(const HttpCompressionOptions& options);
+    
+    /**
+     * @brief 파일로 받는 다운로드의 기록 설정 (기본값: fallocate + 끝에서 fdatasync)
+     * 
+     * 스트리밍/delta/캐시 설치 경로의 FileSink에는 그대로 적용됩니다 (io_uring 포함). 병렬 range
+     * 다운로드는 segment마다 offset에 기록하므로 preallocate와 SyncPolicy::kNone(마지막 fdatasync
+     * 생략)만 따르고, 이어받기 저널 checkpoint는 항상 sync합니다.
+     */
+    void set_file_write_options(const FileWriteOptions& options);
+    
+    /**
+     * @brief delta 업데이트 설정 (casync/zsync 방식)
+     * 
+     * 켜면 다운로드 전에 artifact URL + ".cidx"의 chunk index를 받아, 설치된 이미지
+     * (options.seed_path, 비어 있으면 파일 다운로드의 local_path = 이전에 받은 이미지)와
+     * chunk 저장소에 없는 chunk만 Range 요청으로 받습니다. 서버에 index가 없으면 전체
+     * 다운로드로 진행합니다. 파일로 받을 때는 "<local_path>.delta"에 조립한 뒤 검증이
+     * 끝나면 local_path로 rename합니다 (seed를 읽는 동안 덮어쓰지 않음).
+     */
+    void set_delta_options(const DeltaOptions& options) { delta_ = options; }
+    
+    /**
+     * @brief 다운로드한 artifact를 보관할 캐시 설정 (nullptr = 사용 안 함, 기본값)
+     * 
+     * @param cache open()된 캐시 (gateway에서는 여러 controller가 같은 캐시를 공유)
+     * 
+     * 배포된 artifact의 해시가 캐시에 있으면 다운로드하지 않고 캐시에서 local_path나
+     * sink로 복사합니다 (복사하면서 해시 재검증, 손상되었으면 다운로드). 없으면 받으면서
+     * 캐시에도 기록하고 검증이 끝나면 추가합니다. hit/miss와 절약한 바이트는 polling
+     * loop의 로그에 출력됩니다.
+     */
+    void set_artifact_cache(const std::shared_ptr<ArtifactCache>& cache) { cache_ = cache; }
+    
+    /**
+     * @brief artifact를 LAN gateway(ArtifactGateway)를 통해 받도록 설정 (빈 문자열 = 직접, 기본값)
+     * 
+     * @param gateway_url 예: "http://192.168.1.10:8080"
+     * 
+     * poll과 상태 보고는 그대로 서버로 보내고, 다운로드 URL만 gateway URL로 바꿉니다.
+     * gateway는 artifact를 서버에서 한 번만 받아 모든 형제 기기에 전달합니다. Range를
+     * 지원하므로 병렬 range/이어받기는 그대로 동작하고, delta 업데이트는 사용하지 않습니다
+     * (LAN에서는 전송량보다 uplink 한 번이 중요). 해시가 없는 artifact는 직접 받습니다.
+     */
+    void set_gateway_url(const std::string& gateway_url) { gateway_url_ = gateway_url; }
+    
+    /**
+     * @brief 다운로드 대역폭 제한 설정 (기본값: 제한 없음)
+     * 
+     * 배포마다 RateLimiter 하나를 만들어 그 배포의 모든 전송(병렬 range, 스트리밍, delta
+     * range)이 나눠 씁니다. 속도 0인 시간대에는 새 배포의 다운로드를 시작하지 않고 다음
+     * poll에서 다시 확인합니다. "forced" 배포에는 max_rate 상한만 적용합니다.
+     * 실제 속도와 제한 값은 polling loop의 로그에 출력됩니다 ("Download rate: ...").
+     */
+    void set_rate_limit(const RateLimitOptions& options) { rate_limit_ = options; }
+    
     /**
      * @brief 배포 결과를 서버에 보고
      * 
@@ -173,10 +318,12 @@ public:
      * 
      * 루프 동작 순서:
      * 1. 서버에 업데이트 polling (poll_for_updates)
-     * 2. 업데이트가 있으면 firmware 다운로드 (download_firmware)
-     * 3. 설치 과정 시뮬레이션 (실제로는 파일 검증만)
-     * 4. 결과를 서버에 보고 (report_status)
-     * 5. 일정 시간 대기 후 1번부터 반복
+     * 2. 업데이트가 있으면 백그라운드 다운로드 시작 (start_firmware_download)
+     *    후 RUNNING 상태 보고
+     * 3. 다운로드가 진행되는 동안에도 polling은 계속됨
+     * 4. 다운로드 완료시 결과를 서버에 보고 (report_status) 후 즉시 재poll
+     * 5. 서버가 지정한 간격(config.polling.sleep + jitter) 대기 후 1번부터 반복
+     *    (poll 실패시에는 jitter가 있는 지수 백오프)
      * 
      * 이 패턴은 실제 IoT 기기에서 사용되는 일반적인 방식입니다:
      * - Pull 방식: 기기가 능동적으로 업데이트 확인
@@ -184,7 +331,6 @@ public:
      * - 장애 복구: 네트워크 문제 발생시 자동 재시도
      * 
      * 프로덕션 환경에서는 추가 고려사항:
-     * - 지수 백오프 (exponential backoff) 재시도
      * - 배터리 상태에 따른 업데이트 일정 조절
      * - 사용자 정의 maintenance window
      */
@@ -215,12 +361,87 @@ private:
      * @brief HTTP 통신을 담당하는 클라이언트 객체
      * 
      * Composition 패턴으로 HttpClient를 포함합니다.
+     * 연결 유지 모드로 생성되어 poll → download → report 사이클 동안
+     * 같은 TCP/TLS 연결을 재사용합니다.
      * 이는 상속보다 더 유연한 설계를 제공합니다:
      * - 테스트 시 mock 객체로 교체 가능
      * - HttpClient 구현 변경이 HawkbitClient에 영향 없음
      */
     HttpClient http_client_;
     
+    /**
+     * @brief 백그라운드 firmware 다운로드용 비동기 HTTP 엔진
+     * 
+     * 다운로드가 진행되는 동안 http_client_로 polling/상태 보고를 계속합니다.
+     * HTTP/2 모드에서는 polling/상태 보고도 이 엔진으로 보내 다운로드와 같은 연결을 씁니다.
+     */
+    AsyncHttpEngine engine_;
+    
+    /** @brief 이어받기/병렬 range 다운로더 (engine_ 사용) */
+    SegmentedDownloader segmented_downloader_;
+    
+    /** @brief 스트리밍 설치 대상 생성 함수 (비어 있으면 파일로 다운로드) */
+    DownloadSinkFactory sink_factory_;
+    
+    /** @brief 진행 중인 다운로드 결과 (없으면 valid() == false) */
+    std::future<bool> pending_download_;
+    
+    /** @brief 진행 중인 다운로드의 배포 ID */
+    std::string pending_deployment_id_;
+    
+    /** @brief 마지막으로 결과를 보고한 배포 ID (같은 action을 다시 실행하지 않음) */
+    std::string completed_deployment_id_;
+    
+    /**
+     * @brief poll마다 재사용하는 응답 객체 (HttpClient::get_into)
+     *
+     * body buffer 용량이 poll 사이에 유지되어, 응답 크기가 비슷한 동안은 poll마다
+     * body를 새로 할당하지 않습니다. ddi_view_가 이 body를 가리킵니다.
+     */
+    HttpResponse poll_response_;
+    
+    /** @brief poll마다 재사용하는 DDI 파싱 결과 (응답 버퍼를 가리키는 view) */
+    DdiDeploymentView ddi_view_;
+    
+    /** @brief 다음 poll 시점 결정 (config.polling.sleep, jitter, 실패 백오프) */
+    PollScheduler poll_scheduler_;
+    
+    /** @brief 마지막 200 poll 응답의 ETag (If-None-Match로 전송) */
+    std::string poll_etag_;
+    
+    /** @brief 마지막 200 poll 응답의 Last-Modified (If-Modified-Since로 전송) */
+    std::string poll_last_modified_;
+    
+    /** @brief 마지막으로 파싱한 poll 결과 (304 응답시 재사용) */
+    DeploymentInfo cached_deployment_;
+    
+    /** @brief cached_deployment_와 검증자가 유효한지 여부 */
+    bool has_cached_poll_;
+    
+    /** @brief 304 Not Modified로 끝난 poll 수 */
+    unsigned long not_modified_polls_;
+    
+    /** @brief poll/상태 보고 압축 설정 (HTTP/2 모드에서 AsyncRequest에 적용) */
+    HttpCompressionOptions compression_;
+    
+    /** @brief delta 업데이트 설정 (enabled가 false면 항상 전체 다운로드) */
+    DeltaOptions delta_;
+    
+    /** @brief artifact 캐시 (다운로드 스레드와 공유하므로 shared_ptr, 없으면 nullptr) */
+    std::shared_ptr<ArtifactCache> cache_;
+    
+    /** @brief artifact를 받을 LAN gateway (비어 있으면 서버에서 직접) */
+    std::string gateway_url_;
+    
+    /** @brief 다운로드 대역폭 제한 설정 */
+    RateLimitOptions rate_limit_;
+    
+    /** @brief 파일 다운로드 기록 설정 (FileSink, 병렬 range) */
+    FileWriteOptions file_options_;
+    
+    /** @brief 진행 중인(또는 마지막) 배포의 limiter - 다운로드 스레드와 공유, 제한이 없으면 nullptr */
+    std::shared_ptr<RateLimiter> download_limiter_;
+    
     /**
      * @brief polling URL을 생성하는 헬퍼 메서드
      * 
@@ -250,29 +471,84 @@ private:
      */
     std::string build_status_url(const std::string& deployment_id);
     
+    /**
+     * @brief URL에서 받는 다운로드 시작 (캐시/gateway 처리 후의 start_firmware_download)
+     * 
+     * @param try_delta chunk index를 먼저 시도할지 (gateway를 통할 때는 false)
+     */
+    std::future<bool> start_direct_download(const DeploymentInfo& deployment, const std::string& local_path,
+                                            bool try_delta);
+    
+    /**
+     * @brief sink로 스트리밍하는 다운로드를 별도 스레드에서 시작
+     * 
+     * @param sink 기록 대상 (압축 artifact면 DecompressingSink로 감싸서 사용)
+     * @return 다운로드, 해시 검증, sink 확정이 모두 성공했는지 전달할 future
+     */
+    std::future<bool> start_streaming_install(const DeploymentInfo& deployment,
+                                              std::unique_ptr<DownloadSink> sink);
+    
+    /**
+     * @brief delta 업데이트를 별도 스레드에서 시작 (index가 없으면 같은 sink로 전체 다운로드)
+     * 
+     * @param local_path 파일 다운로드 대상 (sink_factory_가 있으면 사용하지 않음)
+     */
+    std::future<bool> start_delta_download(const DeploymentInfo& deployment, const std::string& local_path);
+    
+    /**
+     * @brief 캐시된 artifact를 별도 스레드에서 local_path/sink로 복사
+     * 
+     * 압축 artifact는 받은 그대로(압축된 채) 캐시되므로 풀면서 기록합니다. 캐시 항목이
+     * 손상되었으면(해시 불일치) 새 sink로 한 스트림 다운로드합니다.
+     */
+    std::future<bool> start_cached_install(const DeploymentInfo& deployment, const std::string& local_path);
+    
+    /** @brief 다운로드 스레드가 누적하는 압축 통계 (스레드가 client보다 오래 살 수 있어 shared_ptr) */
+    struct DownloadStats {
+        std::mutex mutex;
+        HttpCompressionStats compression;
+    };
+    std::shared_ptr<DownloadStats> download_stats_;
+    
+    /** @brief HTTP/2 모드 여부 (poll/상태 보고도 engine_으로 전송) */
+    bool multiplexed() const { return engine_.http_version() != HttpVersion::kAuto; }
+    
+    /**
+     * @brief poll/상태 보고를 engine_으로 전송하고 응답까지 대기
+     * 
+     * 높은 stream weight로 보내 진행 중인 다운로드와 같은 HTTP/2 연결을 나눠 쓰면서도
+     * 다운로드 데이터 뒤에 밀리지 않습니다.
+     */
+    HttpResponse send_multiplexed(AsyncRequest request);
+    
     /**
      * @brief JSON 응답을 파싱하여 배포 정보 추출
      * 
      * @param json_response 서버로부터 받은 JSON 문자열
      * @return 파싱된 DeploymentInfo 구조체
      * 
-     * 간단한 JSON 파싱 로직을 구현합니다. 프로덕션 환경에서는
-     * rapidjson, nlohmann/json 같은 전문 라이브러리 사용을 권장합니다.
+     * parse_ddi_response()로 DDI 스키마를 한 번에 파싱한 뒤(할당 없음),
+     * 첫 번째 다운로드 가능한 artifact의 id/URL/크기/해시만 복사합니다.
      * 
-     * 파싱할 JSON 구조:
+     * 파싱할 JSON 구조 (DDI deploymentBase):
      * {
      *   "deploymentBase": {
      *     "id": "12345",
-     *     "download": {
-     *       "links": {
-     *         "firmware": {
-     *           "href": "http://server/files/firmware.bin",
-     *           "size": 1048576
-     *         }
-     *       }
+     *     "deployment": {
+     *       "download": "forced", "update": "forced",
+     *       "chunks": [{
+     *         "part": "os", "version": "1.0.0", "name": "firmware",
+     *         "artifacts": [{
+     *           "filename": "firmware.bin",
+     *           "size": 1048576,
+     *           "hashes": {"sha1": "...", "md5": "...", "sha256": "..."},
+     *           "_links": {"download-http": {"href": "http://server/files/firmware.bin"}}
+     *         }]
+     *       }]
      *     }
      *   }
      * }
+     * 초기 형식("download": {"links": {...}})도 계속 지원합니다.
      * 
      * 에러 처리:
      * - JSON 형식 오류시 has_deployment = false 반환
@@ -20,10 +20,10 @@
  *
  *   "HttpClient" -> "libcurl" [label="uses"];
  *   "HttpClient" -> "std::string" [label="contains"];
- *   "HttpClient" -> "std::map" [label="contains"];
  *   "HttpResponse" -> "std::string" [label="contains"];
- *   "HttpResponse" -> "std::map" [label="contains"];
+ *   "HttpResponse" -> "HttpHeaders" [label="contains"];
  *   "HawkbitClient" -> "HttpClient" [label="composition"];
+ *   "AsyncHttpEngine" -> "HttpResponse" [label="produces"];
  * }
  * @enddot
  *
@@ -31,12 +31,13 @@
  * - RAII (Resource Acquisition Is Initialization)
  * - Modern C++ class design (constructor/destructor)
  * - Static callbacks for C library integration
- * - STL containers (std::string, std::map)
+ * - STL containers (std::string, std::vector) and std::string_view
  * - Default parameter values
  * - Opaque pointer (pimpl) for implementation hiding
  *
  * HTTP Client Design / HTTP 클라이언트 설계:
  * - Synchronous (blocking) operations
+ * - Persistent (keep-alive) connections with reuse counters
  * - Automatic memory management
  * - Header parsing/management
  * - Large-file streaming download
@@ -47,18 +48,29 @@
 #define HTTP_CLIENT_H
 
 // Standard library includes - modern C++ containers and types
+#include <cstdint>   // uint64_t - artifact sizes
 #include <string>    // std::string - modern C++ string class (better than char*)
-#include <map>       // std::map - associative container for key-value pairs
+#include <string_view> // std::string_view - header lookups without copies
+#include <vector>    // std::vector - extra request headers
+
+#include "artifact_hasher.h"   // ArtifactHashes - streaming download verification
+#include "compression.h"       // HttpCompressionOptions - Accept-Encoding / gzip POST bodies
+#include "curl_global.h"       // CurlGlobal - refcounted curl init + shared caches
+#include "file_writer.h"       // FileWriteOptions - download_file() write backend
+#include "http_headers.h"      // HttpHeaders - flat response header storage
+#include "rate_limiter.h"      // RateLimiter - download bandwidth cap
+
+class DownloadSink;            // download_sink.h - streaming install destination
 
 /**
  * @struct HttpResponse
  * @brief Container for HTTP response data / HTTP 응답 컨테이너
  *
  * English:
- * Holds status code, body, and headers using STL containers.
+ * Holds status code, body, and headers (flat HttpHeaders arena).
  *
  * 한국어:
- * HTTP 상태 코드, 본문, 헤더를 STL 컨테이너로 보관합니다.
+ * HTTP 상태 코드, 본문, 헤더(HttpHeaders arena)를 보관합니다.
  *
  * Modern C++ features / 현대 C++ 특징:
  * - Aggregate initialization
@@ -67,12 +79,49 @@
 struct HttpResponse {
     long status_code;                               // HTTP status code (200, 404, 500, etc.)
     std::string body;                               // Response body content as string
-    std::map<std::string, std::string> headers;     // HTTP headers as key-value pairs
+    HttpHeaders headers;                            // HTTP headers of the final response
+    
+    /**
+     * @brief Case-insensitive header lookup / 대소문자 구분 없는 header 조회
+     *
+     * HTTP header 이름은 대소문자를 구분하지 않으므로 서버마다 "ETag"/"etag"처럼
+     * 다르게 올 수 있습니다. 없으면 빈 view를 반환하며, view는 headers가 바뀔 때까지
+     * 유효합니다. 자주 쓰는 header는 headers.get(HttpHeaders::kETag)로 바로 찾습니다.
+     */
+    std::string_view header(std::string_view name) const { return headers.get(name); }
+    
+    /**
+     * @brief Resets for reuse / 재사용을 위해 초기화
+     *
+     * body.clear() keeps the capacity, so a response object passed to
+     * HttpClient::get_into() again needs no new body allocation as long as
+     * the next body fits. body 용량은 유지됩니다.
+     */
+    void clear();
     
     // Note: This struct uses default copy/move semantics
     // C++11 and later provide efficient move operations automatically
 };
 
+/**
+ * @struct HttpConnectionStats
+ * @brief Connection reuse counters / 연결 재사용 통계
+ *
+ * English:
+ * Counts how many transfers could reuse a cached TCP/TLS connection and how
+ * many had to perform a fresh handshake (CURLINFO_NUM_CONNECTS).
+ *
+ * 한국어:
+ * 전송마다 캐시된 TCP/TLS 연결을 재사용했는지, 새 handshake가 필요했는지를
+ * 집계합니다. 셀룰러 환경에서는 handshake가 polling 지연의 대부분을 차지합니다.
+ */
+struct HttpConnectionStats {
+    unsigned long requests = 0;             // Completed transfers
+    unsigned long new_connections = 0;      // Transfers that opened a new connection
+    unsigned long reused_connections = 0;   // Transfers served over a cached connection
+    unsigned long http2_requests = 0;       // Transfers that used HTTP/2
+};
+
 /**
  * @class HttpClient
  * @brief Modern C++ HTTP client using RAII principles
@@ -115,15 +164,23 @@ public:
      * 
      * Exception Safety: Strong guarantee - if construction fails,
      * no resources are leaked
+     *
+     * @param persistent_connections true (default): keep TCP/TLS connections,
+     *        DNS cache and static options alive across requests.
+     *        false: open a fresh connection for every request.
+     * @param shared_caches true (default): in persistent mode, use the
+     *        process-wide DNS cache and TLS session cache of CurlGlobal,
+     *        shared with every other HttpClient. Connections stay per client.
+     *        false: this client keeps private caches.
      */
-    HttpClient();
+    explicit HttpClient(bool persistent_connections = true, bool shared_caches = true);
     
     /**
      * @brief Destructor - Cleans up curl resources
      * 
      * RAII Pattern: Destructor releases all acquired resources
      * - Cleans up curl easy handle if valid
-     * - Calls curl_global_cleanup() for library cleanup
+     * - Releases its CurlGlobal reference (the last one cleans up libcurl)
      * - Ensures no memory leaks regardless of how object is destroyed
      * 
      * Modern C++ Note: Destructor is automatically called when:
@@ -137,8 +194,12 @@ public:
      * @brief Performs HTTP GET request
      * 
      * @param url The URL to request (must be valid HTTP/HTTPS URL)
+     * @param extra_headers Additional request headers, e.g. "If-None-Match: \"abc\""
      * @return HttpResponse containing status, body, and headers
      * 
+     * Conditional requests: with If-None-Match / If-Modified-Since the server
+     * may answer 304 Not Modified with an empty body.
+     * 
      * Modern C++ Features:
      * - const std::string& parameter (no unnecessary copying)
      * - Return by value (RVO/move semantics optimize this)
@@ -147,7 +208,36 @@ public:
      * HTTP Method: GET is idempotent and safe for polling operations
      * Used by devices to check for available updates
      */
-    HttpResponse get(const std::string& url);
+    HttpResponse get(const std::string& url,
+                     const std::vector<std::string>& extra_headers = std::vector<std::string>());
+    
+    /**
+     * @brief GET into a caller-owned response / 호출자 소유 응답 객체로 GET
+     * 
+     * @param url The URL to request
+     * @param response Cleared with HttpResponse::clear() and filled in place
+     * @param extra_headers Additional request headers (see get())
+     * 
+     * Reusable Buffer: a poll loop that keeps one HttpResponse alive reuses
+     * its body storage, so once the buffer has grown to the usual response
+     * size, polling does not allocate a new body. get() is this with a
+     * fresh HttpResponse.
+     */
+    void get_into(const std::string& url, HttpResponse& response,
+                  const std::vector<std::string>& extra_headers = std::vector<std::string>());
+    
+    /**
+     * @brief GET of one byte range into a caller-owned response / byte range GET
+     * 
+     * @param first Offset of the first byte
+     * @param last Offset of the last byte (inclusive, as in "Range: bytes=first-last")
+     * 
+     * Used for delta updates, which fetch only the missing chunks of an
+     * artifact. No Accept-Encoding (offsets refer to the artifact bytes) and
+     * no overall timeout, like download_to_sink(); the caller checks for
+     * 206 Partial Content and the body length.
+     */
+    void get_range_into(const std::string& url, uint64_t first, uint64_t last, HttpResponse& response);
     
     /**
      * @brief Performs HTTP POST request with data
@@ -174,7 +264,10 @@ public:
      * 
      * @param url Source URL of the file to download
      * @param filepath Local path where file should be saved
-     * @return true if download succeeded, false otherwise
+     * @param expected_hashes Digests to verify while the bytes stream in
+     *        (empty = no verification)
+     * @param expected_size Artifact size to preallocate (0 = unknown)
+     * @return true if download succeeded (and all expected digests match)
      * 
      * Streaming Design: File is written directly to disk without
      * loading entire content into memory. This is crucial for:
@@ -182,10 +275,85 @@ public:
      * - Memory-constrained IoT devices
      * - Network interruption recovery
      * 
+     * Streaming Verification: digests are updated inside WriteSinkCallback,
+     * so no second pass over the file is needed after the download.
+     * 
+     * Implemented as download_to_sink() with a FileSink; a failed or
+     * mismatching download removes the partial file. The file is written
+     * with the options from set_file_write_options() (pwrite by default,
+     * io_uring on request).
+     * 
      * Boolean Return: Simple success/failure indication
      * More complex error handling could use std::optional or exceptions
      */
-    bool download_file(const std::string& url, const std::string& filepath);
+    bool download_file(const std::string& url, const std::string& filepath,
+                       const ArtifactHashes& expected_hashes = ArtifactHashes(),
+                       uint64_t expected_size = 0);
+    
+    /**
+     * @brief Streams a download into a sink instead of a file
+     * 
+     * @param url Source URL of the artifact
+     * @param sink Destination (e.g. ProcessSink running the RAUC installer)
+     * @param expected_hashes Digests to verify while the bytes stream in
+     * @param expected_size Artifact size passed to sink.open() (0 = unknown)
+     * @return true if the transfer, the digests and sink.finish() all succeeded
+     * 
+     * No temporary file: each chunk goes from curl's buffer to the sink.
+     * A sink that blocks in write() pauses the transfer (backpressure).
+     * sink.finish() is only called after the digests matched; otherwise
+     * sink.abort() discards what the sink received so far.
+     * 
+     * With compression options decode_downloads, the request sends
+     * Accept-Encoding and a "Content-Encoding: gzip" response is decoded
+     * before it reaches the hasher and the sink, so the digests are those
+     * of the original artifact. The transfer is counted in
+     * compression_stats() (download_* fields) either way.
+     */
+    bool download_to_sink(const std::string& url, DownloadSink& sink,
+                          const ArtifactHashes& expected_hashes = ArtifactHashes(),
+                          uint64_t expected_size = 0);
+
+    /**
+     * @brief Sets how download_file() writes to disk / 파일 기록 방식 설정
+     *
+     * e.g. options.io_uring = true for a gateway that caches many large
+     * artifacts: buffer writes are submitted asynchronously and the receive
+     * path only copies. Falls back to pwrite() where io_uring is unavailable.
+     */
+    void set_file_write_options(const FileWriteOptions& options) { file_options_ = options; }
+
+    /**
+     * @brief Throttles downloads to a shared bandwidth limit / 다운로드 대역폭 제한
+     *
+     * download_to_sink(), download_file() and get_range_into() take their
+     * received bytes from the limiter and sleep in the write callback while
+     * it is in debt; curl stops reading the socket meanwhile, so the sender
+     * slows down to the cap. nullptr (default) = full speed. API requests
+     * (get()/post()) are never throttled.
+     */
+    void set_rate_limiter(const std::shared_ptr<RateLimiter>& limiter) { rate_limiter_ = limiter; }
+
+    /**
+     * @brief Sets content coding for get()/post() / API 요청 압축 설정
+     *
+     * By default get() and post() send Accept-Encoding and libcurl decodes
+     * the response while it streams in. With compress_requests, post()
+     * bodies of at least min_request_size bytes are sent gzip-compressed
+     * (only if that makes them smaller). download_to_sink() negotiates a
+     * coding only with decode_downloads; download_file() is the same call.
+     */
+    void set_compression_options(const HttpCompressionOptions& options) { compression_ = options; }
+
+    /** @brief Wire vs. decoded byte counters of get()/post()/downloads / 압축 절감 통계 */
+    const HttpCompressionStats& compression_stats() const { return compression_stats_; }
+
+    /**
+     * @brief Returns connection reuse counters / 연결 재사용 통계 반환
+     *
+     * Used by HawkbitClient to report reuse vs. new handshakes per cycle.
+     */
+    const HttpConnectionStats& connection_stats() const { return stats_; }
 
 private:
     /**
@@ -200,6 +368,71 @@ private:
      * This is a common pattern when wrapping C libraries in C++
      */
     void* curl_handle;
+
+    /**
+     * @brief Connection-persistent mode flag / 연결 유지 모드 여부
+     *
+     * true이면 curl_easy_reset()을 호출하지 않고 요청별 옵션만 교체하여
+     * 연결 캐시, DNS 캐시, 정적 옵션을 poll → download → report 사이클 동안 유지합니다.
+     */
+    bool persistent_;
+
+    /**
+     * @brief Process-wide libcurl state / 프로세스 전역 libcurl 상태
+     *
+     * curl_global_init()은 첫 참조에서 한 번만 실행됩니다. shared_caches이면
+     * 이 share handle로 DNS/TLS session 캐시를 다른 HttpClient와 공유합니다 (연결은 client별).
+     */
+    std::shared_ptr<CurlGlobal> curl_global_;
+    bool shared_caches_;
+
+    /** @brief Connection reuse counters / 연결 재사용 통계 */
+    HttpConnectionStats stats_;
+
+    /** @brief download_file() write options / 파일 기록 설정 */
+    FileWriteOptions file_options_;
+
+    /** @brief Download bandwidth limit (nullptr = unlimited) / 다운로드 속도 제한 */
+    std::shared_ptr<RateLimiter> rate_limiter_;
+
+    /**
+     * @brief Socket of the last connection this handle opened, -1 = none
+     *
+     * Recorded by track_sockets() for low-priority RTT samples (see
+     * sample_rtt()).
+     */
+    int socket_;
+
+    /** @brief get()/post() content coding settings and counters / 압축 설정과 통계 */
+    HttpCompressionOptions compression_;
+    HttpCompressionStats compression_stats_;
+
+    /**
+     * @brief Applies options that stay the same for every request
+     *
+     * Redirects, timeouts, TCP keep-alive, DNS cache lifetime and the header
+     * callback. Called once in persistent mode, after every reset otherwise.
+     */
+    void apply_static_options();
+
+    /**
+     * @brief Prepares the handle for a new request
+     *
+     * Persistent mode only swaps per-request options (URL, method, headers);
+     * otherwise the handle is reset and connection reuse is forbidden.
+     */
+    void prepare_request(const std::string& url);
+
+    /**
+     * @brief Performs the prepared request and updates connection_stats()
+     */
+    int perform_request();
+
+    /**
+     * @brief Adds the finished response's wire and decoded body sizes to
+     *        compression_stats()
+     */
+    void record_response_size(const HttpResponse& response);
     
     /**
      * @brief Static callback for writing response body data
@@ -210,41 +443,76 @@ private:
      * @param contents Data buffer from curl
      * @param size Size of each data element
      * @param nmemb Number of data elements
-     * @param userp User pointer (cast to std::string* for response body)
+     * @param userp User pointer (body string + curl handle, see BodyWriteContext)
      * @return Number of bytes processed (must equal size * nmemb)
      * 
      * Callback Pattern: Common in C libraries for handling data streams
      * The userp parameter allows passing context (our std::string)
+     * 
+     * Pre-sizing: the first call reserves Content-Length bytes (see
+     * reserve_body()), so the body grows in one allocation instead of
+     * doubling repeatedly while a large poll response streams in.
      */
     static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
     
+    /**
+     * @brief Reserves the announced Content-Length in body / Content-Length만큼 body 예약
+     * 
+     * Called before the first body bytes are appended, when the headers are
+     * complete. Unknown lengths (chunked) and lengths above a sanity cap are
+     * ignored; a buffer that is already large enough is left alone.
+     */
+    static void reserve_body(void* handle, std::string& body);
+    
+    /**
+     * @brief Records the socket of each connection the handle opens / 연결 소켓 기록
+     * 
+     * Installs CURLOPT_OPENSOCKETFUNCTION (writes the new socket to *socket)
+     * and CURLOPT_CLOSESOCKETFUNCTION. Connections can outlive the transfer in
+     * a multi handle's pool, so closing only drops the socket from a
+     * process-wide set of open curl sockets instead of touching *socket.
+     */
+    static void track_sockets(void* handle, int* socket);
+    
+    /**
+     * @brief Feeds the transfer's TCP RTT to a low-priority limiter when due
+     * 
+     * Samples socket only when RateLimiter::wants_rtt_sample() asks for it,
+     * the socket is still open in libcurl and its local port is the one of
+     * the handle's current connection; a closed, reused or foreign fd is
+     * never sampled.
+     */
+    static void sample_rtt(void* handle, int socket, RateLimiter& limiter);
+    
     /**
      * @brief Static callback for parsing HTTP headers
      * 
      * @param buffer Header line from HTTP response
      * @param size Size of each character (always 1 for headers)
      * @param nitems Number of characters in header line
-     * @param userdata User pointer (cast to std::map* for headers)
+     * @param userdata User pointer (cast to HttpHeaders*, nullptr = discard)
      * @return Number of bytes processed
      * 
      * Header Format: "Key: Value\r\n"
-     * This callback parses each header line and stores in std::map
+     * This callback hands each line to HttpHeaders::add_line(), which slices
+     * it in place and appends it to the header arena (no temporary strings)
      */
     static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata);
     
     /**
-     * @brief Static callback for writing downloaded file data
+     * @brief Static callback forwarding downloaded data to a DownloadSink
      * 
-     * @param contents File data buffer from curl
-     * @param size Size of each data element
-     * @param nmemb Number of data elements  
-     * @param userp User pointer (cast to std::ofstream* for file writing)
-     * @return Number of bytes written to file
+     * Sink Streaming: Data goes to the sink (file, block device, pipe,
+     * memory) as received; the same bytes are fed to the hasher while
+     * still in memory.
      * 
-     * File Streaming: Data is written directly to disk as received
-     * This prevents memory buildup for large file downloads
+     * @param userp User pointer (sink + optional StreamingHasher)
+     * @return realsize, or 0 to abort when the sink rejects the data
      */
-    static size_t WriteFileCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static size_t WriteSinkCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    
+    // AsyncHttpEngine reuses the header parser and socket tracking for its transfers
+    friend class AsyncHttpEngine;
     
     // Note: Copy constructor and assignment operator are implicitly deleted
     // because the class manages resources (curl handle) that shouldn't be shared
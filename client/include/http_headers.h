@@ -0,0 +1,118 @@
+/**
+ * @file http_headers.h
+ * @brief Flat, case-insensitive HTTP response header storage
+ *
+ * English:
+ * Response headers are stored as one arena string holding the raw
+ * "name" and "value" bytes, plus a small vector of offsets into it (the
+ * first kInlineFields entries live inside the object). Lookups return
+ * std::string_view slices of the arena. Compared with a
+ * std::map<std::string, std::string> this costs at most one allocation for
+ * the arena instead of several per header line, and clear() keeps the
+ * capacity, so a reused HttpResponse parses headers without allocating.
+ *
+ * The few headers the client acts on (Content-Length, ETag, Last-Modified,
+ * Content-Encoding, Retry-After) are recognized while parsing and found by
+ * index; everything else is a linear case-insensitive scan over a handful
+ * of entries.
+ *
+ * A status line ("HTTP/1.1 301 ...") starts a new header block, so after
+ * redirects or "100 Continue" only the final response's headers remain.
+ * Repeated names are all kept; lookups return the last one.
+ *
+ * 한국어:
+ * 응답 header를 하나의 arena 문자열과 그 안을 가리키는 offset 배열(앞의 kInlineFields개는
+ * 객체 내부 배열)로 저장합니다. 조회 결과는 arena를 가리키는 std::string_view입니다.
+ * header 줄마다 여러 번 할당하던 std::map 대신 arena 하나만 할당하며, clear()가 용량을
+ * 유지하므로 재사용하는 HttpResponse는 header 파싱 중 할당이 없습니다. 클라이언트가 실제로
+ * 사용하는 header는 파싱 중에 인식하여 index로 바로 찾습니다. status line이 오면 새 header
+ * 블록으로 보고 이전 내용을 지우므로 redirect 후에는 최종 응답의 header만 남습니다.
+ */
+
+#ifndef HTTP_HEADERS_H
+#define HTTP_HEADERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class HttpHeaders
+ * @brief Header arena + offset small-vector / header arena와 offset small-vector
+ */
+class HttpHeaders {
+public:
+    /** @brief Headers resolved by index while parsing / 파싱 중 인식하는 header */
+    enum Known {
+        kContentLength,
+        kETag,
+        kLastModified,
+        kContentEncoding,
+        kRetryAfter,
+        kKnownCount
+    };
+
+    /** @brief One header as views into the arena (valid until the next change) */
+    struct Field {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    HttpHeaders();
+
+    /** @brief Removes all headers, keeping the arena and vector capacity */
+    void clear();
+
+    /**
+     * @brief Parses one raw header line as delivered by curl
+     *
+     * "Name: value\r\n" is stored with surrounding whitespace trimmed. A
+     * status line clears the previous block; the blank line ending a block
+     * and malformed lines are ignored.
+     */
+    void add_line(const char* line, size_t length);
+
+    /** @brief Appends a header (used by add_line(), also for tests/tools) */
+    void add(std::string_view name, std::string_view value);
+
+    /** @brief Value of a recognized header, empty if absent / 인식된 header 값 */
+    std::string_view get(Known known) const;
+
+    /** @brief Case-insensitive lookup, empty if absent / 대소문자 무시 조회 */
+    std::string_view get(std::string_view name) const;
+
+    /** @brief Whether a header with this name is present */
+    bool contains(std::string_view name) const;
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /** @brief i-th header in arrival order / 도착 순서의 i번째 header */
+    Field operator[](size_t index) const;
+
+private:
+    /// 대부분의 응답은 이보다 header가 적음 - 넘으면 overflow_ 사용
+    static const size_t kInlineFields = 16;
+
+    struct Entry {
+        uint32_t name_offset;
+        uint32_t name_length;
+        uint32_t value_offset;
+        uint32_t value_length;
+    };
+
+    const Entry& entry(size_t index) const {
+        return index < kInlineFields ? inline_[index] : overflow_[index - kInlineFields];
+    }
+    Field field(const Entry& e) const;
+
+    std::string arena_;                 ///< Name and value bytes of all headers
+    Entry inline_[kInlineFields];
+    std::vector<Entry> overflow_;       ///< Entries beyond kInlineFields
+    size_t count_;
+    int known_[kKnownCount];            ///< Entry index per Known header, -1 = absent
+};
+
+#endif // HTTP_HEADERS_H
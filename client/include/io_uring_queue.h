@@ -0,0 +1,101 @@
+/**
+ * @file io_uring_queue.h
+ * @brief Minimal io_uring submission/completion queue for file writes
+ *
+ * English:
+ * A small wrapper over the raw io_uring system calls (no liburing
+ * dependency): prepare write requests, submit them in one system call and
+ * reap completions in batches. Used by FileWriter to keep several buffer
+ * writes in flight while the download keeps receiving.
+ *
+ * init() fails on kernels without io_uring or where it is disabled
+ * (kernel.io_uring_disabled, seccomp); callers then use pwrite().
+ *
+ * 한국어:
+ * liburing 없이 io_uring 시스템 호출을 직접 감싼 작은 래퍼입니다. 쓰기 요청을 준비해
+ * 시스템 호출 한 번으로 제출하고 완료를 묶어서 회수합니다. FileWriter가 여러 버퍼의
+ * 쓰기를 동시에 진행시키는 데 사용합니다. io_uring이 없거나 막힌 커널에서는 init()이
+ * 실패하며 호출자는 pwrite()를 사용합니다.
+ */
+
+#ifndef IO_URING_QUEUE_H
+#define IO_URING_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class IoUringQueue
+ * @brief One io_uring instance / io_uring 인스턴스
+ *
+ * Not thread-safe: one thread prepares, submits and reaps.
+ */
+class IoUringQueue {
+public:
+    IoUringQueue();
+    ~IoUringQueue();
+
+    IoUringQueue(const IoUringQueue&) = delete;
+    IoUringQueue& operator=(const IoUringQueue&) = delete;
+
+    /**
+     * @brief Creates the ring / ring 생성
+     *
+     * @param entries submission queue size (rounded up by the kernel)
+     * @return false if io_uring is unavailable (errno is set)
+     */
+    bool init(unsigned entries);
+
+    /**
+     * @brief Queues a write; nothing is sent until submit()
+     *
+     * @return false if the submission queue is full
+     */
+    bool prepare_write(int fd, const void* data, unsigned size, uint64_t offset, uint64_t user_data);
+
+    /**
+     * @brief Submits prepared requests, optionally waiting for completions
+     *
+     * @param wait_for completions to wait for (0 = do not block)
+     * @return false on a system call error (errno is set)
+     */
+    bool submit(unsigned wait_for = 0);
+
+    /**
+     * @brief Takes one completion without blocking / 완료 하나 회수
+     *
+     * @param result bytes written or -errno
+     * @return false if no completion is available
+     */
+    bool pop_completion(uint64_t& user_data, int& result);
+
+    /** @brief Submitted requests without a reaped completion / 진행 중 요청 수 */
+    unsigned in_flight() const { return in_flight_; }
+
+private:
+    int ring_fd_;
+    void* sq_ring_;
+    size_t sq_ring_size_;
+    void* cq_ring_;             ///< Same mapping as sq_ring_ with IORING_FEAT_SINGLE_MMAP
+    size_t cq_ring_size_;
+    void* sqes_;
+    size_t sqes_size_;
+
+    // Pointers into the shared rings
+    unsigned* sq_head_;
+    unsigned* sq_tail_;
+    unsigned* sq_mask_;
+    unsigned* sq_array_;
+    unsigned sq_entries_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned* cq_mask_;
+    void* cqes_;
+
+    unsigned prepared_;         ///< Prepared but not yet submitted
+    unsigned in_flight_;
+
+    void release();
+};
+
+#endif // IO_URING_QUEUE_H
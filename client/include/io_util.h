@@ -0,0 +1,48 @@
+/**
+ * @file io_util.h
+ * @brief Small blocking I/O helpers shared by the sinks and the gateway
+ *
+ * English:
+ * Retry loops around write(2)/pwrite(2) that every writer of pipes,
+ * sockets and files needs: partial writes are continued and EINTR is retried, so a
+ * caller only sees success or a real error (errno is set). Also the
+ * process-wide SIGPIPE policy for writers to pipes and sockets whose
+ * reader may go away.
+ *
+ * 한국어:
+ * pipe, socket, 파일에 쓰는 코드가 공통으로 필요한 write(2)/pwrite(2) 반복 루프입니다. 부분 쓰기는
+ * 이어서 기록하고 EINTR은 재시도하므로 호출자는 성공 또는 실제 오류(errno 설정)만 봅니다.
+ * 읽는 쪽이 사라질 수 있는 pipe/socket에 쓰기 위한 SIGPIPE 정책도 제공합니다.
+ */
+
+#ifndef IO_UTIL_H
+#define IO_UTIL_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Ignores SIGPIPE if it still has the default action / SIGPIPE 무시
+ *
+ * A closed pipe or socket then fails the write with EPIPE instead of
+ * terminating the process. A handler installed by the application is kept.
+ */
+void ignore_sigpipe();
+
+/**
+ * @brief Writes all size bytes to fd (blocking) / 전부 기록
+ *
+ * @return false on error (errno is set, e.g. EPIPE)
+ */
+bool write_fully(int fd, const char* data, size_t size);
+
+/**
+ * @brief Writes all size bytes to fd at offset / offset 위치에 전부 기록
+ *
+ * The file position is not used or changed.
+ *
+ * @return false on error (errno is set, e.g. ENOSPC)
+ */
+bool pwrite_fully(int fd, const char* data, size_t size, uint64_t offset);
+
+#endif // IO_UTIL_H
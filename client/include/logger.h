@@ -0,0 +1,169 @@
+/**
+ * @file logger.h
+ * @brief Leveled asynchronous logger with a lock-free ring buffer
+ *
+ * English:
+ * Log calls format the message with snprintf straight into a pre-allocated
+ * slot of a bounded lock-free ring buffer and return; a background thread
+ * writes batches to stdout/stderr with one write(2) per batch. The calling
+ * thread never flushes, never allocates and never blocks: if the buffer is
+ * full the message is dropped and counted.
+ *
+ * Levels below HAWKBIT_LOG_LEVEL (compile time) expand to nothing, so their
+ * arguments are not even evaluated. The remaining levels are filtered at run
+ * time by the HAWKBIT_LOG_LEVEL environment variable ("debug", "info", ...).
+ *
+ * 한국어:
+ * 로그 호출은 미리 할당된 lock-free ring buffer 슬롯에 snprintf로 바로 메시지를 쓰고
+ * 반환합니다. 백그라운드 스레드가 여러 메시지를 모아 write(2) 한 번으로 stdout/stderr에
+ * 출력합니다. 호출 스레드는 flush, 할당, 대기를 하지 않으며 버퍼가 가득 차면 메시지를
+ * 버리고 개수만 셉니다.
+ *
+ * 컴파일 시 HAWKBIT_LOG_LEVEL보다 낮은 레벨의 매크로는 빈 문장이 되어 인자도 평가되지
+ * 않습니다. 나머지는 실행 시 HAWKBIT_LOG_LEVEL 환경 변수("debug", "info" 등)로 거릅니다.
+ *
+ * @code
+ * HAWKBIT_LOG_INFO("Polling %s", url.c_str());
+ * HAWKBIT_LOG_DEBUG("Poll response: %.*s", static_cast<int>(body.size()), body.data());
+ * @endcode
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/// Numeric levels, usable in the preprocessor / 전처리기에서 쓰는 숫자 레벨
+#define HAWKBIT_LOG_LEVEL_TRACE 0
+#define HAWKBIT_LOG_LEVEL_DEBUG 1
+#define HAWKBIT_LOG_LEVEL_INFO  2
+#define HAWKBIT_LOG_LEVEL_WARN  3
+#define HAWKBIT_LOG_LEVEL_ERROR 4
+
+/// Lowest level compiled in (set from CMake) / 컴파일에 포함할 최소 레벨
+#ifndef HAWKBIT_LOG_LEVEL
+#define HAWKBIT_LOG_LEVEL HAWKBIT_LOG_LEVEL_DEBUG
+#endif
+
+/** @brief Log severity / 로그 레벨 */
+enum class LogLevel {
+    kTrace = HAWKBIT_LOG_LEVEL_TRACE,
+    kDebug = HAWKBIT_LOG_LEVEL_DEBUG,
+    kInfo = HAWKBIT_LOG_LEVEL_INFO,
+    kWarn = HAWKBIT_LOG_LEVEL_WARN,
+    kError = HAWKBIT_LOG_LEVEL_ERROR,
+    kOff
+};
+
+/**
+ * @class Logger
+ * @brief Process-wide asynchronous log sink / 프로세스 전역 비동기 로거
+ *
+ * English:
+ * Multi-producer, single-consumer: any thread may log. Warnings and errors
+ * go to stderr, everything else to stdout. Messages longer than
+ * kMaxMessageLength are truncated.
+ *
+ * 한국어:
+ * 여러 스레드가 동시에 로그를 남길 수 있고 writer 스레드 하나가 출력합니다.
+ * WARN/ERROR는 stderr, 나머지는 stdout으로 나가며 kMaxMessageLength보다 긴 메시지는
+ * 잘립니다.
+ */
+class Logger {
+public:
+    static const size_t kCapacity = 1024;           ///< Ring buffer slots (power of two)
+    static const size_t kMaxMessageLength = 480;    ///< Bytes per message incl. NUL
+
+    /** @brief The process-wide instance (started on first use) / 전역 인스턴스 */
+    static Logger& instance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /** @brief Runtime filter check / 실행 시 레벨 확인 */
+    bool enabled(LogLevel level) const {
+        return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+    }
+
+    /** @brief Changes the runtime level / 실행 시 레벨 변경 */
+    void set_level(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+    /**
+     * @brief Formats and queues a message (use the macros instead)
+     *
+     * Never blocks; drops the message if the ring buffer is full.
+     */
+    void log(LogLevel level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+    /** @brief Waits until everything queued so far is written / 지금까지의 로그 출력 대기 */
+    void flush();
+
+    /** @brief Messages dropped because the buffer was full / 버퍼 초과로 버린 메시지 수 */
+    unsigned long dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot;
+
+    Logger();
+    ~Logger();
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> enqueue_pos_;   ///< Next slot producers claim
+    alignas(64) size_t dequeue_pos_;                ///< Writer thread only
+    std::atomic<size_t> written_pos_;               ///< Everything below is written
+    std::atomic<unsigned long> dropped_;
+    unsigned long reported_dropped_;                ///< Writer thread only
+    std::atomic<int> level_;
+    std::atomic<bool> stop_;
+
+    std::mutex mutex_;                              ///< For the condition variables only
+    std::condition_variable wake_;                  ///< Writer: new urgent data / flush / stop
+    std::condition_variable written_;               ///< flush(): writer made progress
+    std::thread writer_;
+
+    void run_writer();
+    size_t drain();
+};
+
+/// Base macro; compile-time filtered levels never reach it
+#define HAWKBIT_LOG(level, ...)                                  \
+    do {                                                         \
+        Logger& hawkbit_logger_ = Logger::instance();            \
+        if (hawkbit_logger_.enabled(level)) {                    \
+            hawkbit_logger_.log(level, __VA_ARGS__);             \
+        }                                                        \
+    } while (0)
+
+#if HAWKBIT_LOG_LEVEL <= HAWKBIT_LOG_LEVEL_TRACE
+#define HAWKBIT_LOG_TRACE(...) HAWKBIT_LOG(LogLevel::kTrace, __VA_ARGS__)
+#else
+#define HAWKBIT_LOG_TRACE(...) ((void)0)
+#endif
+
+#if HAWKBIT_LOG_LEVEL <= HAWKBIT_LOG_LEVEL_DEBUG
+#define HAWKBIT_LOG_DEBUG(...) HAWKBIT_LOG(LogLevel::kDebug, __VA_ARGS__)
+#else
+#define HAWKBIT_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if HAWKBIT_LOG_LEVEL <= HAWKBIT_LOG_LEVEL_INFO
+#define HAWKBIT_LOG_INFO(...) HAWKBIT_LOG(LogLevel::kInfo, __VA_ARGS__)
+#else
+#define HAWKBIT_LOG_INFO(...) ((void)0)
+#endif
+
+#if HAWKBIT_LOG_LEVEL <= HAWKBIT_LOG_LEVEL_WARN
+#define HAWKBIT_LOG_WARN(...) HAWKBIT_LOG(LogLevel::kWarn, __VA_ARGS__)
+#else
+#define HAWKBIT_LOG_WARN(...) ((void)0)
+#endif
+
+#define HAWKBIT_LOG_ERROR(...) HAWKBIT_LOG(LogLevel::kError, __VA_ARGS__)
+
+#endif // LOGGER_H
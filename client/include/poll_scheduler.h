@@ -0,0 +1,94 @@
+/**
+ * @file poll_scheduler.h
+ * @brief Server-driven polling interval with jitter and failure backoff
+ *
+ * English:
+ * Decides how long the controller waits before the next poll:
+ * - normally the interval from the server's "config.polling.sleep",
+ *   spread by a random jitter so a fleet does not poll in lockstep;
+ * - after failed polls, an exponential backoff (also jittered) capped at a
+ *   maximum, so an unavailable server is not hammered by every device;
+ * - right after an action finished, an immediate re-poll so the next action
+ *   is picked up without waiting a full interval.
+ *
+ * 한국어:
+ * 다음 poll까지 대기할 시간을 결정합니다.
+ * - 평소에는 서버의 "config.polling.sleep" 값을 사용하되, 기기들이 같은 순간에
+ *   몰리지 않도록 무작위 jitter를 더합니다.
+ * - poll이 실패하면 상한이 있는 지수 백오프(jitter 포함)로 대기하여 장애 중인 서버에
+ *   모든 기기가 계속 요청하지 않도록 합니다.
+ * - 작업(action)이 끝난 직후에는 바로 다시 poll하여 다음 작업을 기다리지 않고 받습니다.
+ */
+
+#ifndef POLL_SCHEDULER_H
+#define POLL_SCHEDULER_H
+
+#include <chrono>
+#include <random>
+#include <string_view>
+
+/**
+ * @brief Parses a DDI polling interval ("HH:MM:SS") / DDI polling 간격 파싱
+ *
+ * @param text e.g. "00:05:00"
+ * @param interval parsed value
+ * @return false if the text is not HH:MM:SS with MM/SS < 60
+ */
+bool parse_polling_sleep(std::string_view text, std::chrono::seconds& interval);
+
+/**
+ * @class PollScheduler
+ * @brief Computes the delay before each poll / poll 간 대기 시간 계산
+ *
+ * Not thread-safe; used from the polling loop only.
+ * polling 루프 스레드에서만 사용합니다.
+ */
+class PollScheduler {
+public:
+    /**
+     * @param default_interval 서버가 간격을 알려주기 전까지 사용할 값
+     * @param initial_backoff 첫 번째 실패 후 대기 시간 (이후 실패마다 2배)
+     * @param max_backoff 백오프 상한
+     * @param jitter_ratio 정상 간격에 더할 jitter 비율 (0.1 = ±10%)
+     */
+    explicit PollScheduler(std::chrono::seconds default_interval = std::chrono::seconds(10),
+                           std::chrono::seconds initial_backoff = std::chrono::seconds(5),
+                           std::chrono::seconds max_backoff = std::chrono::seconds(600),
+                           double jitter_ratio = 0.1);
+
+    /** @brief Applies the server's polling interval / 서버가 준 간격 적용 */
+    void set_server_interval(std::chrono::seconds interval);
+
+    /** @brief Poll succeeded: clears the backoff / poll 성공 - 백오프 초기화 */
+    void on_success();
+
+    /** @brief Poll failed: grows the backoff / poll 실패 - 백오프 증가 */
+    void on_failure();
+
+    /** @brief An action finished: next poll happens immediately / 작업 완료 - 즉시 재poll */
+    void on_action_completed();
+
+    /**
+     * @brief Delay until the next poll / 다음 poll까지 대기 시간
+     *
+     * 즉시 재poll 요청은 한 번만 적용됩니다.
+     */
+    std::chrono::milliseconds next_delay();
+
+    /** @brief Current base interval without jitter / jitter 없는 현재 간격 */
+    std::chrono::seconds interval() const { return interval_; }
+
+    /** @brief Consecutive failed polls / 연속 실패 횟수 */
+    unsigned int consecutive_failures() const { return failures_; }
+
+private:
+    std::chrono::seconds interval_;
+    std::chrono::seconds initial_backoff_;
+    std::chrono::seconds max_backoff_;
+    double jitter_ratio_;
+    unsigned int failures_;
+    bool poll_immediately_;
+    std::minstd_rand random_;   ///< Seeded per device so jitter differs across the fleet (8 bytes)
+};
+
+#endif // POLL_SCHEDULER_H
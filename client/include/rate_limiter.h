@@ -0,0 +1,183 @@
+/**
+ * @file rate_limiter.h
+ * @brief Download bandwidth limits: token bucket, time windows, low priority
+ *
+ * English:
+ * A firmware download on a shared cellular link should not starve the
+ * device's own traffic. RateLimiter is a token bucket on the receive path:
+ * every received chunk takes its size in tokens, and while the bucket is
+ * in debt the transfer stops reading the socket, so the TCP receive window
+ * closes and the sender slows down to the configured rate. One limiter is
+ * shared by all transfers of a deployment (parallel range segments, delta
+ * ranges), so the cap applies to the deployment as a whole.
+ *
+ * The cap can depend on the local time of day (RateWindow, e.g. full speed
+ * at night, 64 KiB/s during office hours, nothing at peak times). In
+ * low-priority mode the limiter additionally follows LEDBAT (RFC 6817): it
+ * samples the TCP round-trip time of the download socket, takes the lowest
+ * RTT seen in the last minutes as the path's base delay, and treats
+ * anything above it as queuing delay caused by a full bottleneck buffer.
+ * Below the target delay (100 ms) the rate grows, above it the rate shrinks
+ * in proportion, so the download uses spare capacity but yields as soon as
+ * other traffic builds a queue.
+ *
+ * 한국어:
+ * 공유 셀룰러 링크에서 firmware 다운로드가 기기의 주 트래픽을 막지 않도록 수신 경로에
+ * token bucket을 둡니다. 받은 만큼 token을 쓰고, 부족하면 소켓을 읽지 않아 TCP 수신
+ * window가 닫히고 송신 측이 설정 속도로 느려집니다. 한 배포의 모든 전송(병렬 range,
+ * delta range)이 limiter 하나를 공유하므로 제한은 배포 전체에 적용됩니다.
+ * 제한 값은 시간대별로 바꿀 수 있고(RateWindow), 저우선순위 모드에서는 LEDBAT(RFC 6817)처럼
+ * 다운로드 소켓의 TCP RTT를 측정하여 최근 최소 RTT보다 늘어난 만큼을 큐 지연으로 보고,
+ * 목표(100 ms)보다 작으면 속도를 올리고 크면 비례하여 줄입니다.
+ */
+
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct RateWindow
+ * @brief Rate cap for a time of day / 시간대별 속도 제한
+ *
+ * [start_minute, end_minute) in local time, minutes after midnight; a
+ * window with start > end wraps past midnight (e.g. 22:00-06:00).
+ */
+struct RateWindow {
+    int start_minute = 0;
+    int end_minute = 0;
+    uint64_t rate = 0;      ///< Bytes/s in this window; 0 = no downloads (see RateLimiter::blocked())
+};
+
+/**
+ * @struct RateLimitOptions
+ * @brief Download bandwidth settings / 다운로드 대역폭 설정
+ */
+struct RateLimitOptions {
+    uint64_t max_rate = 0;                      ///< Bytes/s outside the windows (0 = unlimited)
+    std::vector<RateWindow> windows;            ///< First matching window overrides max_rate
+    uint64_t burst = 0;                         ///< Bucket size in bytes (0 = 250 ms of the rate, >= 64 KiB)
+    bool low_priority = false;                  ///< Yield to other traffic (LEDBAT, RTT-based)
+    std::chrono::milliseconds target_delay{100};    ///< Low priority: tolerated queuing delay
+    uint64_t min_rate = 8 * 1024;               ///< Low priority floor, also the trickle of a blocked window
+
+    bool enabled() const { return max_rate > 0 || !windows.empty() || low_priority; }
+};
+
+/**
+ * @brief Parses "HH:MM-HH:MM=<KiB/s>[,...]" into windows / 시간대 설정 파싱
+ *
+ * e.g. "08:00-18:00=64,22:00-06:00=0"; the rate is in KiB/s, 0 blocks
+ * downloads in that window.
+ *
+ * @return false if an entry is malformed (windows is left unchanged)
+ */
+bool parse_rate_windows(std::string_view text, std::vector<RateWindow>& windows);
+
+/**
+ * @struct RateLimitStats
+ * @brief Achieved rate vs. configured cap / 실제 속도와 제한 값
+ */
+struct RateLimitStats {
+    uint64_t bytes = 0;                 ///< Bytes received through the limiter
+    double elapsed_seconds = 0;         ///< First to last received byte
+    double throttled_seconds = 0;       ///< Time transfers were held back (summed over transfers)
+    uint64_t cap = 0;                   ///< Configured cap right now (0 = unlimited)
+    uint64_t rate = 0;                  ///< Rate enforced right now (cap or low-priority rate)
+    unsigned long rtt_samples = 0;
+    std::chrono::microseconds base_rtt{0};      ///< Low priority: lowest recent RTT
+    std::chrono::microseconds current_rtt{0};   ///< Low priority: filtered latest RTT
+
+    /** @brief Average receive rate in bytes/s / 평균 수신 속도 */
+    double achieved_rate() const { return elapsed_seconds > 0 ? bytes / elapsed_seconds : 0; }
+};
+
+/**
+ * @class RateLimiter
+ * @brief Thread-safe receive token bucket / 수신 token bucket
+ *
+ * Transfers report each received chunk with acquire() and stop reading for
+ * the returned time (AsyncHttpEngine pauses the transfer, HttpClient sleeps
+ * in its write callback). Taking the tokens before waiting lets one chunk
+ * overdraw the bucket, so no chunk is ever split or re-delivered.
+ */
+class RateLimiter {
+public:
+    explicit RateLimiter(const RateLimitOptions& options);
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * @brief Takes tokens for a received chunk / 받은 만큼 token 사용
+     *
+     * @return how long to stop reading (zero while the bucket has tokens)
+     */
+    std::chrono::microseconds acquire(size_t bytes);
+
+    /** @brief acquire() and sleep for the returned time (blocking receive paths) */
+    void throttle(size_t bytes);
+
+    /** @brief Whether an RTT sample is due (low priority, at most every 100 ms) */
+    bool wants_rtt_sample();
+
+    /** @brief Samples the TCP RTT of a receiving socket (TCP_INFO) / 소켓 RTT 측정 */
+    void sample_socket(int fd);
+
+    /** @brief Feeds one RTT measurement to the low-priority controller */
+    void add_rtt_sample(std::chrono::microseconds rtt);
+
+    /**
+     * @brief Whether a window with rate 0 covers the given time / 다운로드 금지 시간대 여부
+     *
+     * New downloads are deferred in such a window; a transfer that is still
+     * running when it begins trickles at min_rate so its connection survives.
+     */
+    static bool blocked(const RateLimitOptions& options, std::time_t now);
+
+    RateLimitStats stats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /** @brief Number of one-minute minima kept for the base RTT (RFC 6817 BASE_HISTORY) */
+    static const size_t kBaseHistory = 10;
+
+    /** @brief Latest samples whose minimum is the current RTT (RFC 6817 CURRENT_FILTER) */
+    static const size_t kCurrentFilter = 4;
+
+    RateLimitOptions options_;
+    mutable std::mutex mutex_;
+
+    double tokens_;                 ///< May be negative (debt from the last chunk)
+    Clock::time_point refilled_;
+    uint64_t cap_;                  ///< Cap of the current window (0 = unlimited)
+    Clock::time_point cap_checked_; ///< Windows are re-evaluated once a second
+    double ledbat_rate_;            ///< Low priority: current rate (bytes/s)
+    bool limited_;                  ///< The bucket held a transfer back since the last RTT sample
+
+    std::vector<std::chrono::microseconds> base_history_;   ///< Per-minute minima, newest last
+    Clock::time_point base_minute_;
+    std::vector<std::chrono::microseconds> current_filter_;
+    Clock::time_point next_sample_;
+
+    RateLimitStats stats_;
+    Clock::time_point first_byte_;
+    Clock::time_point last_byte_;
+
+    /** @brief Cap for the current time of day (mutex_ held) */
+    void update_cap(Clock::time_point now);
+
+    /** @brief Rate enforced now, 0 = unlimited (mutex_ held) */
+    double current_rate() const;
+
+    /** @brief Bucket size for a rate (mutex_ held) */
+    double bucket_size(double rate) const;
+};
+
+#endif // RATE_LIMITER_H
@@ -0,0 +1,117 @@
+/**
+ * @file segmented_downloader.h
+ * @brief Parallel byte-range download for large firmware artifacts
+ *
+ * English:
+ * Splits an artifact of known size (DeploymentInfo::file_size) into byte
+ * ranges, fetches them concurrently over separate connections through
+ * AsyncHttpEngine, and writes each segment at its own offset with pwrite()
+ * on a writer thread, so storage stalls never block the event loop: when
+ * every write buffer is queued, the affected segment is paused and resumed
+ * once the writer frees a buffer.
+ * Useful on high-latency links where a single TCP stream cannot fill the pipe.
+ * Progress is checkpointed to a DownloadJournal, so an interrupted download
+ * (even across a process restart) only fetches the missing ranges.
+ *
+ * 한국어:
+ * 크기를 알고 있는 artifact를 여러 byte range로 나누어 AsyncHttpEngine으로 동시에
+ * (별도 연결로) 내려받고, 각 segment를 writer 스레드에서 pwrite()로 해당 offset에
+ * 기록합니다. 기록 버퍼가 모두 대기 중이면 해당 segment 전송을 일시 정지했다가 writer가
+ * 버퍼를 비우면 재개하므로 저장 장치 지연이 이벤트 루프를 멈추지 않습니다.
+ * 지연이 큰 링크에서 단일 TCP 스트림이 대역폭을 다 쓰지 못할 때 효과적입니다.
+ * 진행 상황은 DownloadJournal에 주기적으로 기록되므로, 중단된 다운로드는
+ * (프로세스 재시작 후에도) 빠진 구간만 다시 받습니다.
+ *
+ * @dot
+ * digraph SegmentedDownload {
+ *   rankdir=LR;
+ *   node [shape=box, style=filled, fillcolor=lightblue];
+ *   file [label="file_size"];
+ *   s0 [label="Range: 0-a"]; s1 [label="Range: a+1-b"]; s2 [label="Range: b+1-end"];
+ *   out [label="pwrite(fd, offset)", fillcolor=lightgreen];
+ *   file -> s0; file -> s1; file -> s2;
+ *   s0 -> out; s1 -> out; s2 -> out;
+ * }
+ * @enddot
+ */
+
+#ifndef SEGMENTED_DOWNLOADER_H
+#define SEGMENTED_DOWNLOADER_H
+
+#include "async_http_engine.h"
+#include "artifact_hasher.h"
+#include "file_writer.h"
+
+#include <future>
+#include <memory>
+#include <string>
+
+/**
+ * @class SegmentedDownloader
+ * @brief Concurrent range downloader / 병렬 range 다운로더
+ *
+ * English:
+ * Every segment must be answered with 206 Partial Content and exactly the
+ * requested number of bytes, otherwise the whole download fails. The first
+ * failing segment aborts the remaining ones. A fresh single-segment download
+ * is sent without a Range header so servers without range support still work.
+ *
+ * 한국어:
+ * 모든 segment는 206 Partial Content와 요청한 길이만큼의 데이터로 응답되어야 하며,
+ * 하나라도 실패하면 나머지 segment도 중단되고 전체 다운로드가 실패합니다.
+ * 실패 전까지 받은 구간은 저널에 남아 다음 download() 호출에서 이어받습니다.
+ * 처음부터 받는 단일 segment는 Range header 없이 요청하여 Range 미지원 서버와도 동작합니다.
+ */
+class SegmentedDownloader {
+public:
+    /** @brief Segments smaller than this are merged / 최소 segment 크기 (256 KiB) */
+    static const size_t kMinSegmentSize = 256 * 1024;
+
+    /** @brief fdatasync + journal update interval / 저널 checkpoint 간격 (4 MiB) */
+    static const size_t kCheckpointInterval = 4 * 1024 * 1024;
+
+    /**
+     * @param engine 전송을 실행할 이벤트 루프 엔진 (downloader보다 오래 살아야 함)
+     * @param segments 동시에 내려받을 최대 range 개수
+     */
+    explicit SegmentedDownloader(AsyncHttpEngine& engine, size_t segments = 4);
+
+    /**
+     * @brief Starts a segmented download / 분할 다운로드 시작
+     *
+     * @param url artifact URL (server must support Range requests)
+     * @param filepath destination file (kept when a matching journal exists,
+     *        otherwise created or truncated; sized to file_size)
+     * @param file_size total artifact size in bytes (0 = unknown: one stream
+     *        without Range and journal, still hashed and rate limited)
+     * @param max_segments segment count for this download (0 = segments())
+     * @param expected_hashes digests verified while streaming (empty = none)
+     * @param rate_limiter bandwidth limit shared by all segments (nullptr = none)
+     * @return future that becomes true when all segments were written
+     *         (and all expected digests match)
+     */
+    std::future<bool> download(const std::string& url, const std::string& filepath,
+                               size_t file_size, size_t max_segments = 0,
+                               const ArtifactHashes& expected_hashes = ArtifactHashes(),
+                               const std::shared_ptr<RateLimiter>& rate_limiter = nullptr);
+
+    /** @brief Configured segment count / 설정된 segment 개수 */
+    size_t segments() const { return segments_; }
+
+    /**
+     * @brief File options for later downloads / 파일 기록 설정
+     *
+     * Segments are written at their own offsets, not through a FileWriter,
+     * so only preallocate and sync_policy apply (io_uring is ignored):
+     * SyncPolicy::kNone skips the final fdatasync(). The journal checkpoints always sync, because a
+     * journal must never list data that is not on disk.
+     */
+    void set_file_write_options(const FileWriteOptions& options) { file_options_ = options; }
+
+private:
+    AsyncHttpEngine& engine_;
+    size_t segments_;
+    FileWriteOptions file_options_;
+};
+
+#endif // SEGMENTED_DOWNLOADER_H
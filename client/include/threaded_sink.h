@@ -0,0 +1,159 @@
+/**
+ * @file threaded_sink.h
+ * @brief Decouples network receive from storage writes with a writer thread
+ *
+ * English:
+ * ThreadedSink wraps another DownloadSink. The download thread only copies
+ * each received chunk into a free buffer of a small pool; a dedicated
+ * writer thread drains full buffers into the wrapped sink. A flash write
+ * stall (SD card garbage collection, fdatasync, ...) is absorbed by the
+ * pool instead of closing the TCP window. Only when every buffer is full
+ * does the download thread wait (backpressure), and that wait is counted.
+ * An event-loop caller that must not wait asks can_accept() first and
+ * pauses its transfer instead; the resume callback tells it when a buffer
+ * was freed.
+ *
+ * 한국어:
+ * ThreadedSink는 다른 DownloadSink를 감쌉니다. 다운로드 스레드는 받은 chunk를 버퍼 풀의
+ * 빈 버퍼에 복사만 하고, 전용 writer 스레드가 가득 찬 버퍼를 감싼 sink에 기록합니다.
+ * flash 쓰기 지연(SD 카드 GC, fdatasync 등)은 버퍼 풀이 흡수하므로 TCP window가 닫히지
+ * 않습니다. 모든 버퍼가 찼을 때만 다운로드 스레드가 대기(backpressure)하며 그 시간을
+ * 통계로 남깁니다. 대기하면 안 되는 이벤트 루프는 can_accept()로 먼저 확인하여 전송을
+ * 일시 정지하고, 버퍼가 비면 resume callback으로 재개합니다.
+ *
+ * @dot
+ * digraph ThreadedSink {
+ *   rankdir=LR;
+ *   node [shape=box, style=filled, fillcolor=lightblue];
+ *   net [label="curl write callback\n(memcpy)"];
+ *   pool [label="buffer pool\n(free / full)", fillcolor=lightyellow];
+ *   writer [label="writer thread"];
+ *   sink [label="FileSink / BlockDeviceSink", fillcolor=lightgreen];
+ *   net -> pool -> writer -> sink;
+ * }
+ * @enddot
+ */
+
+#ifndef THREADED_SINK_H
+#define THREADED_SINK_H
+
+#include "download_sink.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct ThreadedSinkStats
+ * @brief Buffer pool metrics / 버퍼 풀 통계
+ */
+struct ThreadedSinkStats {
+    size_t buffers = 0;                             ///< Pool size
+    size_t buffer_size = 0;                         ///< Bytes per buffer
+    uint64_t bytes = 0;                             ///< Bytes handed to the inner sink
+    unsigned long handoffs = 0;                     ///< Buffers passed to the writer thread
+    size_t max_occupancy = 0;                       ///< Most buffers waiting at once
+    double average_occupancy = 0;                   ///< Mean buffers waiting at hand-off
+    unsigned long stalls = 0;                       ///< Times the download waited for a free buffer
+    std::chrono::microseconds stall_time{0};        ///< Total time the download waited
+    std::chrono::microseconds write_time{0};        ///< Time the writer spent in the inner sink
+};
+
+/**
+ * @class ThreadedSink
+ * @brief DownloadSink decorator with a background writer / 백그라운드 writer 데코레이터
+ *
+ * English:
+ * write() never touches the storage: it fails only after the writer thread
+ * reported an error from the inner sink. finish() waits until every buffer
+ * was written and then commits the inner sink; abort() discards pending
+ * buffers and aborts it.
+ *
+ * 한국어:
+ * write()는 저장 장치에 접근하지 않으며, writer 스레드가 오류를 보고한 뒤에만 실패합니다.
+ * finish()는 모든 버퍼가 기록될 때까지 기다린 뒤 감싼 sink를 확정하고, abort()는 남은
+ * 버퍼를 버리고 감싼 sink를 중단합니다.
+ */
+class ThreadedSink : public DownloadSink {
+public:
+    /**
+     * @param inner 실제 기록 대상
+     * @param buffers 버퍼 개수 (저장 장치 지연을 흡수할 양 = buffers × buffer_size)
+     * @param buffer_size 버퍼 하나의 크기
+     */
+    explicit ThreadedSink(std::unique_ptr<DownloadSink> inner, size_t buffers = 8,
+                          size_t buffer_size = 1024 * 1024);
+    ~ThreadedSink() override;
+
+    ThreadedSink(const ThreadedSink&) = delete;
+    ThreadedSink& operator=(const ThreadedSink&) = delete;
+
+    bool open(uint64_t expected_size) override;
+    bool write(const char* data, size_t size) override;
+    bool finish() override;
+    void abort() override;
+    std::string describe() const override { return inner_->describe() + " (writer thread)"; }
+
+    /**
+     * @brief true if write(size) would not wait for a free buffer / 대기 없이 쓸 수 있는지
+     *
+     * Download thread only. A false answer counts as a stall and arms the
+     * resume callback for the next buffer the writer frees. Also true after
+     * a writer error, so the following write() fails immediately.
+     */
+    bool can_accept(size_t size);
+
+    /**
+     * @brief Called on the writer thread when a buffer is freed after can_accept() refused
+     *
+     * Must not block. Clear it (nullptr) before whatever it calls goes away.
+     */
+    void set_resume_callback(std::function<void()> resume) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        resume_ = std::move(resume);
+    }
+
+    /** @brief Metrics; complete after finish()/abort() / 통계 */
+    ThreadedSinkStats stats() const;
+
+private:
+    /** @brief Buffer handed to the writer thread */
+    struct Pending {
+        size_t index;
+        size_t size;
+    };
+
+    std::unique_ptr<DownloadSink> inner_;
+    size_t buffer_size_;
+    std::vector<std::unique_ptr<char[]>> buffers_;
+
+    // Download thread only
+    size_t current_;            ///< Buffer being filled (npos = none)
+    size_t filled_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable free_changed_;      ///< A buffer was returned / writer failed
+    std::condition_variable pending_changed_;   ///< A buffer was queued / stop requested
+    std::vector<size_t> free_;                  ///< Indexes of empty buffers
+    std::deque<Pending> pending_;               ///< Full buffers in write order
+    bool writing_;                              ///< Writer holds a buffer outside pending_
+    bool waiting_;                              ///< can_accept() refused; resume_ pending
+    std::chrono::steady_clock::time_point wait_started_;
+    std::function<void()> resume_;
+    bool stop_;
+    bool failed_;
+    double occupancy_sum_;
+    ThreadedSinkStats stats_;
+    std::thread writer_;
+
+    bool hand_off();
+    void run_writer();
+    void stop_writer();
+};
+
+#endif // THREADED_SINK_H
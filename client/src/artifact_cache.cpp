@@ -0,0 +1,420 @@
+/**
+ * @file artifact_cache.cpp
+ * @brief ArtifactCache, CachingSink 구현
+ *
+ * - 항목: <dir>/<key>.artifact, 쓰는 중: <dir>/<key>.<pid>.<n>.tmp (open()에서 정리)
+ * - LRU 목록은 메모리에 두고 파일 수정 시각으로 재시작 시 복원
+ * - 복사/검증은 mutex 밖에서 - 열린 fd는 그 사이 항목이 삭제되어도 유효
+ */
+#include "artifact_cache.h"
+#include "logger.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const char kEntrySuffix[] = ".artifact";
+const char kTempSuffix[] = ".tmp";
+
+/// 캐시에서 sink로 복사할 때의 read() 단위
+const size_t kDeliverBlockSize = 1024 * 1024;
+
+bool ends_with(const std::string& text, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+/** @brief 서버가 준 해시가 파일 이름으로 안전한지 (소문자/대문자 16진수만) */
+bool is_hex(const std::string& text) {
+    return !text.empty() && text.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+}
+
+std::string to_lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](char c) { return c >= 'A' && c <= 'F' ? static_cast<char>(c - 'A' + 'a') : c; });
+    return text;
+}
+
+/** @brief copy_file_range로 복사 (같은 파일시스템이면 커널 안에서, reflink 지원시 복사 없음) */
+bool copy_file(int in, int out) {
+    while (true) {
+        ssize_t n = ::copy_file_range(in, nullptr, out, nullptr, 64 * 1024 * 1024, 0);
+        if (n == 0) {
+            return true;
+        }
+        if (n > 0) {
+            continue;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EXDEV && errno != ENOSYS && errno != EOPNOTSUPP && errno != EINVAL) {
+            return false;
+        }
+        break;
+    }
+    // 지원하지 않는 파일시스템: 이미 복사한 위치부터 read/write로 이어서
+    std::vector<char> buffer(kDeliverBlockSize);
+    while (true) {
+        ssize_t n = ::read(in, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return n == 0;
+        }
+        size_t done = 0;
+        while (done < static_cast<size_t>(n)) {
+            ssize_t written = ::write(out, buffer.data() + done, static_cast<size_t>(n) - done);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            done += static_cast<size_t>(written);
+        }
+    }
+}
+
+} // namespace
+
+ArtifactCache::ArtifactCache(const ArtifactCacheOptions& options)
+    : options_(options), temp_counter_(0) {
+}
+
+bool ArtifactCache::open() {
+    const std::string& directory = options_.directory;
+    // 상위 디렉터리까지 순서대로 생성 (mkdir -p)
+    for (size_t slash = directory.find('/', 1); slash != std::string::npos;
+         slash = directory.find('/', slash + 1)) {
+        ::mkdir(directory.substr(0, slash).c_str(), 0755);
+    }
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        HAWKBIT_LOG_ERROR("Cannot create artifact cache %s: %s", directory.c_str(), std::strerror(errno));
+        return false;
+    }
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) {
+        HAWKBIT_LOG_ERROR("Cannot read artifact cache %s: %s", directory.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    struct Found {
+        Entry entry;
+        struct timespec used;
+    };
+    std::vector<Found> found;
+    while (struct dirent* item = ::readdir(dir)) {
+        std::string name = item->d_name;
+        std::string path = directory + "/" + name;
+        if (ends_with(name, kTempSuffix)) {
+            ::unlink(path.c_str());     // 중단된 추가
+            continue;
+        }
+        struct stat st;
+        if (!ends_with(name, kEntrySuffix) || ::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        Found entry = {{name.substr(0, name.size() - std::strlen(kEntrySuffix)),
+                        static_cast<uint64_t>(st.st_size)}, st.st_mtim};
+        found.push_back(entry);
+    }
+    ::closedir(dir);
+
+    // 최근에 사용한 항목이 앞으로
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) {
+        return a.used.tv_sec != b.used.tv_sec ? a.used.tv_sec > b.used.tv_sec : a.used.tv_nsec > b.used.tv_nsec;
+    });
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    stats_ = ArtifactCacheStats();
+    for (const Found& item : found) {
+        lru_.push_back(item.entry);
+        entries_[item.entry.key] = std::prev(lru_.end());
+        stats_.entries++;
+        stats_.bytes += item.entry.size;
+    }
+    enforce_limits();
+    HAWKBIT_LOG_INFO("Artifact cache %s: %zu entries, %llu bytes", directory.c_str(), stats_.entries,
+                     static_cast<unsigned long long>(stats_.bytes));
+    return true;
+}
+
+std::string ArtifactCache::key(const ArtifactHashes& hashes) {
+    if (is_hex(hashes.sha256) && hashes.sha256.size() == 64) {
+        return "sha256-" + to_lower(hashes.sha256);
+    }
+    if (is_hex(hashes.sha1) && hashes.sha1.size() == 40) {
+        return "sha1-" + to_lower(hashes.sha1);
+    }
+    if (is_hex(hashes.md5) && hashes.md5.size() == 32) {
+        return "md5-" + to_lower(hashes.md5);
+    }
+    return std::string();
+}
+
+std::string ArtifactCache::entry_file(const std::string& key) const {
+    return options_.directory + "/" + key + kEntrySuffix;
+}
+
+bool ArtifactCache::lookup(const ArtifactHashes& hashes, uint64_t size) {
+    std::string entry_key = key(hashes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, LruList::iterator>::const_iterator found = entries_.find(entry_key);
+    if (entry_key.empty() || found == entries_.end() || (size != 0 && found->second->size != size)) {
+        stats_.misses++;
+        return false;
+    }
+    return true;
+}
+
+std::string ArtifactCache::entry_path(const ArtifactHashes& hashes) {
+    std::string entry_key = key(hashes);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<std::string, LruList::iterator>::const_iterator found = entries_.find(entry_key);
+    if (entry_key.empty() || found == entries_.end()) {
+        return std::string();
+    }
+    mark_used(found->second);
+    return entry_file(entry_key);
+}
+
+bool ArtifactCache::deliver(const ArtifactHashes& hashes, uint64_t size, DownloadSink& sink) {
+    std::string entry_key = key(hashes);
+    std::string path = entry_path(hashes);
+    int fd = path.empty() ? -1 : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || ::fstat(fd, &st) != 0 || (size != 0 && static_cast<uint64_t>(st.st_size) != size)) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.misses++;
+        return false;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    uint64_t length = static_cast<uint64_t>(st.st_size);
+    if (!sink.open(length)) {
+        HAWKBIT_LOG_ERROR("Failed to open %s", sink.describe().c_str());
+        ::close(fd);
+        return false;
+    }
+
+    StreamingHasher hasher(hashes);
+    std::vector<char> buffer(kDeliverBlockSize);
+    uint64_t done = 0;
+    bool ok = true;
+    while (ok && done < length) {
+        ssize_t n = ::read(fd, buffer.data(), buffer.size());
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        if (ok) {
+            hasher.update(buffer.data(), static_cast<size_t>(n));
+            ok = sink.write(buffer.data(), static_cast<size_t>(n));
+            done += static_cast<uint64_t>(n);
+        }
+    }
+    ::close(fd);
+
+    if (ok && !hasher.verify()) {
+        // 저장 장치에서 손상된 항목 - 지우고 호출자가 다시 다운로드
+        HAWKBIT_LOG_ERROR("Cached artifact %s does not match its digest - removing it", path.c_str());
+        sink.abort();
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_map<std::string, LruList::iterator>::iterator found = entries_.find(entry_key);
+        if (found != entries_.end()) {
+            remove_entry(found->second);
+        }
+        stats_.misses++;
+        return false;
+    }
+    if (!ok) {
+        HAWKBIT_LOG_ERROR("Copying cached artifact %s into %s failed", path.c_str(), sink.describe().c_str());
+        sink.abort();
+        return false;
+    }
+    if (!sink.finish()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.hits++;
+    stats_.bytes_saved += length;
+    return true;
+}
+
+bool ArtifactCache::insert_file(const ArtifactHashes& hashes, const std::string& path) {
+    std::string entry_key = key(hashes);
+    if (entry_key.empty()) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (entries_.count(entry_key)) {
+            return true;
+        }
+    }
+    int in = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        HAWKBIT_LOG_WARN("Cannot cache %s: %s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    std::string temp = temp_path(entry_key);
+    int out = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool ok = out >= 0 && copy_file(in, out);
+    ok = ok && ::fdatasync(out) == 0;
+    if (out >= 0) {
+        ok = ::close(out) == 0 && ok;
+    }
+    ::close(in);
+    if (!ok) {
+        HAWKBIT_LOG_WARN("Cannot cache %s: %s", path.c_str(), std::strerror(errno));
+        ::unlink(temp.c_str());
+        return false;
+    }
+    return commit(temp, entry_key);
+}
+
+std::string ArtifactCache::temp_path(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_.directory + "/" + key + "." + std::to_string(::getpid()) + "." +
+           std::to_string(++temp_counter_) + kTempSuffix;
+}
+
+bool ArtifactCache::commit(const std::string& temp_path, const std::string& key) {
+    struct stat st;
+    if (::stat(temp_path.c_str(), &st) != 0) {
+        return false;
+    }
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    if (options_.max_bytes != 0 && size > options_.max_bytes) {
+        HAWKBIT_LOG_INFO("Artifact of %llu bytes exceeds the cache limit - not cached",
+                         static_cast<unsigned long long>(size));
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string path = entry_file(key);
+    if (::rename(temp_path.c_str(), path.c_str()) != 0) {
+        HAWKBIT_LOG_WARN("Cannot add %s to the artifact cache: %s", path.c_str(), std::strerror(errno));
+        ::unlink(temp_path.c_str());
+        return false;
+    }
+    // 같은 artifact를 동시에 받은 경우 rename이 이전 파일을 대체 - 항목은 하나만 유지
+    std::unordered_map<std::string, LruList::iterator>::iterator found = entries_.find(key);
+    if (found != entries_.end()) {
+        stats_.bytes -= found->second->size;
+        stats_.entries--;
+        lru_.erase(found->second);
+    }
+    Entry entry = {key, size};
+    lru_.push_front(entry);
+    entries_[key] = lru_.begin();
+    stats_.entries++;
+    stats_.bytes += size;
+    stats_.insertions++;
+    enforce_limits();
+    return true;
+}
+
+ArtifactCacheStats ArtifactCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ArtifactCache::mark_used(LruList::iterator entry) {
+    lru_.splice(lru_.begin(), lru_, entry);
+    // 재시작 후 순서 복원용 - 실패해도 이번 실행의 LRU에는 영향 없음
+    ::utimensat(AT_FDCWD, entry_file(entry->key).c_str(), nullptr, 0);
+}
+
+void ArtifactCache::remove_entry(LruList::iterator entry) {
+    ::unlink(entry_file(entry->key).c_str());
+    stats_.entries--;
+    stats_.bytes -= entry->size;
+    entries_.erase(entry->key);
+    lru_.erase(entry);
+}
+
+void ArtifactCache::enforce_limits() {
+    while (!lru_.empty() && ((options_.max_bytes != 0 && stats_.bytes > options_.max_bytes) ||
+                             (options_.max_entries != 0 && stats_.entries > options_.max_entries))) {
+        LruList::iterator oldest = std::prev(lru_.end());
+        HAWKBIT_LOG_INFO("Evicting cached artifact %s (%llu bytes)", oldest->key.c_str(),
+                         static_cast<unsigned long long>(oldest->size));
+        remove_entry(oldest);
+        stats_.evictions++;
+    }
+}
+
+CachingSink::CachingSink(std::unique_ptr<DownloadSink> inner, std::shared_ptr<ArtifactCache> cache,
+                         const ArtifactHashes& hashes)
+    : inner_(std::move(inner)), cache_(cache), key_(ArtifactCache::key(hashes)), caching_(false) {
+}
+
+CachingSink::~CachingSink() {
+    if (caching_) {
+        writer_.abort();
+    }
+}
+
+bool CachingSink::open(uint64_t expected_size) {
+    if (!inner_->open(expected_size)) {
+        return false;
+    }
+    caching_ = false;
+    if (!key_.empty()) {
+        temp_path_ = cache_->temp_path(key_);
+        caching_ = writer_.open(temp_path_, expected_size);
+    }
+    return true;
+}
+
+bool CachingSink::write(const char* data, size_t size) {
+    if (!inner_->write(data, size)) {
+        return false;
+    }
+    if (caching_ && !writer_.write(data, size)) {
+        HAWKBIT_LOG_WARN("Writing %s failed - artifact will not be cached", temp_path_.c_str());
+        writer_.abort();
+        caching_ = false;
+    }
+    return true;
+}
+
+bool CachingSink::finish() {
+    if (!inner_->finish()) {
+        if (caching_) {
+            writer_.abort();
+            caching_ = false;
+        }
+        return false;
+    }
+    if (caching_) {
+        caching_ = false;
+        if (writer_.finish()) {
+            cache_->commit(temp_path_, key_);
+        } else {
+            ::unlink(temp_path_.c_str());
+        }
+    }
+    return true;
+}
+
+void CachingSink::abort() {
+    inner_->abort();
+    if (caching_) {
+        writer_.abort();
+        caching_ = false;
+    }
+}
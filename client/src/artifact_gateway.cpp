@@ -0,0 +1,712 @@
+/**
+ * @file artifact_gateway.cpp
+ * @brief ArtifactGateway 구현
+ *
+ * - 요청 파싱은 GET/HEAD와 Range/Connection 헤더만 (body가 있는 요청은 받지 않음)
+ * - upstream 다운로드는 캐시 임시 파일에 pwrite하고 기록한 바이트 수를 알림 -
+ *   읽는 쪽은 그만큼만 sendfile()로 보냄 (FileWriter의 버퍼를 거치지 않음)
+ * - 완료되면 gateway mutex 안에서 캐시에 commit하고 fetches_에서 제거하므로,
+ *   fetches_에 없으면 항상 캐시 항목을 보게 됨
+ */
+#include "artifact_gateway.h"
+#include "http_client.h"
+#include "io_util.h"
+#include "logger.h"
+#include <curl/curl.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const char kArtifactPath[] = "/artifact/";
+
+/// 요청 헤더 최대 크기 (넘으면 연결 종료)
+const size_t kMaxHeaderSize = 16 * 1024;
+
+bool equals_ignore_case(const std::string& a, const char* b) {
+    return strcasecmp(a.c_str(), b) == 0;
+}
+
+std::string trim(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return std::string();
+    }
+    return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+}
+
+std::string percent_encode(const std::string& text) {
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(text.size() * 3);
+    for (unsigned char c : text) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '.' || c == '_' || c == '~') {
+            encoded += static_cast<char>(c);
+        } else {
+            encoded += '%';
+            encoded += kHex[c >> 4];
+            encoded += kHex[c & 0x0f];
+        }
+    }
+    return encoded;
+}
+
+std::string percent_decode(const std::string& text) {
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            decoded += static_cast<char>(std::strtol(text.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            decoded += text[i];
+        }
+    }
+    return decoded;
+}
+
+/** @brief URL의 한 부분 (없거나 오류면 빈 문자열) */
+std::string url_part(CURLU* handle, CURLUPart part, unsigned int flags = 0) {
+    char* value = nullptr;
+    if (curl_url_get(handle, part, &value, flags) != CURLUE_OK || !value) {
+        return std::string();
+    }
+    std::string text = value;
+    curl_free(value);
+    return text;
+}
+
+/**
+ * @brief URL이 허용된 upstream 아래인지 확인하고 정규화된 URL을 반환
+ *
+ * 문자열 prefix 비교는 "http://server@evil/x", "http://server.evil/x"를 통과시키므로
+ * 두 URL을 CURLU로 나누어 scheme, host, port(기본 port 포함)가 같고 경로가 prefix 경로와
+ * 같거나 그 아래("/" 경계)인지 비교합니다. 사용자 정보가 있는 URL은 거부합니다.
+ * 정규화된 URL(".." 제거 등)을 실제 다운로드에 사용하여 검사한 URL과 받는 URL이 같도록 합니다.
+ *
+ * @return 허용되지 않으면 빈 문자열
+ */
+std::string allowed_upstream_url(const std::string& url, const std::string& upstream) {
+    CURLU* target = curl_url();
+    CURLU* allowed = curl_url();
+    std::string normalized;
+    if (target && allowed && curl_url_set(target, CURLUPART_URL, url.c_str(), 0) == CURLUE_OK &&
+        curl_url_set(allowed, CURLUPART_URL, upstream.c_str(), 0) == CURLUE_OK) {
+        std::string scheme = url_part(target, CURLUPART_SCHEME);
+        std::string path = url_part(target, CURLUPART_PATH);
+        std::string prefix_path = url_part(allowed, CURLUPART_PATH);
+        while (!prefix_path.empty() && prefix_path.back() == '/') {
+            prefix_path.pop_back();
+        }
+        bool ok = (scheme == "http" || scheme == "https") && scheme == url_part(allowed, CURLUPART_SCHEME) &&
+                  url_part(target, CURLUPART_USER).empty() && url_part(target, CURLUPART_PASSWORD).empty() &&
+                  url_part(target, CURLUPART_OPTIONS).empty() &&
+                  strcasecmp(url_part(target, CURLUPART_HOST).c_str(),
+                             url_part(allowed, CURLUPART_HOST).c_str()) == 0 &&
+                  url_part(target, CURLUPART_PORT, CURLU_DEFAULT_PORT) ==
+                      url_part(allowed, CURLUPART_PORT, CURLU_DEFAULT_PORT) &&
+                  path.compare(0, prefix_path.size(), prefix_path) == 0 &&
+                  (path.size() == prefix_path.size() || path[prefix_path.size()] == '/');
+        if (ok) {
+            normalized = url_part(target, CURLUPART_URL);
+        }
+    }
+    curl_url_cleanup(target);
+    curl_url_cleanup(allowed);
+    return normalized;
+}
+
+/** @brief "sha256-<hex>" 형식의 캐시 키를 해시로 (다시 key()로 만들어 같아야 유효) */
+bool hashes_from_key(const std::string& key, ArtifactHashes& hashes) {
+    size_t dash = key.find('-');
+    if (dash == std::string::npos) {
+        return false;
+    }
+    std::string algorithm = key.substr(0, dash);
+    std::string digest = key.substr(dash + 1);
+    if (algorithm == "sha256") {
+        hashes.sha256 = digest;
+    } else if (algorithm == "sha1") {
+        hashes.sha1 = digest;
+    } else if (algorithm == "md5") {
+        hashes.md5 = digest;
+    } else {
+        return false;
+    }
+    return ArtifactCache::key(hashes) == key;
+}
+
+/**
+ * @brief "bytes=a-b", "bytes=a-", "bytes=-n" 하나만 해석
+ *
+ * @return 1 = 범위, 0 = Range 없음/지원하지 않는 형식 (전체 전송), -1 = 만족할 수 없는 범위
+ */
+int parse_range(const std::string& range, uint64_t length, uint64_t& first, uint64_t& last) {
+    if (range.compare(0, 6, "bytes=") != 0 || range.find(',') != std::string::npos) {
+        return 0;
+    }
+    std::string spec = trim(range.substr(6));
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return 0;
+    }
+    std::string start = spec.substr(0, dash);
+    std::string end = spec.substr(dash + 1);
+    if (start.find_first_not_of("0123456789") != std::string::npos ||
+        end.find_first_not_of("0123456789") != std::string::npos || (start.empty() && end.empty())) {
+        return 0;
+    }
+    if (start.empty()) {
+        // 마지막 n 바이트
+        uint64_t suffix = std::strtoull(end.c_str(), nullptr, 10);
+        if (suffix == 0 || length == 0) {
+            return -1;
+        }
+        first = suffix >= length ? 0 : length - suffix;
+        last = length - 1;
+        return 1;
+    }
+    first = std::strtoull(start.c_str(), nullptr, 10);
+    last = end.empty() ? length - 1 : std::min<uint64_t>(std::strtoull(end.c_str(), nullptr, 10), length - 1);
+    if (first >= length || first > last) {
+        return -1;
+    }
+    return 1;
+}
+
+const char* status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 416: return "Range Not Satisfiable";
+    default: return "Internal Server Error";
+    }
+}
+
+/**
+ * @class ProgressSink
+ * @brief upstream 다운로드를 캐시 임시 파일에 기록하고 진행량을 알림
+ */
+class ProgressSink : public DownloadSink {
+public:
+    ProgressSink(int fd, const std::string& path, const std::function<bool(uint64_t)>& progress)
+        : fd_(fd), path_(path), progress_(progress), written_(0) {}
+
+    bool open(uint64_t) override { return fd_ >= 0; }
+
+    bool write(const char* data, size_t size) override {
+        if (!pwrite_fully(fd_, data, size, written_)) {
+            HAWKBIT_LOG_ERROR("Writing %s failed: %s", path_.c_str(), std::strerror(errno));
+            return false;
+        }
+        written_ += size;
+        return progress_(written_);
+    }
+
+    bool finish() override { return ::fdatasync(fd_) == 0; }
+    void abort() override {}
+    std::string describe() const override { return "gateway cache: " + path_; }
+
+private:
+    int fd_;
+    std::string path_;
+    std::function<bool(uint64_t)> progress_;   ///< false = 취소 (gateway 종료)
+    uint64_t written_;
+};
+
+} // namespace
+
+ArtifactGateway::ArtifactGateway(const std::shared_ptr<ArtifactCache>& cache, const GatewayOptions& options)
+    : cache_(cache), options_(options), listen_fd_(-1), port_(0), stopping_(false) {
+    if (options_.uplink_rate_limit.enabled()) {
+        uplink_limiter_ = std::make_shared<RateLimiter>(options_.uplink_rate_limit);
+    }
+}
+
+ArtifactGateway::~ArtifactGateway() {
+    stop();
+}
+
+bool ArtifactGateway::start() {
+    // 끊긴 형제 기기는 EPIPE로 처리 (응답 header는 write_fully, body는 sendfile)
+    ignore_sigpipe();
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options_.port);
+    if (inet_pton(AF_INET, options_.bind_address.c_str(), &address.sin_addr) != 1) {
+        HAWKBIT_LOG_ERROR("Invalid gateway address %s", options_.bind_address.c_str());
+        return false;
+    }
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if (listen_fd_ < 0 || ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+        ::bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listen_fd_, 64) != 0) {
+        HAWKBIT_LOG_ERROR("Cannot listen on %s:%u: %s", options_.bind_address.c_str(), options_.port,
+                          std::strerror(errno));
+        if (listen_fd_ >= 0) {
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+        }
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    ::getsockname(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    stopping_ = false;
+    accept_thread_ = std::thread(&ArtifactGateway::accept_loop, this);
+    HAWKBIT_LOG_INFO("Gateway serving artifacts on %s:%u (upstream %s)", options_.bind_address.c_str(), port_,
+                     options_.upstream_prefix.empty() ? "none - cache only" : options_.upstream_prefix.c_str());
+    return true;
+}
+
+void ArtifactGateway::stop() {
+    if (listen_fd_ < 0) {
+        return;
+    }
+    stopping_ = true;
+    // 대기 중인 accept()를 깨움
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+
+    std::list<Connection> connections;
+    std::list<std::shared_ptr<Fetch>> fetches;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Connection& connection : connections_) {
+            ::shutdown(connection.fd, SHUT_RDWR);
+        }
+        connections.splice(connections.end(), connections_);
+        for (auto& fetch : fetches_) {
+            fetches.push_back(fetch.second);
+        }
+        fetches.splice(fetches.end(), finished_fetches_);
+        progress_.notify_all();
+    }
+    for (Connection& connection : connections) {
+        connection.thread.join();
+    }
+    // 진행 중인 upstream 다운로드는 다음 write()에서 취소됨
+    for (const std::shared_ptr<Fetch>& fetch : fetches) {
+        if (fetch->thread.joinable()) {
+            fetch->thread.join();
+        }
+    }
+}
+
+std::string ArtifactGateway::artifact_url(const std::string& gateway_url, const std::string& download_url,
+                                          uint64_t size, const ArtifactHashes& hashes) {
+    std::string key = ArtifactCache::key(hashes);
+    if (key.empty()) {
+        return std::string();
+    }
+    std::string base = gateway_url;
+    while (!base.empty() && base.back() == '/') {
+        base.pop_back();
+    }
+    return base + kArtifactPath + key + "?size=" + std::to_string(size) + "&url=" + percent_encode(download_url);
+}
+
+GatewayStats ArtifactGateway::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ArtifactGateway::accept_loop() {
+    while (!stopping_) {
+        struct sockaddr_in peer;
+        socklen_t length = sizeof(peer);
+        int fd = ::accept4(listen_fd_, reinterpret_cast<struct sockaddr*>(&peer), &length, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (!stopping_) {
+                HAWKBIT_LOG_ERROR("Gateway accept failed: %s", std::strerror(errno));
+            }
+            break;
+        }
+        // 응답 없는 형제 기기가 연결 스레드를 붙잡지 않도록 송수신 timeout
+        struct timeval timeout = {options_.idle_timeout_seconds, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        int nodelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        char address[INET_ADDRSTRLEN] = "?";
+        inet_ntop(AF_INET, &peer.sin_addr, address, sizeof(address));
+
+        reap_threads();
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.emplace_back();
+        Connection& connection = connections_.back();
+        connection.fd = fd;
+        connection.peer = std::string(address) + ":" + std::to_string(ntohs(peer.sin_port));
+        connection.finished = false;
+        connection.thread = std::thread(&ArtifactGateway::serve_connection, this, &connection);
+        stats_.connections++;
+    }
+}
+
+void ArtifactGateway::serve_connection(Connection* connection) {
+    int fd = connection->fd;
+    std::string buffer;
+    char chunk[4096];
+    unsigned long requests = 0;
+    uint64_t served = 0;
+
+    while (!stopping_) {
+        size_t header_end;
+        bool closed = false;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (buffer.size() > kMaxHeaderSize) {
+                closed = true;
+                break;
+            }
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                closed = true;
+                break;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        if (closed) {
+            break;
+        }
+        std::string head = buffer.substr(0, header_end);
+        buffer.erase(0, header_end + 4);
+
+        // 요청 줄: METHOD SP target SP version
+        size_t line_end = head.find("\r\n");
+        std::string request_line = head.substr(0, line_end);
+        size_t first_space = request_line.find(' ');
+        size_t second_space = request_line.find(' ', first_space + 1);
+        if (first_space == std::string::npos || second_space == std::string::npos) {
+            break;
+        }
+        std::string method = request_line.substr(0, first_space);
+        std::string target = request_line.substr(first_space + 1, second_space - first_space - 1);
+        std::string version = request_line.substr(second_space + 1);
+
+        std::string range;
+        std::string connection_header;
+        bool has_body = false;
+        while (line_end != std::string::npos) {
+            size_t next = head.find("\r\n", line_end + 2);
+            std::string line = head.substr(line_end + 2, next == std::string::npos ? next : next - line_end - 2);
+            line_end = next;
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string name = line.substr(0, colon);
+            std::string value = trim(line.substr(colon + 1));
+            if (equals_ignore_case(name, "Range")) {
+                range = value;
+            } else if (equals_ignore_case(name, "Connection")) {
+                connection_header = value;
+            } else if ((equals_ignore_case(name, "Content-Length") && value != "0") ||
+                       equals_ignore_case(name, "Transfer-Encoding")) {
+                has_body = true;
+            }
+        }
+        bool keep_alive = version == "HTTP/1.1" ? !equals_ignore_case(connection_header, "close")
+                                                : equals_ignore_case(connection_header, "keep-alive");
+        if (has_body) {
+            keep_alive = false;     // body를 읽지 않으므로 연결을 재사용할 수 없음
+        }
+
+        uint64_t sent = 0;
+        bool ok = handle_request(fd, method, target, range, keep_alive, sent);
+        requests++;
+        served += sent;
+        if (!ok || !keep_alive) {
+            break;
+        }
+    }
+    ::close(fd);
+
+    if (served > 0) {
+        GatewayStats total = stats();
+        HAWKBIT_LOG_INFO("Gateway: %s received %llu bytes in %lu requests "
+                         "(total %lu fetches, %llu bytes fetched, %llu served, %lld saved)",
+                         connection->peer.c_str(), static_cast<unsigned long long>(served), requests,
+                         total.fetches, static_cast<unsigned long long>(total.bytes_fetched),
+                         static_cast<unsigned long long>(total.bytes_served),
+                         static_cast<long long>(total.saved_bytes()));
+    }
+    connection->finished = true;
+}
+
+bool ArtifactGateway::handle_request(int fd, const std::string& method, const std::string& target,
+                                     const std::string& range, bool keep_alive, uint64_t& sent) {
+    const char* connection = keep_alive ? "keep-alive" : "close";
+    std::function<bool(int)> send_error = [fd, connection](int status) {
+        std::string response = "HTTP/1.1 " + std::to_string(status) + " " + status_text(status) +
+                               "\r\nContent-Length: 0\r\nConnection: " + connection + "\r\n\r\n";
+        return write_fully(fd, response.data(), response.size());
+    };
+    if (method != "GET" && method != "HEAD") {
+        send_error(405);
+        return false;
+    }
+    bool head_only = method == "HEAD";
+
+    // /artifact/<key>?size=<n>&url=<encoded>
+    size_t query = target.find('?');
+    std::string path = target.substr(0, query);
+    if (path.compare(0, std::strlen(kArtifactPath), kArtifactPath) != 0) {
+        return send_error(404);
+    }
+    std::string key = path.substr(std::strlen(kArtifactPath));
+    std::string url;
+    uint64_t size = 0;
+    if (query != std::string::npos) {
+        std::string parameters = target.substr(query + 1);
+        size_t start = 0;
+        while (start <= parameters.size()) {
+            size_t end = parameters.find('&', start);
+            std::string parameter = parameters.substr(start, end == std::string::npos ? end : end - start);
+            if (parameter.compare(0, 4, "url=") == 0) {
+                url = percent_decode(parameter.substr(4));
+            } else if (parameter.compare(0, 5, "size=") == 0) {
+                size = std::strtoull(parameter.c_str() + 5, nullptr, 10);
+            }
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    int file = -1;
+    uint64_t length = 0;
+    std::shared_ptr<Fetch> fetch;
+    int status = open_artifact(key, url, size, file, length, fetch);
+    if (status != 200) {
+        HAWKBIT_LOG_WARN("Gateway: %s %s -> %d", method.c_str(), path.c_str(), status);
+        return send_error(status);
+    }
+
+    uint64_t first = 0;
+    uint64_t last = length > 0 ? length - 1 : 0;
+    int ranged = range.empty() ? 0 : parse_range(range, length, first, last);
+    if (ranged < 0) {
+        ::close(file);
+        std::string response = "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */" +
+                               std::to_string(length) + "\r\nContent-Length: 0\r\nConnection: " + connection +
+                               "\r\n\r\n";
+        return write_fully(fd, response.data(), response.size());
+    }
+    uint64_t body_length = length > 0 ? last - first + 1 : 0;
+    std::string response = ranged > 0 ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n";
+    response += "Content-Type: application/octet-stream\r\nAccept-Ranges: bytes\r\n";
+    response += "Content-Length: " + std::to_string(body_length) + "\r\n";
+    if (ranged > 0) {
+        response += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+                    std::to_string(length) + "\r\n";
+    }
+    response += std::string("Connection: ") + connection + "\r\n\r\n";
+
+    bool ok = write_fully(fd, response.data(), response.size());
+    if (ok && !head_only) {
+        ok = send_body(fd, file, first, body_length, fetch, sent);
+    }
+    ::close(file);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.requests++;
+    stats_.range_requests += ranged > 0 ? 1 : 0;
+    stats_.cache_hits += fetch ? 0 : 1;
+    stats_.bytes_served += sent;
+    return ok;
+}
+
+int ArtifactGateway::open_artifact(const std::string& key, const std::string& url, uint64_t size, int& fd,
+                                   uint64_t& length, std::shared_ptr<Fetch>& fetch) {
+    ArtifactHashes hashes;
+    if (!hashes_from_key(key, hashes)) {
+        return 404;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, std::shared_ptr<Fetch>>::iterator running = fetches_.find(key);
+    if (running != fetches_.end()) {
+        fetch = running->second;
+        fd = ::open(fetch->temp_path.c_str(), O_RDONLY | O_CLOEXEC);
+        length = fetch->size;
+        return fd >= 0 ? 200 : 500;
+    }
+
+    std::string path = cache_->entry_path(hashes);
+    if (!path.empty()) {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st;
+        if (fd >= 0 && ::fstat(fd, &st) == 0) {
+            length = static_cast<uint64_t>(st.st_size);
+            return 200;
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    // 캐시에 없음 - 허용된 upstream이면 다운로드 시작
+    if (url.empty()) {
+        return 404;
+    }
+    std::string upstream_url;
+    if (!options_.upstream_prefix.empty()) {
+        upstream_url = allowed_upstream_url(url, options_.upstream_prefix);
+    }
+    if (upstream_url.empty()) {
+        HAWKBIT_LOG_WARN("Gateway refused upstream URL %s", url.c_str());
+        return 403;
+    }
+    if (size == 0) {
+        return 400;     // 받는 중에 보내려면 Content-Length를 미리 알아야 함
+    }
+    fetch = std::make_shared<Fetch>();
+    fetch->key = key;
+    fetch->url = upstream_url;
+    fetch->size = size;
+    fetch->temp_path = cache_->temp_path(key);
+    int out = ::open(fetch->temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        HAWKBIT_LOG_ERROR("Cannot create %s: %s", fetch->temp_path.c_str(), std::strerror(errno));
+        return 500;
+    }
+    ::close(out);
+    fd = ::open(fetch->temp_path.c_str(), O_RDONLY | O_CLOEXEC);
+    length = size;
+    fetches_[key] = fetch;
+    stats_.fetches++;
+    fetch->thread = std::thread(&ArtifactGateway::run_fetch, this, fetch);
+    HAWKBIT_LOG_INFO("Gateway fetching %s (%llu bytes) from %s", key.c_str(), static_cast<unsigned long long>(size),
+                     url.c_str());
+    return fd >= 0 ? 200 : 500;
+}
+
+void ArtifactGateway::run_fetch(std::shared_ptr<Fetch> fetch) {
+    Clock::time_point start = Clock::now();
+    ArtifactHashes hashes;
+    hashes_from_key(fetch->key, hashes);
+    int out = ::open(fetch->temp_path.c_str(), O_WRONLY | O_CLOEXEC);
+    ProgressSink sink(out, fetch->temp_path, [this, fetch](uint64_t written) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fetch->written = written;
+        progress_.notify_all();
+        return !stopping_;
+    });
+    HttpClient client;
+    client.set_rate_limiter(uplink_limiter_);   // 동시에 받는 artifact들이 uplink 제한을 나눠 씀
+    bool ok = client.download_to_sink(fetch->url, sink, hashes, fetch->size);
+    if (out >= 0) {
+        ::close(out);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok) {
+        // 캐시 용량을 넘으면 commit이 파일을 지우지만 열려 있는 fd로는 계속 전송 가능
+        cache_->commit(fetch->temp_path, fetch->key);
+        stats_.bytes_fetched += fetch->size;
+        HAWKBIT_LOG_INFO("Gateway fetched %s (%llu bytes) in %lld ms", fetch->key.c_str(),
+                         static_cast<unsigned long long>(fetch->size),
+                         static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                             Clock::now() - start).count()));
+    } else {
+        ::unlink(fetch->temp_path.c_str());
+        stats_.bytes_fetched += fetch->written;
+        stats_.failed_fetches++;
+        HAWKBIT_LOG_ERROR("Gateway fetch of %s from %s failed", fetch->key.c_str(), fetch->url.c_str());
+    }
+    fetch->done = true;
+    fetch->ok = ok;
+    fetches_.erase(fetch->key);
+    finished_fetches_.push_back(fetch);
+    progress_.notify_all();
+}
+
+bool ArtifactGateway::send_body(int socket, int fd, uint64_t offset, uint64_t length,
+                                const std::shared_ptr<Fetch>& fetch, uint64_t& sent) {
+    uint64_t end = offset + length;
+    off_t position = static_cast<off_t>(offset);
+    while (static_cast<uint64_t>(position) < end) {
+        uint64_t available = end;
+        if (fetch) {
+            // 아직 받는 중 - 필요한 위치까지 기록될 때까지 대기. 마지막 바이트는 해시 검증이
+            // 끝난 뒤에만 보내므로 검증에 실패한 artifact는 형제 기기에서 전송 오류(짧은 body)가 됨
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto visible = [&fetch]() {
+                return fetch->done && fetch->ok ? fetch->written : std::min(fetch->written, fetch->size - 1);
+            };
+            progress_.wait(lock, [&]() {
+                return stopping_ || fetch->done || visible() > static_cast<uint64_t>(position);
+            });
+            if (stopping_ || (fetch->done && !fetch->ok) || visible() <= static_cast<uint64_t>(position)) {
+                return false;
+            }
+            available = std::min(end, visible());
+        }
+        ssize_t n = ::sendfile(socket, fd, &position, static_cast<size_t>(available - position));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+void ArtifactGateway::reap_threads() {
+    std::list<Connection> connections;
+    std::list<std::shared_ptr<Fetch>> fetches;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::list<Connection>::iterator it = connections_.begin(); it != connections_.end();) {
+            std::list<Connection>::iterator next = std::next(it);
+            if (it->finished) {
+                connections.splice(connections.end(), connections_, it);
+            }
+            it = next;
+        }
+        fetches.splice(fetches.end(), finished_fetches_);
+    }
+    for (Connection& connection : connections) {
+        connection.thread.join();
+    }
+    for (const std::shared_ptr<Fetch>& fetch : fetches) {
+        fetch->thread.join();
+    }
+}
@@ -0,0 +1,116 @@
+/**
+ * @file artifact_hasher.cpp
+ * @brief OpenSSL EVP 기반 스트리밍 해시 구현
+ *
+ * EVP_Digest* 함수는 CPU 기능을 실행 시점에 감지하여 SHA-NI/AVX2 등의
+ * 가속 구현을 사용합니다. 별도의 intrinsic 코드를 두지 않아도 되므로
+ * x86과 ARM 기기에서 같은 코드를 그대로 사용할 수 있습니다.
+ */
+#include "artifact_hasher.h"
+#include "logger.h"
+#include <openssl/evp.h>
+#include <cctype>
+
+namespace {
+
+/** @brief 바이너리 digest를 소문자 hex 문자열로 변환 */
+std::string to_hex(const unsigned char* digest, unsigned int length) {
+    static const char kHex[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(length * 2);
+    for (unsigned int i = 0; i < length; ++i) {
+        hex.push_back(kHex[digest[i] >> 4]);
+        hex.push_back(kHex[digest[i] & 0x0f]);
+    }
+    return hex;
+}
+
+/** @brief hex 문자열 비교 (대소문자 무시) */
+bool hex_equal(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+StreamingHasher::StreamingHasher(const ArtifactHashes& expected)
+    : expected_(expected), enabled_(false), failed_(false), finalized_(false), bytes_(0) {
+    const EVP_MD* algorithms[kAlgorithmCount] = {EVP_sha256(), EVP_sha1(), EVP_md5()};
+    const char* names[kAlgorithmCount] = {"SHA-256", "SHA-1", "MD5"};
+    const std::string* values[kAlgorithmCount] = {&expected_.sha256, &expected_.sha1, &expected_.md5};
+
+    for (int i = 0; i < kAlgorithmCount; ++i) {
+        contexts_[i] = nullptr;
+        if (values[i]->empty()) {
+            continue;
+        }
+        // 기대값이 있으면 계산할 수 없더라도 검증 대상 - 초기화 실패는 verify()에서 불일치로 처리
+        enabled_ = true;
+        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+        if (ctx && algorithms[i] && EVP_DigestInit_ex(ctx, algorithms[i], nullptr) == 1) {
+            contexts_[i] = ctx;
+        } else {
+            // 예: FIPS provider에서 MD5/SHA-1 사용 불가
+            HAWKBIT_LOG_ERROR("Cannot compute %s digest - artifact verification will fail", names[i]);
+            EVP_MD_CTX_free(ctx);
+            failed_ = true;
+        }
+    }
+}
+
+StreamingHasher::~StreamingHasher() {
+    for (int i = 0; i < kAlgorithmCount; ++i) {
+        EVP_MD_CTX_free(static_cast<EVP_MD_CTX*>(contexts_[i]));
+    }
+}
+
+void StreamingHasher::update(const void* data, size_t size) {
+    if (finalized_) {
+        return;
+    }
+    for (int i = 0; i < kAlgorithmCount; ++i) {
+        if (contexts_[i]) {
+            EVP_DigestUpdate(static_cast<EVP_MD_CTX*>(contexts_[i]), data, size);
+        }
+    }
+    bytes_ += size;
+}
+
+bool StreamingHasher::verify() {
+    const std::string* expected[kAlgorithmCount] = {&expected_.sha256, &expected_.sha1, &expected_.md5};
+    std::string* actual[kAlgorithmCount] = {&actual_.sha256, &actual_.sha1, &actual_.md5};
+
+    if (!finalized_) {
+        for (int i = 0; i < kAlgorithmCount; ++i) {
+            if (!contexts_[i]) {
+                continue;
+            }
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int length = 0;
+            if (EVP_DigestFinal_ex(static_cast<EVP_MD_CTX*>(contexts_[i]), digest, &length) != 1) {
+                failed_ = true;
+                continue;
+            }
+            *actual[i] = to_hex(digest, length);
+        }
+        finalized_ = true;
+    }
+
+    if (failed_) {
+        return false;
+    }
+    for (int i = 0; i < kAlgorithmCount; ++i) {
+        if (contexts_[i] && !hex_equal(*expected[i], *actual[i])) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,646 @@
+/**
+ * @file async_http_engine.cpp
+ * @brief curl multi + epoll 기반 비동기 HTTP 엔진 구현
+ *
+ * 이벤트 루프 동작:
+ * 1. submit()은 요청을 pending 큐에 넣고 eventfd로 루프를 깨움
+ * 2. 루프 스레드가 pending 요청을 curl multi handle에 추가
+ * 3. curl이 SocketCallback/TimerCallback으로 감시할 socket과 timeout을 알려줌
+ * 4. epoll_wait 결과를 curl_multi_socket_action()으로 전달
+ * 5. 완료된 전송은 curl_multi_info_read()로 수집하여 callback 호출
+ */
+#include "async_http_engine.h"
+#include "logger.h"
+#include "threaded_sink.h"
+#include <curl/curl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @brief 전송 하나의 상태
+ *
+ * 이벤트 루프 스레드만 접근합니다 (submit 시점 제외).
+ */
+struct AsyncHttpEngine::Transfer {
+    CURL* easy = nullptr;
+    AsyncRequest request;
+    HttpResponse response;
+    curl_slist* header_list = nullptr;
+    Completion on_complete;
+    size_t running_index = 0;       ///< Position in running_ (O(1) removal)
+    long resume_at_ms = -1;         ///< Paused by the rate limiter until then, -1 = running
+    bool blocked = false;           ///< Paused because can_accept refused the data
+    int socket = -1;                ///< Connection socket, for RTT samples (see HttpClient::sample_rtt())
+    char error[CURL_ERROR_SIZE] = {0};
+};
+
+namespace {
+
+/** @brief 단조 증가 시계 기준 현재 시각 (ms) */
+long now_ms() {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+/**
+ * @brief 생성자 - multi handle, epoll, eventfd 생성 후 루프 스레드 시작
+ *
+ * max_host_connections > 0이면 호스트당 연결 수와 연결 캐시 크기를 제한합니다.
+ * 한도를 넘는 전송은 curl 내부에서 대기하다가 연결이 비면 재사용합니다.
+ * 자원 생성에 실패하면 std::runtime_error를 던집니다.
+ */
+AsyncHttpEngine::AsyncHttpEngine(long max_host_connections, HttpVersion http_version)
+    : curl_global_(CurlGlobal::acquire()), multi_handle_(nullptr), epoll_fd_(-1), wake_fd_(-1),
+      timer_deadline_ms_(-1), http_version_(http_version), stop_(false), active_(0),
+      resume_requested_(false), closed_(false) {
+    multi_handle_ = curl_multi_init();
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!multi_handle_ || epoll_fd_ < 0 || wake_fd_ < 0) {
+        if (multi_handle_) curl_multi_cleanup(multi_handle_);
+        if (epoll_fd_ >= 0) close(epoll_fd_);
+        if (wake_fd_ >= 0) close(wake_fd_);
+        throw std::runtime_error("AsyncHttpEngine: failed to create event loop");
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+    curl_multi_setopt(multi_handle_, CURLMOPT_SOCKETFUNCTION, SocketCallback);
+    curl_multi_setopt(multi_handle_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_handle_, CURLMOPT_TIMERFUNCTION, TimerCallback);
+    curl_multi_setopt(multi_handle_, CURLMOPT_TIMERDATA, this);
+    if (max_host_connections > 0) {
+        curl_multi_setopt(multi_handle_, CURLMOPT_MAX_HOST_CONNECTIONS, max_host_connections);
+        curl_multi_setopt(multi_handle_, CURLMOPT_MAXCONNECTS, max_host_connections);
+    }
+    if (http_version_ != HttpVersion::kAuto) {
+        const curl_version_info_data* info = curl_version_info(CURLVERSION_NOW);
+        if (!(info->features & CURL_VERSION_HTTP2)) {
+            HAWKBIT_LOG_WARN("libcurl %s has no HTTP/2 support, using HTTP/1.1", info->version);
+            http_version_ = HttpVersion::kAuto;
+        } else if (info->version_num < 0x080000) {
+            // 7.88.x: 재사용한 h2 연결의 두 번째 stream이 "Error in the HTTP2 framing layer"로 실패
+            HAWKBIT_LOG_WARN("libcurl %s may fail streams on reused HTTP/2 connections, 8.0+ recommended",
+                             info->version);
+        }
+    }
+    if (http_version_ != HttpVersion::kAuto) {
+        curl_multi_setopt(multi_handle_, CURLMOPT_PIPELINING, static_cast<long>(CURLPIPE_MULTIPLEX));
+    }
+
+    loop_thread_ = std::thread(&AsyncHttpEngine::run_loop, this);
+}
+
+/**
+ * @brief 소멸자 - 루프 종료, 남은 전송은 status code 0으로 완료 처리
+ */
+AsyncHttpEngine::~AsyncHttpEngine() {
+    stop_ = true;
+    wake();
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+
+    curl_multi_cleanup(multi_handle_);
+    close(epoll_fd_);
+    close(wake_fd_);
+}
+
+void AsyncHttpEngine::wake() {
+    uint64_t one = 1;
+    ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+    (void)ignored;
+}
+
+void AsyncHttpEngine::resume_receiving() {
+    resume_requested_ = true;
+    wake();
+}
+
+void AsyncHttpEngine::submit(AsyncRequest request, Completion on_complete) {
+    Transfer* transfer = new Transfer;
+    transfer->request = std::move(request);
+    transfer->on_complete = std::move(on_complete);
+    transfer->response.status_code = 0;
+
+    active_++;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!closed_) {
+            pending_.push_back(transfer);
+            transfer = nullptr;
+        }
+    }
+    if (transfer) {
+        // 루프가 이미 종료됨: 받아 줄 스레드가 없으므로 호출한 스레드에서 바로 실패 처리
+        finish_transfer(transfer, CURLE_ABORTED_BY_CALLBACK);
+        return;
+    }
+    wake();
+}
+
+std::future<HttpResponse> AsyncHttpEngine::submit(AsyncRequest request) {
+    // std::function은 복사 가능해야 하므로 promise를 shared_ptr로 공유
+    std::shared_ptr<std::promise<HttpResponse>> promise =
+        std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    submit(std::move(request), [promise](HttpResponse& response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+std::future<HttpResponse> AsyncHttpEngine::get(const std::string& url) {
+    AsyncRequest request;
+    request.url = url;
+    request.timeout_seconds = 30;
+    return submit(std::move(request));
+}
+
+std::future<HttpResponse> AsyncHttpEngine::post(const std::string& url,
+                                                const std::string& data,
+                                                const std::string& content_type) {
+    AsyncRequest request;
+    request.url = url;
+    request.method = "POST";
+    request.body = data;
+    request.headers.push_back("Content-Type: " + content_type);
+    request.timeout_seconds = 30;
+    return submit(std::move(request));
+}
+
+/**
+ * @brief 파일 다운로드를 백그라운드에서 수행
+ *
+ * 파일 스트림은 on_data 람다와 완료 람다가 공유하며, 전송이 끝나면 닫힙니다.
+ * 대용량 펌웨어는 30초 안에 끝나지 않을 수 있으므로 전체 timeout은 두지 않습니다.
+ */
+std::future<bool> AsyncHttpEngine::download_file(const std::string& url, const std::string& filepath,
+                                                 const FileWriteOptions& options, uint64_t expected_size) {
+    std::shared_ptr<std::promise<bool>> promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+
+    // 이벤트 루프 스레드는 버퍼에 복사만 하고 디스크 기록은 writer 스레드가 담당
+    // (저장 장치 지연이 다른 전송까지 멈추지 않도록). 크기를 알면 미리 할당
+    std::shared_ptr<ThreadedSink> sink = std::make_shared<ThreadedSink>(
+        std::unique_ptr<DownloadSink>(new FileSink(filepath, options)));
+    // 버퍼가 모두 차면 write()에서 기다리지 않고 전송을 멈췄다가 writer가 버퍼를 비우면 재개
+    sink->set_resume_callback([this]() { resume_receiving(); });
+    if (!sink->open(expected_size)) {
+        promise->set_value(false);
+        return future;
+    }
+
+    AsyncRequest request;
+    request.url = url;
+    request.expected_status = 200;
+    request.can_accept = [sink](size_t size) {
+        return sink->can_accept(size);
+    };
+    request.on_data = [sink](const char* data, size_t size) {
+        return sink->write(data, size);
+    };
+
+    submit(std::move(request), [promise, sink](HttpResponse& response) {
+        // 마무리는 엔진보다 오래 살 수 있으므로 재개 요청을 끊고, finish()는 남은 버퍼
+        // 기록과 fdatasync를 기다리므로 루프 밖에서 실행
+        sink->set_resume_callback(nullptr);
+        bool received = response.status_code == 200;
+        std::thread([promise, sink, received]() {
+            if (received && sink->finish()) {
+                promise->set_value(true);
+                return;
+            }
+            sink->abort();
+            promise->set_value(false);
+        }).detach();
+    });
+    return future;
+}
+
+HttpConnectionStats AsyncHttpEngine::connection_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+HttpCompressionStats AsyncHttpEngine::compression_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return compression_stats_;
+}
+
+/**
+ * @brief 응답 body를 on_data로 전달하거나 response.body에 누적
+ *
+ * 누적할 때는 첫 조각에서 Content-Length만큼 용량을 예약합니다 (HttpClient::reserve_body).
+ */
+size_t AsyncHttpEngine::StreamCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t realsize = size * nmemb;
+    Transfer* transfer = static_cast<Transfer*>(userp);
+
+    if (transfer->request.expected_status != 0) {
+        long status = 0;
+        curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &status);
+        if (status != transfer->request.expected_status) {
+            return 0;
+        }
+    }
+
+    if (transfer->request.on_data) {
+        // 소비자에게 공간이 없으면 루프를 막지 않고 멈춤 - curl이 이 조각을 보관했다가
+        // resume_receiving() 후 다시 전달
+        if (transfer->request.can_accept && !transfer->request.can_accept(realsize)) {
+            transfer->blocked = true;
+            return CURL_WRITEFUNC_PAUSE;
+        }
+        // false 반환시 0을 돌려주어 curl이 전송을 중단하도록 함
+        if (!transfer->request.on_data(static_cast<const char*>(contents), realsize)) {
+            return 0;
+        }
+    } else {
+        if (transfer->response.body.empty()) {
+            // 첫 조각: Content-Length만큼 미리 확보하여 누적 중 재할당 방지
+            HttpClient::reserve_body(transfer->easy, transfer->response.body);
+        }
+        transfer->response.body.append(static_cast<const char*>(contents), realsize);
+    }
+
+    // 속도 제한: 받은 조각은 처리하고, token 빚을 갚을 때까지 수신만 멈춤 (루프 스레드는 막지 않음)
+    RateLimiter* limiter = transfer->request.rate_limiter.get();
+    if (limiter) {
+        HttpClient::sample_rtt(transfer->easy, transfer->socket, *limiter);
+        std::chrono::microseconds wait = limiter->acquire(realsize);
+        if (wait.count() > 0) {
+            transfer->resume_at_ms = now_ms() + static_cast<long>((wait.count() + 999) / 1000);
+            curl_easy_pause(transfer->easy, CURLPAUSE_RECV);
+        }
+    }
+    return realsize;
+}
+
+/**
+ * @brief curl이 감시할 socket 상태를 알려주는 callback
+ *
+ * CURL_POLL_REMOVE이면 epoll에서 제거하고, 그 외에는 요청된 방향(IN/OUT)으로
+ * 등록 또는 수정합니다.
+ */
+int AsyncHttpEngine::SocketCallback(void* easy, int sockfd, int what, void* userp, void* socketp) {
+    (void)socketp;
+    AsyncHttpEngine* engine = static_cast<AsyncHttpEngine*>(userp);
+
+    // 재사용한 연결은 새로 열리지 않으므로 전송이 처음 감시를 요청할 때 소켓을 기록
+    // (curl 내부 handle에는 Transfer가 없음)
+    Transfer* transfer = nullptr;
+    if (what != CURL_POLL_REMOVE && easy &&
+        curl_easy_getinfo(static_cast<CURL*>(easy), CURLINFO_PRIVATE, &transfer) == CURLE_OK && transfer) {
+        transfer->socket = sockfd;
+    }
+
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(engine->epoll_fd_, EPOLL_CTL_DEL, sockfd, nullptr);
+        return 0;
+    }
+
+    epoll_event ev = {};
+    ev.data.fd = sockfd;
+    if (what == CURL_POLL_IN || what == CURL_POLL_INOUT) ev.events |= EPOLLIN;
+    if (what == CURL_POLL_OUT || what == CURL_POLL_INOUT) ev.events |= EPOLLOUT;
+
+    if (epoll_ctl(engine->epoll_fd_, EPOLL_CTL_MOD, sockfd, &ev) != 0 && errno == ENOENT) {
+        epoll_ctl(engine->epoll_fd_, EPOLL_CTL_ADD, sockfd, &ev);
+    }
+    return 0;
+}
+
+/**
+ * @brief curl이 요청한 timeout을 절대 시각으로 저장
+ *
+ * timeout_ms == -1이면 timer 삭제, 0이면 즉시 처리가 필요함을 의미합니다.
+ */
+int AsyncHttpEngine::TimerCallback(void* multi, long timeout_ms, void* userp) {
+    (void)multi;
+    AsyncHttpEngine* engine = static_cast<AsyncHttpEngine*>(userp);
+    engine->timer_deadline_ms_ = timeout_ms < 0 ? -1 : now_ms() + timeout_ms;
+    return 0;
+}
+
+/**
+ * @brief pending 큐의 요청을 easy handle로 만들어 multi handle에 추가
+ */
+void AsyncHttpEngine::add_pending_transfers() {
+    std::vector<Transfer*> batch;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batch.swap(pending_);
+    }
+
+    for (Transfer* transfer : batch) {
+        CURL* easy = curl_easy_init();
+        if (!easy) {
+            finish_transfer(transfer, CURLE_FAILED_INIT);
+            continue;
+        }
+        transfer->easy = easy;
+        if (transfer->request.method == "POST") {
+            compress_request_body(transfer->request);
+        }
+        const AsyncRequest& request = transfer->request;
+
+        curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+        curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer);
+        HttpClient::track_sockets(easy, &transfer->socket);
+        curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, transfer->error);
+        curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(easy, CURLOPT_MAXAGE_CONN, 600L);
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT, request.timeout_seconds);
+        curl_easy_setopt(easy, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        curl_easy_setopt(easy, CURLOPT_LOW_SPEED_TIME, 60L);
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, StreamCallback);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer);
+        curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, HttpClient::HeaderCallback);
+        curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer->response.headers);
+        if (request.accept_encoding) {
+            // 빌드된 coding(gzip, deflate, br, zstd)을 모두 제안, curl이 수신하며 디코딩
+            curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+        }
+        if (http_version_ != HttpVersion::kAuto) {
+            curl_easy_setopt(easy, CURLOPT_HTTP_VERSION,
+                             http_version_ == HttpVersion::kHttp2PriorKnowledge
+                                 ? static_cast<long>(CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE)
+                                 : static_cast<long>(CURL_HTTP_VERSION_2TLS));
+            // 연결 중인(아직 h2 협상 전) 연결이 있으면 새 연결 대신 그 위의 stream으로 추가
+            curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+            curl_easy_setopt(easy, CURLOPT_STREAM_WEIGHT, request.stream_weight);
+        }
+
+        if (request.method == "POST") {
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.c_str());
+        }
+        for (const std::string& header : request.headers) {
+            transfer->header_list = curl_slist_append(transfer->header_list, header.c_str());
+        }
+        if (transfer->header_list) {
+            curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->header_list);
+        }
+
+        transfer->running_index = running_.size();
+        running_.push_back(transfer);
+        curl_multi_add_handle(multi_handle_, easy);
+    }
+}
+
+/**
+ * @brief compress_body가 설정된 POST body를 gzip으로 교체하고 통계 갱신
+ *
+ * 압축 결과가 원본보다 작을 때만 교체하고 "Content-Encoding: gzip" header를 추가합니다.
+ */
+void AsyncHttpEngine::compress_request_body(AsyncRequest& request) {
+    size_t original_size = request.body.size();
+    std::string compressed;
+    bool compressed_ok = request.compress_body &&
+                         gzip_compress(request.body.data(), request.body.size(), compressed) &&
+                         compressed.size() < original_size;
+    if (compressed_ok) {
+        request.body.swap(compressed);
+        request.headers.push_back("Content-Encoding: gzip");
+    }
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    compression_stats_.request_body_bytes += original_size;
+    compression_stats_.request_wire_bytes += request.body.size();
+    if (compressed_ok) {
+        compression_stats_.compressed_requests++;
+    }
+}
+
+/**
+ * @brief 완료된 전송을 수집하여 finish_transfer() 호출
+ */
+void AsyncHttpEngine::process_completed_transfers() {
+    int remaining = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi_handle_, &remaining)) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+        Transfer* transfer = nullptr;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &transfer);
+        CURLcode result = msg->data.result;
+
+        long connects = 0;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_NUM_CONNECTS, &connects);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.requests++;
+            if (connects > 0) {
+                stats_.new_connections++;
+            } else if (result == CURLE_OK) {
+                stats_.reused_connections++;
+            }
+            long version = 0;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_HTTP_VERSION, &version);
+            if (version == CURL_HTTP_VERSION_2_0) {
+                stats_.http2_requests++;
+            }
+            // 모아 둔 응답만 집계 (on_data 스트리밍은 다운로드 경로에서 집계)
+            curl_off_t wire_bytes = 0;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_SIZE_DOWNLOAD_T, &wire_bytes);
+            if (result == CURLE_OK && !transfer->request.on_data && wire_bytes > 0) {
+                compression_stats_.responses++;
+                compression_stats_.response_wire_bytes += static_cast<uint64_t>(wire_bytes);
+                compression_stats_.response_body_bytes += transfer->response.body.size();
+                if (is_content_encoded(transfer->response.headers.get(HttpHeaders::kContentEncoding))) {
+                    compression_stats_.compressed_responses++;
+                }
+            }
+        }
+
+        curl_multi_remove_handle(multi_handle_, msg->easy_handle);
+        finish_transfer(transfer, result);
+    }
+}
+
+/**
+ * @brief 응답 코드 기록, 자원 정리, 완료 callback 호출
+ */
+void AsyncHttpEngine::finish_transfer(Transfer* transfer, int curl_code) {
+    if (transfer->easy) {
+        if (curl_code == CURLE_OK) {
+            curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &transfer->response.status_code);
+        } else {
+            transfer->response.status_code = 0;
+            HAWKBIT_LOG_ERROR("cURL async error: %s (%s)",
+                              transfer->error[0] ? transfer->error
+                                                 : curl_easy_strerror(static_cast<CURLcode>(curl_code)),
+                              transfer->request.url.c_str());
+        }
+        curl_easy_cleanup(transfer->easy);
+    }
+    curl_slist_free_all(transfer->header_list);
+
+    // swap-and-pop; pending 단계에서 실패한 전송은 running_에 없음
+    size_t index = transfer->running_index;
+    if (index < running_.size() && running_[index] == transfer) {
+        running_[index] = running_.back();
+        running_[index]->running_index = index;
+        running_.pop_back();
+    }
+
+    if (transfer->on_complete) {
+        transfer->on_complete(transfer->response);
+    }
+    delete transfer;
+    active_--;
+}
+
+/**
+ * @brief 재개 시각이 된 일시 정지 전송을 다시 받기 시작
+ *
+ * curl_easy_pause(CURLPAUSE_CONT)는 그동안 버퍼에 남은 데이터를 바로 StreamCallback으로
+ * 넘기므로 전송이 곧바로 다시 멈출 수 있습니다.
+ *
+ * @return 아직 멈춰 있는 전송 중 가장 이른 재개 시각, 없으면 -1
+ */
+long AsyncHttpEngine::resume_paused_transfers() {
+    long now = now_ms();
+    std::vector<Transfer*> due;
+    for (Transfer* transfer : running_) {
+        if (transfer->resume_at_ms >= 0 && transfer->resume_at_ms <= now) {
+            transfer->resume_at_ms = -1;
+            due.push_back(transfer);
+        }
+    }
+    unpause(due);
+    long earliest = -1;
+    for (Transfer* transfer : running_) {
+        if (transfer->resume_at_ms >= 0 && (earliest < 0 || transfer->resume_at_ms < earliest)) {
+            earliest = transfer->resume_at_ms;
+        }
+    }
+    return earliest;
+}
+
+/**
+ * @brief can_accept 때문에 멈춘 전송을 다시 받기 시작 (resume_receiving() 요청 시)
+ *
+ * 아직 공간이 없으면 다시 전달된 조각에서 곧바로 다시 멈춥니다.
+ */
+void AsyncHttpEngine::resume_blocked_transfers() {
+    std::vector<Transfer*> blocked;
+    for (Transfer* transfer : running_) {
+        if (transfer->blocked) {
+            transfer->blocked = false;
+            blocked.push_back(transfer);
+        }
+    }
+    unpause(blocked);
+}
+
+/**
+ * @brief 멈춘 전송들을 재개
+ *
+ * 재개하면서 다시 전달된 데이터를 callback이 거부하면(on_data가 false) curl_easy_pause()가
+ * 오류를 돌려주고 multi handle은 그 전송을 끝내지도, 소켓을 다시 감시하지도 않으므로
+ * 여기서 실패로 완료 처리합니다.
+ */
+void AsyncHttpEngine::unpause(const std::vector<Transfer*>& transfers) {
+    for (Transfer* transfer : transfers) {
+        CURLcode result = curl_easy_pause(transfer->easy, CURLPAUSE_CONT);
+        if (result != CURLE_OK) {
+            curl_multi_remove_handle(multi_handle_, transfer->easy);
+            finish_transfer(transfer, result);
+        }
+    }
+}
+
+/**
+ * @brief 이벤트 루프 본체
+ *
+ * epoll_wait의 대기 시간은 curl timer의 절대 deadline에서 계산하여
+ * socket 이벤트가 계속 들어와도 timeout 처리가 밀리지 않도록 합니다.
+ */
+void AsyncHttpEngine::run_loop() {
+    const int kMaxEvents = 64;
+    epoll_event events[kMaxEvents];
+    int running_handles = 0;
+
+    while (!stop_) {
+        if (resume_requested_.exchange(false)) {
+            resume_blocked_transfers();
+        }
+        // curl timer와 속도 제한으로 멈춘 전송의 재개 시각 중 이른 쪽까지 대기
+        long deadline = resume_paused_transfers();
+        if (timer_deadline_ms_ >= 0 && (deadline < 0 || timer_deadline_ms_ < deadline)) {
+            deadline = timer_deadline_ms_;
+        }
+        int wait_ms = -1;
+        if (deadline >= 0) {
+            long remaining = deadline - now_ms();
+            wait_ms = remaining > 0 ? static_cast<int>(remaining) : 0;
+        }
+
+        int n = epoll_wait(epoll_fd_, events, kMaxEvents, wait_ms);
+        if (n < 0 && errno != EINTR) {
+            HAWKBIT_LOG_ERROR("epoll_wait failed: %s", std::strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t value;
+                while (read(wake_fd_, &value, sizeof(value)) > 0) {
+                }
+                continue;
+            }
+            int flags = 0;
+            if (events[i].events & EPOLLIN) flags |= CURL_CSELECT_IN;
+            if (events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) flags |= CURL_CSELECT_ERR;
+            curl_multi_socket_action(multi_handle_, fd, flags, &running_handles);
+        }
+
+        add_pending_transfers();
+
+        if (timer_deadline_ms_ >= 0 && timer_deadline_ms_ <= now_ms()) {
+            timer_deadline_ms_ = -1;
+            curl_multi_socket_action(multi_handle_, CURL_SOCKET_TIMEOUT, 0, &running_handles);
+        }
+
+        process_completed_transfers();
+    }
+
+    // 종료: 진행 중/대기 중 전송을 모두 실패로 완료 처리 (future가 영원히 대기하지 않도록)
+    while (!running_.empty()) {
+        Transfer* transfer = running_.back();
+        curl_multi_remove_handle(multi_handle_, transfer->easy);
+        finish_transfer(transfer, CURLE_ABORTED_BY_CALLBACK);
+    }
+    // 완료 callback이 그 사이에 submit한 전송도 처리하도록 큐가 빌 때까지 반복하고,
+    // 비는 순간 closed_로 바꿔 이후 submit은 큐에 넣지 않음
+    for (;;) {
+        std::vector<Transfer*> leftover;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            leftover.swap(pending_);
+            if (leftover.empty()) {
+                closed_ = true;
+                break;
+            }
+        }
+        for (Transfer* transfer : leftover) {
+            finish_transfer(transfer, CURLE_ABORTED_BY_CALLBACK);
+        }
+    }
+}
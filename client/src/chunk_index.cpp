@@ -0,0 +1,234 @@
+/**
+ * @file chunk_index.cpp
+ * @brief Content-defined chunker, index 파서, 로컬 이미지 색인 구현
+ *
+ * - gear table은 splitmix64로 만들어 Python 생성기(server/chunk_index.py)와 동일
+ * - 로컬 이미지는 4 MiB 단위로 읽고, buffer에 max_size 이상 남지 않으면 앞으로 당겨 다시 채움
+ */
+#include "chunk_index.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <openssl/evp.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+/// 로컬 이미지 색인시 read() 단위
+const size_t kSeedReadSize = 4 * 1024 * 1024;
+
+struct GearTable {
+    uint64_t values[256];
+
+    GearTable() {
+        uint64_t state = 0;
+        for (int i = 0; i < 256; ++i) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            values[i] = z ^ (z >> 31);
+        }
+    }
+};
+
+const GearTable kGear;
+
+/** @brief 공백으로 구분된 다음 토큰을 떼어 냄 */
+std::string_view next_token(std::string_view& line) {
+    size_t start = line.find_first_not_of(' ');
+    if (start == std::string_view::npos) {
+        line = std::string_view();
+        return std::string_view();
+    }
+    size_t end = line.find(' ', start);
+    std::string_view token = line.substr(start, end == std::string_view::npos ? end : end - start);
+    line = end == std::string_view::npos ? std::string_view() : line.substr(end);
+    return token;
+}
+
+bool parse_uint(std::string_view token, uint64_t& value) {
+    if (token.empty() || token.size() > 20) {
+        return false;
+    }
+    value = 0;
+    for (char c : token) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool parse_digest(std::string_view token, ChunkDigest& digest) {
+    if (token.size() != digest.size() * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < digest.size(); ++i) {
+        int high = hex_value(token[2 * i]);
+        int low = hex_value(token[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        digest[i] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return true;
+}
+
+} // namespace
+
+bool parse_chunk_index(std::string_view text, ChunkIndex& index) {
+    index = ChunkIndex();
+    bool header = true;
+    uint64_t expected_offset = 0;
+
+    while (!text.empty()) {
+        size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        text = newline == std::string_view::npos ? std::string_view() : text.substr(newline + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        if (header) {
+            uint64_t version, size, min_size, avg_bits, max_size;
+            if (next_token(line) != "hawkbit-cidx" || !parse_uint(next_token(line), version) || version != 1 ||
+                !parse_uint(next_token(line), size) || !parse_uint(next_token(line), min_size) ||
+                !parse_uint(next_token(line), avg_bits) || !parse_uint(next_token(line), max_size) ||
+                min_size == 0 || avg_bits == 0 || avg_bits > 32 || min_size >= max_size || max_size > UINT32_MAX) {
+                return false;
+            }
+            index.size = size;
+            index.params.min_size = static_cast<size_t>(min_size);
+            index.params.avg_bits = static_cast<unsigned>(avg_bits);
+            index.params.max_size = static_cast<size_t>(max_size);
+            index.chunks.reserve(static_cast<size_t>(std::min<uint64_t>(size / min_size + 1, 1 << 20)));
+            header = false;
+            continue;
+        }
+
+        ChunkIndexEntry entry;
+        uint64_t length;
+        if (!parse_uint(next_token(line), entry.offset) || !parse_uint(next_token(line), length) ||
+            !parse_digest(next_token(line), entry.digest) || entry.offset != expected_offset ||
+            length == 0 || length > index.params.max_size) {
+            return false;
+        }
+        entry.length = static_cast<uint32_t>(length);
+        expected_offset += length;
+        index.chunks.push_back(entry);
+    }
+    return !header && expected_offset == index.size;
+}
+
+ChunkDigest chunk_digest(const void* data, size_t size) {
+    ChunkDigest digest;
+    unsigned int length = 0;
+    EVP_Digest(data, size, digest.data(), &length, EVP_sha256(), nullptr);
+    return digest;
+}
+
+std::string chunk_digest_hex(const ChunkDigest& digest) {
+    static const char kHex[] = "0123456789abcdef";
+    std::string hex(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        hex[2 * i] = kHex[digest[i] >> 4];
+        hex[2 * i + 1] = kHex[digest[i] & 0x0f];
+    }
+    return hex;
+}
+
+ContentChunker::ContentChunker(const ChunkingParams& params)
+    : params_(params), mask_(((uint64_t(1) << params.avg_bits) - 1) << (64 - params.avg_bits)) {
+}
+
+size_t ContentChunker::next_chunk(const uint8_t* data, size_t size, bool end_of_data) const {
+    size_t end = std::min(size, params_.max_size);
+    // 첫 min_size 바이트는 hash도 하지 않음 (경계 후보가 아님)
+    uint64_t hash = 0;
+    for (size_t i = params_.min_size; i < end; ++i) {
+        hash = (hash << 1) + kGear.values[data[i]];
+        if ((hash & mask_) == 0) {
+            return i + 1;
+        }
+    }
+    if (end == params_.max_size || end_of_data) {
+        return end;
+    }
+    return 0;   // 경계가 아직 안 나왔고 데이터가 더 있음
+}
+
+bool index_seed_image(const std::string& path, const ChunkingParams& params, SeedIndex& seed,
+                      uint64_t size) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        HAWKBIT_LOG_WARN("Cannot read seed image %s: %s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    ContentChunker chunker(params);
+    std::vector<uint8_t> buffer(kSeedReadSize + params.max_size);
+    uint64_t left = size > 0 ? size : UINT64_MAX;  // 읽을 남은 바이트 (slot 장치의 빈 영역 제외)
+    uint64_t base = 0;      // buffer[0]의 파일 offset
+    size_t filled = 0;
+    size_t position = 0;
+    bool end_of_data = false;
+    bool ok = true;
+
+    while (true) {
+        // 다음 chunk 경계를 판단할 만큼(max_size) 남지 않았으면 앞으로 당겨 채움
+        if (!end_of_data && filled - position < params.max_size) {
+            std::memmove(buffer.data(), buffer.data() + position, filled - position);
+            base += position;
+            filled -= position;
+            position = 0;
+            while (filled < buffer.size() && !end_of_data) {
+                size_t want = static_cast<size_t>(std::min<uint64_t>(buffer.size() - filled, left));
+                ssize_t n = want > 0 ? ::read(fd, buffer.data() + filled, want) : 0;
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n < 0) {
+                    HAWKBIT_LOG_ERROR("Reading seed image %s failed: %s", path.c_str(), std::strerror(errno));
+                    ok = false;
+                    break;
+                }
+                end_of_data = n == 0;
+                filled += static_cast<size_t>(n);
+                left -= static_cast<uint64_t>(n);
+            }
+            if (!ok) {
+                break;
+            }
+        }
+        if (position == filled) {
+            break;
+        }
+        size_t length = chunker.next_chunk(buffer.data() + position, filled - position, end_of_data);
+        SeedChunk chunk = {base + position, static_cast<uint32_t>(length)};
+        seed.emplace(chunk_digest(buffer.data() + position, length), chunk);
+        position += length;
+    }
+    ::close(fd);
+    return ok;
+}
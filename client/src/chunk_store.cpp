@@ -0,0 +1,104 @@
+/**
+ * @file chunk_store.cpp
+ * @brief ChunkStore 구현
+ *
+ * 경로: <dir>/<digest 앞 2자리>/<digest>.chunk (디렉터리당 파일 수 제한)
+ * 쓰기: <path>.tmp에 write 후 rename - 같은 이름에는 항상 완전한 chunk만 존재
+ */
+#include "chunk_store.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+bool make_directory(const std::string& path) {
+    return ::mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+} // namespace
+
+bool ChunkStore::open() {
+    // 상위 디렉터리까지 순서대로 생성 (mkdir -p)
+    for (size_t slash = directory_.find('/', 1); slash != std::string::npos;
+         slash = directory_.find('/', slash + 1)) {
+        make_directory(directory_.substr(0, slash));
+    }
+    if (!make_directory(directory_)) {
+        HAWKBIT_LOG_ERROR("Cannot create chunk store %s: %s", directory_.c_str(), std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+std::string ChunkStore::chunk_path(const ChunkDigest& digest) const {
+    std::string hex = chunk_digest_hex(digest);
+    return directory_ + "/" + hex.substr(0, 2) + "/" + hex + ".chunk";
+}
+
+bool ChunkStore::contains(const ChunkDigest& digest) const {
+    struct stat st;
+    return ::stat(chunk_path(digest).c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+bool ChunkStore::read(const ChunkDigest& digest, std::string& out) const {
+    std::string path = chunk_path(digest);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = ::fstat(fd, &st) == 0;
+    if (ok) {
+        out.resize(static_cast<size_t>(st.st_size));
+        size_t done = 0;
+        while (ok && done < out.size()) {
+            ssize_t n = ::read(fd, &out[done], out.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            ok = n > 0;
+            done += ok ? static_cast<size_t>(n) : 0;
+        }
+    }
+    ::close(fd);
+
+    if (ok && chunk_digest(out.data(), out.size()) == digest) {
+        return true;
+    }
+    HAWKBIT_LOG_WARN("Removing corrupt chunk %s", path.c_str());
+    ::unlink(path.c_str());
+    return false;
+}
+
+bool ChunkStore::put(const ChunkDigest& digest, const char* data, size_t size) {
+    std::string path = chunk_path(digest);
+    make_directory(path.substr(0, path.rfind('/')));
+
+    std::string temp = path + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        HAWKBIT_LOG_WARN("Cannot write chunk %s: %s", temp.c_str(), std::strerror(errno));
+        return false;
+    }
+    size_t done = 0;
+    bool ok = true;
+    while (ok && done < size) {
+        ssize_t n = ::write(fd, data + done, size - done);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        done += ok ? static_cast<size_t>(n) : 0;
+    }
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || ::rename(temp.c_str(), path.c_str()) != 0) {
+        HAWKBIT_LOG_WARN("Cannot store chunk %s: %s", path.c_str(), std::strerror(errno));
+        ::unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
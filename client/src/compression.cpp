@@ -0,0 +1,210 @@
+/**
+ * @file compression.cpp
+ * @brief gzip 압축 helper와 스트리밍 압축 해제 구현 (zlib, libzstd)
+ *
+ * StreamDecompressor:
+ * - 고정 크기 출력 buffer 하나로 입력 조각을 끝까지 풀어 output callback으로 전달
+ * - gzip: inflate가 member 끝에서 CRC-32와 길이를 검사, 이어지는 member는 inflateReset으로 계속
+ * - zstd: ZSTD_decompressStream이 frame의 content checksum을 검사 (HAWKBIT_HAVE_ZSTD일 때만)
+ */
+#include "compression.h"
+#include "logger.h"
+#include <strings.h>
+#include <zlib.h>
+#ifdef HAWKBIT_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+bool has_suffix(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() &&
+           strncasecmp(text.data() + text.size() - suffix.size(), suffix.data(), suffix.size()) == 0;
+}
+
+} // namespace
+
+struct StreamDecompressor::State {
+    z_stream zlib = z_stream();
+    bool zlib_ready = false;
+#ifdef HAWKBIT_HAVE_ZSTD
+    ZSTD_DStream* zstd = nullptr;
+#endif
+};
+
+bool gzip_compress(const char* data, size_t size, std::string& out, int level) {
+    z_stream stream = z_stream();
+    // windowBits 15 + 16: zlib header 대신 gzip header/trailer 생성
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    out.resize(deflateBound(&stream, static_cast<uLong>(size)));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+    stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+    // deflateBound 크기의 출력 buffer면 한 번의 Z_FINISH로 끝남
+    int result = deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+}
+
+bool is_content_encoded(std::string_view content_encoding) {
+    return !content_encoding.empty() &&
+           !(content_encoding.size() == 8 && strncasecmp(content_encoding.data(), "identity", 8) == 0);
+}
+
+ContentCoding coding_from_filename(std::string_view filename) {
+    if (has_suffix(filename, ".gz")) {
+        return ContentCoding::kGzip;
+    }
+    if (has_suffix(filename, ".zst")) {
+        return ContentCoding::kZstd;
+    }
+    return ContentCoding::kIdentity;
+}
+
+const char* coding_name(ContentCoding coding) {
+    switch (coding) {
+    case ContentCoding::kGzip:
+        return "gzip";
+    case ContentCoding::kZstd:
+        return "zstd";
+    default:
+        return "identity";
+    }
+}
+
+bool coding_supported(ContentCoding coding) {
+#ifdef HAWKBIT_HAVE_ZSTD
+    return true;
+#else
+    return coding != ContentCoding::kZstd;
+#endif
+}
+
+StreamDecompressor::StreamDecompressor(ContentCoding coding, Output output)
+    : coding_(coding), output_(output), state_(new State()), finished_(false), bytes_in_(0), bytes_out_(0) {
+}
+
+StreamDecompressor::~StreamDecompressor() {
+    if (state_->zlib_ready) {
+        inflateEnd(&state_->zlib);
+    }
+#ifdef HAWKBIT_HAVE_ZSTD
+    ZSTD_freeDStream(state_->zstd);
+#endif
+}
+
+bool StreamDecompressor::init() {
+    if (!buffer_) {
+        buffer_.reset(new char[kOutputSize]);
+    }
+    finished_ = false;
+    bytes_in_ = 0;
+    bytes_out_ = 0;
+
+    if (coding_ == ContentCoding::kGzip) {
+        if (state_->zlib_ready) {
+            return inflateReset(&state_->zlib) == Z_OK;
+        }
+        // windowBits 15 + 16: gzip header/trailer만 허용
+        state_->zlib_ready = inflateInit2(&state_->zlib, 15 + 16) == Z_OK;
+        return state_->zlib_ready;
+    }
+    if (coding_ == ContentCoding::kZstd) {
+#ifdef HAWKBIT_HAVE_ZSTD
+        if (!state_->zstd) {
+            state_->zstd = ZSTD_createDStream();
+        }
+        return state_->zstd && !ZSTD_isError(ZSTD_initDStream(state_->zstd));
+#else
+        HAWKBIT_LOG_ERROR("zstd artifacts are not supported by this build (libzstd not found)");
+        return false;
+#endif
+    }
+    return true;
+}
+
+bool StreamDecompressor::update(const char* data, size_t size) {
+    bytes_in_ += size;
+    switch (coding_) {
+    case ContentCoding::kGzip:
+        return update_gzip(data, size);
+    case ContentCoding::kZstd:
+        return update_zstd(data, size);
+    default:
+        bytes_out_ += size;
+        finished_ = true;
+        return output_(data, size);
+    }
+}
+
+bool StreamDecompressor::emit(size_t size) {
+    if (size == 0) {
+        return true;
+    }
+    bytes_out_ += size;
+    return output_(buffer_.get(), size);
+}
+
+bool StreamDecompressor::update_gzip(const char* data, size_t size) {
+    z_stream& stream = state_->zlib;
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+
+    // 입력을 모두 소비하고 출력 buffer가 가득 차지 않을 때까지 반복
+    do {
+        if (finished_) {
+            if (stream.avail_in == 0) {
+                break;
+            }
+            // 이어 붙은 gzip member (pigz, 분할 압축 등)
+            inflateReset(&stream);
+            finished_ = false;
+        }
+        stream.next_out = reinterpret_cast<Bytef*>(buffer_.get());
+        stream.avail_out = static_cast<uInt>(kOutputSize);
+        int result = inflate(&stream, Z_NO_FLUSH);
+        if (result == Z_STREAM_END) {
+            finished_ = true;   // trailer의 CRC-32와 길이까지 확인됨
+        } else if (result != Z_OK && result != Z_BUF_ERROR) {
+            HAWKBIT_LOG_ERROR("gzip decoding failed: %s", stream.msg ? stream.msg : "corrupt data");
+            return false;
+        }
+        if (!emit(kOutputSize - stream.avail_out)) {
+            return false;
+        }
+        if (result == Z_BUF_ERROR) {
+            break;  // 더 진행하려면 다음 입력이 필요
+        }
+    } while (stream.avail_in > 0 || stream.avail_out == 0);
+    return true;
+}
+
+bool StreamDecompressor::update_zstd(const char* data, size_t size) {
+#ifdef HAWKBIT_HAVE_ZSTD
+    ZSTD_inBuffer in = {data, size, 0};
+    bool pending = false;   // 출력 buffer가 가득 차서 decoder에 남은 출력이 있을 수 있음
+    while (in.pos < in.size || pending) {
+        ZSTD_outBuffer out = {buffer_.get(), kOutputSize, 0};
+        size_t result = ZSTD_decompressStream(state_->zstd, &out, &in);
+        if (ZSTD_isError(result)) {
+            HAWKBIT_LOG_ERROR("zstd decoding failed: %s", ZSTD_getErrorName(result));
+            return false;
+        }
+        if (!emit(out.pos)) {
+            return false;
+        }
+        // 0 = frame이 끝났고 (checksum 포함) 출력도 모두 전달됨
+        finished_ = result == 0;
+        pending = !finished_ && out.pos == out.size;
+    }
+    return true;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
@@ -0,0 +1,75 @@
+/**
+ * @file curl_global.cpp
+ * @brief CurlGlobal 구현
+ *
+ * 참조 카운트:
+ * - 인스턴스는 weak_ptr로 기억하고, acquire()가 살아 있는 인스턴스를 돌려주거나 새로 생성
+ * - 생성(curl_global_init)과 소멸(curl_global_cleanup)은 같은 mutex 아래에서 실행되어
+ *   한 스레드가 정리하는 동안 다른 스레드가 다시 초기화하는 경쟁이 없음
+ */
+#include "curl_global.h"
+#include "logger.h"
+#include <curl/curl.h>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+std::mutex g_instance_mutex;
+std::weak_ptr<CurlGlobal> g_instance;
+
+/// share 데이터 종류(DNS, SSL session)별 mutex - 인스턴스는 한 번에 하나뿐
+std::mutex g_share_locks[CURL_LOCK_DATA_LAST];
+
+void share_lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userp) {
+    (void)handle;
+    (void)access;
+    (void)userp;
+    g_share_locks[data].lock();
+}
+
+void share_unlock(CURL* handle, curl_lock_data data, void* userp) {
+    (void)handle;
+    (void)userp;
+    g_share_locks[data].unlock();
+}
+
+} // namespace
+
+std::shared_ptr<CurlGlobal> CurlGlobal::acquire() {
+    std::lock_guard<std::mutex> lock(g_instance_mutex);
+    std::shared_ptr<CurlGlobal> instance = g_instance.lock();
+    if (!instance) {
+        instance.reset(new CurlGlobal());
+        g_instance = instance;
+    }
+    return instance;
+}
+
+CurlGlobal::CurlGlobal() : share_handle_(nullptr) {
+    if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
+        throw std::runtime_error("CurlGlobal: curl_global_init failed");
+    }
+    CURLSH* share = curl_share_init();
+    if (!share) {
+        // 공유 캐시 없이도 동작 가능 - client마다 자체 캐시 사용
+        HAWKBIT_LOG_WARN("curl_share_init failed, HTTP clients will not share caches");
+        return;
+    }
+    curl_share_setopt(share, CURLSHOPT_LOCKFUNC, share_lock);
+    curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // 연결 풀(CURL_LOCK_DATA_CONNECT)은 공유하지 않음 - libcurl은 여러 스레드가 동시에
+    // 쓰는 공유 연결 캐시를 지원하지 않으므로 연결 재사용은 handle별로 유지
+    share_handle_ = share;
+}
+
+CurlGlobal::~CurlGlobal() {
+    std::lock_guard<std::mutex> lock(g_instance_mutex);
+    if (share_handle_) {
+        // 이 시점에는 share를 쓰는 easy handle이 없음 (모두 참조를 놓은 뒤)
+        curl_share_cleanup(static_cast<CURLSH*>(share_handle_));
+    }
+    curl_global_cleanup();
+}
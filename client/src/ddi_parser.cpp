@@ -0,0 +1,520 @@
+/**
+ * @file ddi_parser.cpp
+ * @brief 단일 패스 DDI JSON 파서 구현
+ *
+ * 스키마의 각 객체마다 멤버 핸들러를 두고, 알고 있는 key만 해당 필드로 파싱하며
+ * 나머지 값은 skip_value()로 구조적으로 건너뜁니다. 입력을 한 번만 훑고
+ * 문자열은 따옴표 안쪽을 가리키는 string_view로만 기록합니다.
+ */
+#include "ddi_parser.h"
+
+namespace {
+
+/** @brief 악의적인 깊은 중첩으로 인한 stack overflow 방지 */
+const int kMaxDepth = 64;
+
+class DdiParser {
+public:
+    DdiParser(std::string_view json, DdiDeploymentView& view)
+        : p_(json.data()), end_(json.data() + json.size()), view_(view), depth_(0) {}
+
+    bool parse() {
+        if (!parse_object([this](std::string_view key) { return root_member(key); })) {
+            return false;
+        }
+        skip_ws();
+        return p_ == end_;
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+    DdiDeploymentView& view_;
+    int depth_;
+
+    // ---- Tokenizer ----
+
+    void skip_ws() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    bool consume(char c) {
+        skip_ws();
+        if (p_ < end_ && *p_ == c) {
+            ++p_;
+            return true;
+        }
+        return false;
+    }
+
+    bool literal(const char* word, size_t length) {
+        if (static_cast<size_t>(end_ - p_) < length || std::string_view(p_, length) != std::string_view(word, length)) {
+            return false;
+        }
+        p_ += length;
+        return true;
+    }
+
+    /** @brief 문자열 내용(따옴표 제외, 이스케이프 미해석)을 view로 반환 */
+    bool parse_string(std::string_view& out) {
+        skip_ws();
+        if (p_ >= end_ || *p_ != '"') {
+            return false;
+        }
+        const char* start = ++p_;
+        while (p_ < end_) {
+            unsigned char c = static_cast<unsigned char>(*p_);
+            if (c == '"') {
+                out = std::string_view(start, p_ - start);
+                ++p_;
+                return true;
+            }
+            if (c == '\\') {
+                p_ += 2;
+                continue;
+            }
+            if (c < 0x20) {
+                return false;
+            }
+            ++p_;
+        }
+        return false;
+    }
+
+    /** @brief 숫자 토큰을 view로 반환 */
+    bool parse_number(std::string_view& out) {
+        skip_ws();
+        const char* start = p_;
+        while (p_ < end_) {
+            char c = *p_;
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+                ++p_;
+            } else {
+                break;
+            }
+        }
+        out = std::string_view(start, p_ - start);
+        return p_ != start;
+    }
+
+    /**
+     * @brief 음이 아닌 정수 - 부호, 소수부/지수부, uint64 overflow는 parse 오류
+     *
+     * artifact 크기로 쓰이므로 "-5"나 "1.5e3"을 0/1로 읽거나 overflow로 값이 감기지 않도록
+     * 숫자 외의 문자가 있으면 실패합니다.
+     */
+    bool parse_uint(uint64_t& value) {
+        std::string_view token;
+        if (!parse_number(token)) {
+            return false;
+        }
+        value = 0;
+        for (char c : token) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            uint64_t digit = static_cast<uint64_t>(c - '0');
+            if (value > (UINT64_MAX - digit) / 10) {
+                return false;
+            }
+            value = value * 10 + digit;
+        }
+        return true;
+    }
+
+    /** @brief 문자열 또는 숫자 (hawkBit action id는 둘 다 가능) */
+    bool parse_scalar(std::string_view& out) {
+        skip_ws();
+        if (p_ < end_ && *p_ == '"') {
+            return parse_string(out);
+        }
+        return parse_number(out);
+    }
+
+    bool skip_value() {
+        skip_ws();
+        if (p_ >= end_) {
+            return false;
+        }
+        std::string_view ignored;
+        switch (*p_) {
+        case '"':
+            return parse_string(ignored);
+        case '{':
+            return parse_object([this](std::string_view) { return skip_value(); });
+        case '[':
+            return parse_array([this]() { return skip_value(); });
+        case 't':
+            return literal("true", 4);
+        case 'f':
+            return literal("false", 5);
+        case 'n':
+            return literal("null", 4);
+        default:
+            return parse_number(ignored);
+        }
+    }
+
+    template <typename MemberFn>
+    bool parse_object(MemberFn on_member) {
+        if (!consume('{') || ++depth_ > kMaxDepth) {
+            return false;
+        }
+        if (!consume('}')) {
+            do {
+                std::string_view key;
+                if (!parse_string(key) || !consume(':') || !on_member(key)) {
+                    return false;
+                }
+            } while (consume(','));
+            if (!consume('}')) {
+                return false;
+            }
+        }
+        --depth_;
+        return true;
+    }
+
+    template <typename ElementFn>
+    bool parse_array(ElementFn on_element) {
+        if (!consume('[') || ++depth_ > kMaxDepth) {
+            return false;
+        }
+        if (!consume(']')) {
+            do {
+                if (!on_element()) {
+                    return false;
+                }
+            } while (consume(','));
+            if (!consume(']')) {
+                return false;
+            }
+        }
+        --depth_;
+        return true;
+    }
+
+    /** @brief {"href": "..."} 링크 객체 */
+    bool parse_link(std::string_view& href) {
+        return parse_object([this, &href](std::string_view key) {
+            return key == "href" ? parse_string(href) : skip_value();
+        });
+    }
+
+    // ---- Schema ----
+
+    bool root_member(std::string_view key) {
+        if (key == "config") {
+            return parse_object([this](std::string_view k) {
+                if (k != "polling") {
+                    return skip_value();
+                }
+                return parse_object([this](std::string_view pk) {
+                    return pk == "sleep" ? parse_string(view_.polling_sleep) : skip_value();
+                });
+            });
+        }
+        if (key == "_links") {
+            return parse_object([this](std::string_view k) {
+                if (k == "deploymentBase") {
+                    return parse_link(view_.deployment_base_href);
+                }
+                if (k == "configData") {
+                    return parse_link(view_.config_data_href);
+                }
+                if (k == "cancelAction") {
+                    return parse_link(view_.cancel_action_href);
+                }
+                return skip_value();
+            });
+        }
+        if (key == "deploymentBase") {
+            return parse_object([this](std::string_view k) { return deployment_base_member(k); });
+        }
+        // deploymentBase 리소스를 직접 받은 경우 (GET .../deploymentBase/{id})
+        if (key == "id" || key == "deployment" || key == "download") {
+            return deployment_base_member(key);
+        }
+        return skip_value();
+    }
+
+    bool deployment_base_member(std::string_view key) {
+        if (key == "id") {
+            return parse_scalar(view_.id);
+        }
+        if (key == "deployment") {
+            return parse_object([this](std::string_view k) { return deployment_member(k); });
+        }
+        if (key == "download") {
+            return parse_legacy_download();
+        }
+        return skip_value();
+    }
+
+    bool deployment_member(std::string_view key) {
+        if (key == "download") {
+            return parse_string(view_.download_type);
+        }
+        if (key == "update") {
+            return parse_string(view_.update_type);
+        }
+        if (key == "maintenanceWindow") {
+            return parse_string(view_.maintenance_window);
+        }
+        if (key == "chunks") {
+            return parse_array([this]() { return parse_chunk(); });
+        }
+        return skip_value();
+    }
+
+    /** @brief 다음 chunk 슬롯 (용량 초과 시 nullptr) */
+    DdiChunk* next_chunk() {
+        if (view_.chunk_count >= DdiDeploymentView::kMaxChunks) {
+            view_.truncated = true;
+            return nullptr;
+        }
+        DdiChunk* chunk = &view_.chunks[view_.chunk_count++];
+        *chunk = DdiChunk();
+        chunk->first_artifact = view_.artifact_count;
+        return chunk;
+    }
+
+    /** @brief 다음 artifact 슬롯 (용량 초과 시 nullptr) */
+    DdiArtifact* next_artifact(DdiChunk* chunk) {
+        if (!chunk || view_.artifact_count >= DdiDeploymentView::kMaxArtifacts) {
+            view_.truncated = true;
+            return nullptr;
+        }
+        DdiArtifact* artifact = &view_.artifacts[view_.artifact_count++];
+        *artifact = DdiArtifact();
+        ++chunk->artifact_count;
+        return artifact;
+    }
+
+    bool parse_chunk() {
+        DdiChunk* chunk = next_chunk();
+        if (!chunk) {
+            return skip_value();
+        }
+        return parse_object([this, chunk](std::string_view key) {
+            if (key == "part") {
+                return parse_string(chunk->part);
+            }
+            if (key == "version") {
+                return parse_string(chunk->version);
+            }
+            if (key == "name") {
+                return parse_string(chunk->name);
+            }
+            if (key == "artifacts") {
+                return parse_array([this, chunk]() {
+                    DdiArtifact* artifact = next_artifact(chunk);
+                    return artifact ? parse_artifact(*artifact) : skip_value();
+                });
+            }
+            return skip_value();
+        });
+    }
+
+    bool parse_hashes(DdiHashes& hashes) {
+        return parse_object([this, &hashes](std::string_view key) {
+            if (key == "sha256") {
+                return parse_string(hashes.sha256);
+            }
+            if (key == "sha1") {
+                return parse_string(hashes.sha1);
+            }
+            if (key == "md5") {
+                return parse_string(hashes.md5);
+            }
+            return skip_value();
+        });
+    }
+
+    bool parse_artifact(DdiArtifact& artifact) {
+        return parse_object([this, &artifact](std::string_view key) {
+            if (key == "filename") {
+                return parse_string(artifact.filename);
+            }
+            if (key == "size") {
+                return parse_uint(artifact.size);
+            }
+            if (key == "hashes") {
+                return parse_hashes(artifact.hashes);
+            }
+            if (key == "_links") {
+                return parse_object([this, &artifact](std::string_view k) {
+                    if (k == "download") {
+                        return parse_link(artifact.download_href);
+                    }
+                    if (k == "download-http") {
+                        return parse_link(artifact.download_http_href);
+                    }
+                    if (k == "md5sum") {
+                        return parse_link(artifact.md5sum_href);
+                    }
+                    if (k == "md5sum-http") {
+                        return parse_link(artifact.md5sum_http_href);
+                    }
+                    return skip_value();
+                });
+            }
+            return skip_value();
+        });
+    }
+
+    /**
+     * @brief 초기 mock 서버 형식: "download": {"links": {"<name>": {"href", "size", "hashes"}}}
+     *
+     * 모든 링크를 하나의 chunk에 속한 artifact로 변환합니다.
+     */
+    bool parse_legacy_download() {
+        return parse_object([this](std::string_view key) {
+            if (key != "links") {
+                return skip_value();
+            }
+            DdiChunk* chunk = next_chunk();
+            return parse_object([this, chunk](std::string_view name) {
+                DdiArtifact* artifact = next_artifact(chunk);
+                if (!artifact) {
+                    return skip_value();
+                }
+                artifact->filename = name;
+                return parse_object([this, artifact](std::string_view k) {
+                    if (k == "href") {
+                        return parse_string(artifact->download_http_href);
+                    }
+                    if (k == "size") {
+                        return parse_uint(artifact->size);
+                    }
+                    if (k == "hashes") {
+                        return parse_hashes(artifact->hashes);
+                    }
+                    return skip_value();
+                });
+            });
+        });
+    }
+};
+
+void append_utf8(std::string& out, unsigned int code) {
+    if (code < 0x80) {
+        out.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (code >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    }
+}
+
+bool parse_hex4(std::string_view raw, size_t pos, unsigned int& code) {
+    if (pos + 4 > raw.size()) {
+        return false;
+    }
+    code = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        char c = raw[i];
+        code <<= 4;
+        if (c >= '0' && c <= '9') {
+            code |= static_cast<unsigned int>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            code |= static_cast<unsigned int>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            code |= static_cast<unsigned int>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void DdiDeploymentView::clear() {
+    polling_sleep = std::string_view();
+    deployment_base_href = std::string_view();
+    config_data_href = std::string_view();
+    cancel_action_href = std::string_view();
+    id = std::string_view();
+    download_type = std::string_view();
+    update_type = std::string_view();
+    maintenance_window = std::string_view();
+    chunk_count = 0;
+    artifact_count = 0;
+    truncated = false;
+    has_deployment = false;
+}
+
+const DdiArtifact* DdiDeploymentView::primary_artifact() const {
+    for (size_t i = 0; i < artifact_count; ++i) {
+        if (!artifacts[i].href().empty()) {
+            return &artifacts[i];
+        }
+    }
+    return nullptr;
+}
+
+bool parse_ddi_response(std::string_view json, DdiDeploymentView& view) {
+    view.clear();
+    DdiParser parser(json, view);
+    if (!parser.parse()) {
+        return false;
+    }
+    view.has_deployment = !view.id.empty() && view.primary_artifact() != nullptr;
+    return true;
+}
+
+std::string ddi_unescape(std::string_view raw) {
+    if (raw.find('\\') == std::string_view::npos) {
+        return std::string(raw);
+    }
+
+    std::string out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out.push_back(c);
+            continue;
+        }
+        char escaped = raw[++i];
+        switch (escaped) {
+        case 'b': out.push_back('\b'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'n': out.push_back('\n'); break;
+        case 'r': out.push_back('\r'); break;
+        case 't': out.push_back('\t'); break;
+        case 'u': {
+            unsigned int code = 0;
+            if (!parse_hex4(raw, i + 1, code)) {
+                out.push_back('?');
+                break;
+            }
+            i += 4;
+            // UTF-16 surrogate pair
+            unsigned int low = 0;
+            if (code >= 0xd800 && code < 0xdc00 && i + 2 < raw.size() && raw[i + 1] == '\\' &&
+                raw[i + 2] == 'u' && parse_hex4(raw, i + 3, low) && low >= 0xdc00 && low < 0xe000) {
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                i += 6;
+            }
+            append_utf8(out, code);
+            break;
+        }
+        default:
+            out.push_back(escaped);   // \" \\ \/
+            break;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file download_journal.cpp
+ * @brief 다운로드 진행 저널 구현
+ *
+ * 저장 과정:
+ * 1. "<journal>.tmp"에 전체 내용을 기록
+ * 2. fsync()로 임시 파일을 디스크에 반영
+ * 3. rename()으로 기존 저널을 원자적으로 교체
+ * 중간에 전원이 나가도 이전 저널 또는 새 저널 중 하나가 온전히 남습니다.
+ */
+#include "download_journal.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+const char* const kJournalMagic = "hawkbit-download-journal 1";
+
+} // namespace
+
+DownloadJournal::DownloadJournal(const std::string& target_path)
+    : journal_path_(target_path + ".journal"), total_size_(0) {
+}
+
+bool DownloadJournal::load(const std::string& key, size_t total_size) {
+    key_ = key;
+    total_size_ = total_size;
+    completed_.clear();
+
+    std::ifstream in(journal_path_);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in, line) || line != kJournalMagic) {
+        return false;
+    }
+
+    std::string stored_key;
+    size_t stored_size = 0;
+    std::vector<Range> ranges;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string tag;
+        fields >> tag;
+        if (tag == "key") {
+            std::getline(fields >> std::ws, stored_key);
+        } else if (tag == "size") {
+            fields >> stored_size;
+        } else if (tag == "range") {
+            Range range;
+            if (fields >> range.first >> range.second) {
+                ranges.push_back(range);
+            }
+        }
+    }
+
+    // 다른 artifact의 저널이면 무시하고 처음부터 시작
+    if (stored_key != key || stored_size != total_size) {
+        return false;
+    }
+    for (const Range& range : ranges) {
+        add_range(range.first, range.second);
+    }
+    return true;
+}
+
+/**
+ * @brief 구간을 추가하고 인접/중복 구간을 병합
+ */
+void DownloadJournal::add_range(size_t begin, size_t end) {
+    end = std::min(end, total_size_);
+    if (begin >= end) {
+        return;
+    }
+
+    std::vector<Range> merged;
+    merged.reserve(completed_.size() + 1);
+    Range current(begin, end);
+    bool inserted = false;
+    for (const Range& range : completed_) {
+        if (range.second < current.first) {
+            merged.push_back(range);
+        } else if (current.second < range.first) {
+            if (!inserted) {
+                merged.push_back(current);
+                inserted = true;
+            }
+            merged.push_back(range);
+        } else {
+            current.first = std::min(current.first, range.first);
+            current.second = std::max(current.second, range.second);
+        }
+    }
+    if (!inserted) {
+        merged.push_back(current);
+    }
+    completed_.swap(merged);
+}
+
+bool DownloadJournal::save() const {
+    std::ostringstream content;
+    content << kJournalMagic << "\n"
+            << "key " << key_ << "\n"
+            << "size " << total_size_ << "\n";
+    for (const Range& range : completed_) {
+        content << "range " << range.first << " " << range.second << "\n";
+    }
+    const std::string data = content.str();
+
+    std::string tmp_path = journal_path_ + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()) &&
+              fsync(fd) == 0;
+    close(fd);
+
+    if (!ok || std::rename(tmp_path.c_str(), journal_path_.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void DownloadJournal::remove() const {
+    std::remove(journal_path_.c_str());
+}
+
+std::vector<DownloadJournal::Range> DownloadJournal::missing_ranges() const {
+    std::vector<Range> missing;
+    size_t position = 0;
+    for (const Range& range : completed_) {
+        if (range.first > position) {
+            missing.push_back(Range(position, range.first));
+        }
+        position = range.second;
+    }
+    if (position < total_size_) {
+        missing.push_back(Range(position, total_size_));
+    }
+    return missing;
+}
+
+size_t DownloadJournal::completed_bytes() const {
+    size_t total = 0;
+    for (const Range& range : completed_) {
+        total += range.second - range.first;
+    }
+    return total;
+}
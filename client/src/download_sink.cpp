@@ -0,0 +1,363 @@
+/**
+ * @file download_sink.cpp
+ * @brief DownloadSink 백엔드 구현
+ *
+ * 백엔드별 I/O 경로:
+ * - FileSink: FileWriter (fallocate + 1 MiB 버퍼 pwrite + sync 정책)
+ * - BlockDeviceSink: 정렬된 1 MiB 버퍼 + O_DIRECT pwrite (page cache 우회)
+ * - PipeSink/ProcessSink: blocking write (느린 소비자 = backpressure)
+ * - MemorySink: expected_size로 한 번만 reserve
+ * - DecompressingSink: StreamDecompressor의 64 KiB 출력 buffer 단위로 안쪽 sink에 write
+ *
+ * curl이 넘겨주는 버퍼는 callback이 끝나면 재사용되므로 vmsplice/splice로 페이지를
+ * 넘길 수 없습니다. 따라서 pipe 계열은 write(2) 한 번의 복사가 최소 경로입니다.
+ *
+ * ProcessSink:
+ * - pipe는 O_CLOEXEC로 만들어 쓰기 쪽 fd가 자식에게 새지 않도록 함
+ *   (열려 있으면 자식이 EOF를 영원히 받지 못함)
+ * - 쓰기는 blocking: 설치 명령이 느리면 write()가 대기하고, 그동안 curl은 소켓을
+ *   읽지 않으므로 TCP window가 닫혀 서버 전송이 느려짐
+ * - 설치 명령이 먼저 종료하면 SIGPIPE 대신 EPIPE로 실패 처리
+ * - 명령은 자체 process group으로 실행하고 abort()는 group 전체에 signal을 보냄
+ *   (sh만 종료하면 dd 등 자식이 stdin EOF를 정상 종료로 받아 잘린 이미지를 기록)
+ */
+#include "download_sink.h"
+#include "io_util.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+extern char** environ;
+
+namespace {
+
+/// 파이프 버퍼 크기 (기본 64 KiB → 네트워크 burst 흡수용으로 확대, 실패해도 무시)
+const int kPipeBufferSize = 1024 * 1024;
+
+/// abort() 시 SIGTERM 후 SIGKILL까지 기다리는 시간
+const int kAbortGraceMs = 2000;
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// FileSink
+// ---------------------------------------------------------------------------
+
+FileSink::FileSink(const std::string& path, const FileWriteOptions& options)
+    : path_(path), writer_(options) {}
+
+// ---------------------------------------------------------------------------
+// BlockDeviceSink
+// ---------------------------------------------------------------------------
+
+BlockDeviceSink::BlockDeviceSink(const std::string& device)
+    : device_(device), fd_(-1), direct_(false), buffer_(nullptr), buffered_(0), offset_(0) {}
+
+BlockDeviceSink::~BlockDeviceSink() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    std::free(buffer_);
+}
+
+bool BlockDeviceSink::open(uint64_t expected_size) {
+    if (!buffer_) {
+        void* memory = nullptr;
+        if (posix_memalign(&memory, kAlignment, kBufferSize) != 0) {
+            return false;
+        }
+        buffer_ = static_cast<char*>(memory);
+    }
+
+    // 장치 파티션은 O_TRUNC/O_CREAT 없이 열기 (이미지 파일 테스트시에는 기존 파일 필요)
+    direct_ = true;
+    fd_ = ::open(device_.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+    if (fd_ < 0 && errno == EINVAL) {
+        // tmpfs 등 O_DIRECT 미지원 파일시스템
+        direct_ = false;
+        fd_ = ::open(device_.c_str(), O_WRONLY | O_CLOEXEC);
+    }
+    if (fd_ < 0) {
+        HAWKBIT_LOG_ERROR("Failed to open %s: %s", device_.c_str(), std::strerror(errno));
+        return false;
+    }
+
+    // 이미지가 slot보다 크면 쓰기 전에 거부 (다른 파티션을 덮어쓰지 않도록)
+    struct stat info;
+    uint64_t capacity = 0;
+    if (fstat(fd_, &info) == 0 && S_ISBLK(info.st_mode) && ioctl(fd_, BLKGETSIZE64, &capacity) == 0 &&
+        expected_size > capacity) {
+        HAWKBIT_LOG_ERROR("Image (%llu bytes) does not fit %s (%llu bytes)",
+                          static_cast<unsigned long long>(expected_size), device_.c_str(),
+                          static_cast<unsigned long long>(capacity));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    if (!direct_) {
+        HAWKBIT_LOG_WARN("O_DIRECT not supported for %s - using buffered writes", device_.c_str());
+    }
+    buffered_ = 0;
+    offset_ = 0;
+    return true;
+}
+
+bool BlockDeviceSink::write(const char* data, size_t size) {
+    while (size > 0) {
+        size_t chunk = std::min(size, kBufferSize - buffered_);
+        std::memcpy(buffer_ + buffered_, data, chunk);
+        buffered_ += chunk;
+        data += chunk;
+        size -= chunk;
+        if (buffered_ == kBufferSize && !flush_buffer(kBufferSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief buffer_[0, size)를 offset_에 기록하고 남은 데이터를 앞으로 이동
+ *
+ * O_DIRECT에서는 size가 kAlignment 배수여야 합니다.
+ */
+bool BlockDeviceSink::flush_buffer(size_t size) {
+    if (!pwrite_fully(fd_, buffer_, size, offset_)) {
+        HAWKBIT_LOG_ERROR("Write to %s failed at offset %llu: %s", device_.c_str(),
+                          static_cast<unsigned long long>(offset_), std::strerror(errno));
+        return false;
+    }
+    offset_ += size;
+    std::memmove(buffer_, buffer_ + size, buffered_ - size);
+    buffered_ -= size;
+    return true;
+}
+
+bool BlockDeviceSink::finish() {
+    // 정렬된 부분은 O_DIRECT로, 나머지 꼬리는 O_DIRECT를 끄고 기록
+    size_t aligned = buffered_ - buffered_ % kAlignment;
+    bool ok = aligned == 0 || flush_buffer(aligned);
+    if (ok && buffered_ > 0) {
+        if (direct_) {
+            int flags = fcntl(fd_, F_GETFL);
+            fcntl(fd_, F_SETFL, flags & ~O_DIRECT);
+        }
+        ok = flush_buffer(buffered_);
+    }
+    // 재부팅 전에 slot 내용이 디스크에 반영되었음을 보장
+    ok = ok && fdatasync(fd_) == 0;
+    ok = ::close(fd_) == 0 && ok;
+    fd_ = -1;
+    if (!ok) {
+        HAWKBIT_LOG_ERROR("Failed to complete %s: %s", device_.c_str(), std::strerror(errno));
+    }
+    return ok;
+}
+
+void BlockDeviceSink::abort() {
+    // 부분 기록된 slot은 부팅 대상으로 표시되지 않으므로 닫기만 함
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    buffered_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// PipeSink / MemorySink
+// ---------------------------------------------------------------------------
+
+bool PipeSink::write(const char* data, size_t size) {
+    if (!write_fully(fd_, data, size)) {
+        HAWKBIT_LOG_ERROR("Write to fd %d failed: %s", fd_, std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool MemorySink::open(uint64_t expected_size) {
+    data_.clear();
+    if (expected_size > max_size_) {
+        HAWKBIT_LOG_ERROR("Artifact (%llu bytes) exceeds the memory sink limit (%zu bytes)",
+                          static_cast<unsigned long long>(expected_size), max_size_);
+        return false;
+    }
+    // 크기를 알면 한 번만 할당 (재할당/복사 없음)
+    data_.reserve(static_cast<size_t>(expected_size));
+    return true;
+}
+
+bool MemorySink::write(const char* data, size_t size) {
+    if (data_.size() + size > max_size_) {
+        return false;
+    }
+    data_.append(data, size);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// ProcessSink
+// ---------------------------------------------------------------------------
+
+ProcessSink::ProcessSink(const std::string& command)
+    : command_(command), pid_(-1), stdin_fd_(-1), bytes_written_(0),
+      blocked_(std::chrono::steady_clock::duration::zero()) {}
+
+ProcessSink::~ProcessSink() {
+    if (pid_ > 0) {
+        abort();
+    }
+}
+
+bool ProcessSink::open(uint64_t /*expected_size*/) {
+    ignore_sigpipe();
+
+    int fds[2];
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+        HAWKBIT_LOG_ERROR("pipe failed: %s", std::strerror(errno));
+        return false;
+    }
+    fcntl(fds[1], F_SETPIPE_SZ, kPipeBufferSize);
+
+    // 자식: 읽기 쪽을 stdin으로 (dup2된 fd 0은 CLOEXEC가 해제됨)
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[0], STDIN_FILENO);
+
+    // 자체 process group (pgid = pid): abort()가 sh의 자식까지 한 번에 종료
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    const char* argv[] = {"/bin/sh", "-c", command_.c_str(), nullptr};
+    int result = posix_spawn(&pid_, "/bin/sh", &actions, &attr, const_cast<char* const*>(argv), environ);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(fds[0]);
+
+    if (result != 0) {
+        HAWKBIT_LOG_ERROR("Failed to start install command '%s': %s", command_.c_str(), std::strerror(result));
+        ::close(fds[1]);
+        pid_ = -1;
+        return false;
+    }
+    stdin_fd_ = fds[1];
+    bytes_written_ = 0;
+    blocked_ = std::chrono::steady_clock::duration::zero();
+    return true;
+}
+
+bool ProcessSink::write(const char* data, size_t size) {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    if (!write_fully(stdin_fd_, data, size)) {
+        // EPIPE: 설치 명령이 입력을 다 받기 전에 종료됨
+        HAWKBIT_LOG_ERROR("Install command stopped reading: %s", std::strerror(errno));
+        return false;
+    }
+    bytes_written_ += size;
+    blocked_ += std::chrono::steady_clock::now() - started;
+    return true;
+}
+
+bool ProcessSink::finish() {
+    if (pid_ <= 0) {
+        return false;
+    }
+    // EOF 전달 후 설치 결과 대기
+    ::close(stdin_fd_);
+    stdin_fd_ = -1;
+    int status = wait_for_exit();
+    if (status != 0) {
+        HAWKBIT_LOG_ERROR("Install command failed (exit status %d)", status);
+        return false;
+    }
+    HAWKBIT_LOG_INFO("Install command finished: %llu bytes streamed, %lld ms waiting on the installer",
+                     static_cast<unsigned long long>(bytes_written_),
+                     static_cast<long long>(blocked_time().count()));
+    return true;
+}
+
+void ProcessSink::abort() {
+    if (pid_ <= 0) {
+        return;
+    }
+    // EOF보다 먼저 group 전체를 종료시켜 불완전한/검증 실패한 이미지가 설치 완료로
+    // 처리되지 않도록 함 - stdin은 모두 종료된 뒤에 닫음
+    kill(-pid_, SIGTERM);
+
+    // WNOWAIT: sh를 reap하지 않아 pgid가 재사용되지 않은 상태로 SIGKILL 가능
+    siginfo_t info;
+    for (int waited = 0; waited < kAbortGraceMs; waited += 50) {
+        info.si_pid = 0;
+        if (waitid(P_PID, static_cast<id_t>(pid_), &info, WEXITED | WNOHANG | WNOWAIT) != 0 || info.si_pid != 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    // SIGTERM을 무시한 명령이나 sh 종료 후 남은 자식 정리
+    kill(-pid_, SIGKILL);
+    wait_for_exit();
+
+    if (stdin_fd_ >= 0) {
+        ::close(stdin_fd_);
+        stdin_fd_ = -1;
+    }
+    HAWKBIT_LOG_WARN("Install command aborted after %llu bytes",
+                     static_cast<unsigned long long>(bytes_written_));
+}
+
+int ProcessSink::wait_for_exit() {
+    int status = 0;
+    pid_t result;
+    do {
+        result = waitpid(pid_, &status, 0);
+    } while (result < 0 && errno == EINTR);
+    pid_ = -1;
+    if (result < 0 || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+DecompressingSink::DecompressingSink(std::unique_ptr<DownloadSink> inner, ContentCoding coding)
+    : inner_(std::move(inner)),
+      decoder_(coding, [this](const char* data, size_t size) { return inner_->write(data, size); }) {
+}
+
+bool DecompressingSink::open(uint64_t /*expected_size*/) {
+    // expected_size는 압축된 크기 - 풀린 크기는 끝까지 받아야 알 수 있음
+    return decoder_.init() && inner_->open(0);
+}
+
+bool DecompressingSink::write(const char* data, size_t size) {
+    return decoder_.update(data, size);
+}
+
+bool DecompressingSink::finish() {
+    if (!decoder_.finished()) {
+        HAWKBIT_LOG_ERROR("Compressed artifact ended mid-stream after %llu bytes",
+                          static_cast<unsigned long long>(decoder_.bytes_in()));
+        inner_->abort();
+        return false;
+    }
+    HAWKBIT_LOG_INFO("Decompressed %s artifact: %llu -> %llu bytes", coding_name(decoder_.coding()),
+                     static_cast<unsigned long long>(decoder_.bytes_in()),
+                     static_cast<unsigned long long>(decoder_.bytes_out()));
+    return inner_->finish();
+}
+
+std::string DecompressingSink::describe() const {
+    return std::string(coding_name(decoder_.coding())) + " -> " + inner_->describe();
+}
@@ -0,0 +1,302 @@
+/**
+ * @file fleet_simulator.cpp
+ * @brief 가상 컨트롤러 fleet 실행 구현
+ *
+ * 동시성 규칙:
+ * - controllers_[i]는 dispatcher가 heap에서 꺼낸 뒤부터 finish_cycle()에서 다시
+ *   넣을 때까지 그 컨트롤러의 요청 callback(이벤트 루프 스레드)만 접근합니다.
+ * - due_, in_flight_, 집계 값은 mutex_로 보호합니다.
+ * - 종료 시점 이후에는 새 요청(다운로드/보고 포함)을 시작하지 않으므로 남은 요청만
+ *   끝나면 바로 결과를 낼 수 있습니다.
+ */
+#include "fleet_simulator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+
+namespace {
+
+/// 종료 후 진행 중인 요청을 기다리는 최대 시간
+const std::chrono::seconds kDrainTimeout(30);
+
+/** @brief prefix + 6자리 번호 (device000001) */
+std::string make_controller_id(const std::string& prefix, size_t number) {
+    char digits[32];
+    std::snprintf(digits, sizeof(digits), "%06zu", number);
+    return prefix + digits;
+}
+
+/** @brief 상태 보고용 UTC 시각 (ISO 8601) */
+std::string utc_timestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc;
+    gmtime_r(&now, &utc);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+void print_latency(std::ostream& out, const char* name, const LatencySummary& latency) {
+    out << "  " << std::left << std::setw(10) << name << std::right
+        << " n=" << latency.samples
+        << "  p50=" << latency.p50 << " ms"
+        << "  p90=" << latency.p90 << " ms"
+        << "  p99=" << latency.p99 << " ms"
+        << "  max=" << latency.max << " ms" << std::endl;
+}
+
+} // namespace
+
+void print_fleet_report(const FleetReport& report, std::ostream& out) {
+    std::ios::fmtflags flags = out.flags();
+    out << std::fixed << std::setprecision(1);
+    out << "Fleet report (" << report.controllers << " controllers, "
+        << report.elapsed_seconds << " s)" << std::endl;
+    out << "  polls      " << report.polls << " (" << report.polls_per_second() << "/s), "
+        << report.polls_not_modified << " not modified, "
+        << report.poll_failures << " failed" << std::endl;
+    out << "  downloads  " << report.downloads << " ok, " << report.download_failures << " failed, "
+        << report.download_bytes / (1024 * 1024) << " MiB ("
+        << report.download_mib_per_second() << " MiB/s)" << std::endl;
+    out << "  reports    " << report.reports << " ok, " << report.report_failures << " failed" << std::endl;
+    out << "  connections " << report.connections.new_connections << " new, "
+        << report.connections.reused_connections << " reused ("
+        << report.connections.requests << " requests)" << std::endl;
+    const HttpCompressionStats& compression = report.compression;
+    out << "  compression responses " << compression.response_body_bytes / 1024 << " -> "
+        << compression.response_wire_bytes / 1024 << " KiB (" << compression.compressed_responses << " of "
+        << compression.responses << " compressed), requests " << compression.request_body_bytes / 1024
+        << " -> " << compression.request_wire_bytes / 1024 << " KiB (" << compression.compressed_requests
+        << " compressed)" << std::endl;
+    out << "Latency (submit to completion):" << std::endl;
+    out << std::setprecision(2);
+    print_latency(out, "poll", report.poll_latency);
+    print_latency(out, "download", report.download_latency);
+    print_latency(out, "report", report.report_latency);
+    out.flags(flags);
+}
+
+FleetSimulator::FleetSimulator(const FleetOptions& options)
+    : options_(options), controllers_(options.controllers), in_flight_(0), stopping_(false),
+      downloaded_bytes_(0), engine_(options.max_connections) {
+    const std::string base = options_.server_url + "/rest/v1/ddi/v1/controller/device/";
+    for (size_t i = 0; i < controllers_.size(); ++i) {
+        controllers_[i].id = make_controller_id(options_.id_prefix, i + 1);
+        controllers_[i].poll_url = base + controllers_[i].id;
+    }
+}
+
+FleetReport FleetSimulator::run() {
+    Clock::time_point start = Clock::now();
+    Clock::time_point end = start + options_.duration;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    report_ = FleetReport();
+    report_.controllers = controllers_.size();
+    stopping_ = false;
+
+    // 첫 poll을 기본 polling 간격에 고르게 분산 (동시 시작 burst 방지)
+    if (!controllers_.empty()) {
+        Clock::duration spread = controllers_[0].scheduler.interval();
+        for (size_t i = 0; i < controllers_.size(); ++i) {
+            due_.push(Due(start + spread * i / controllers_.size(), i));
+        }
+    }
+
+    while (Clock::now() < end) {
+        if (due_.empty() || in_flight_ >= options_.max_in_flight) {
+            changed_.wait_until(lock, end);
+            continue;
+        }
+        Due next = due_.top();
+        if (next.first > Clock::now()) {
+            changed_.wait_until(lock, std::min(next.first, end));
+            continue;
+        }
+        due_.pop();
+        ++in_flight_;
+        lock.unlock();
+        start_poll(next.second);
+        lock.lock();
+    }
+
+    // 새 요청은 시작하지 않고 진행 중인 요청만 마무리
+    stopping_ = true;
+    changed_.wait_for(lock, kDrainTimeout, [this]() { return in_flight_ == 0; });
+    while (!due_.empty()) {
+        due_.pop();
+    }
+
+    FleetReport report = report_;
+    report.elapsed_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.download_bytes = downloaded_bytes_.load();
+    report.poll_latency = summarize(poll_ms_);
+    report.download_latency = summarize(download_ms_);
+    report.report_latency = summarize(report_ms_);
+    report.connections = engine_.connection_stats();
+    report.compression = engine_.compression_stats();
+    return report;
+}
+
+void FleetSimulator::start_poll(size_t index) {
+    Controller& controller = controllers_[index];
+
+    AsyncRequest request;
+    request.url = controller.poll_url;
+    request.timeout_seconds = 30;
+    request.accept_encoding = options_.accept_encoding;
+    if (!controller.etag.empty()) {
+        request.headers.push_back("If-None-Match: " + controller.etag);
+    }
+
+    Clock::time_point started = Clock::now();
+    engine_.submit(std::move(request), [this, index, started](HttpResponse& response) {
+        on_poll(index, started, response);
+    });
+}
+
+void FleetSimulator::on_poll(size_t index, Clock::time_point started, HttpResponse& response) {
+    Controller& controller = controllers_[index];
+    float latency = elapsed_ms(started);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        report_.polls++;
+        poll_ms_.push_back(latency);
+        if (response.status_code == 304) {
+            report_.polls_not_modified++;
+        } else if (response.status_code != 200) {
+            report_.poll_failures++;
+        }
+    }
+
+    if (response.status_code == 304) {
+        controller.scheduler.on_success();
+        finish_cycle(index);
+        return;
+    }
+    if (response.status_code != 200) {
+        controller.scheduler.on_failure();
+        finish_cycle(index);
+        return;
+    }
+
+    controller.scheduler.on_success();
+    controller.etag = response.headers.get(HttpHeaders::kETag);
+
+    // view_는 이벤트 루프 스레드에서만 사용 (모든 완료 callback이 같은 스레드)
+    if (parse_ddi_response(response.body, view_)) {
+        std::chrono::seconds interval;
+        if (!view_.polling_sleep.empty() && parse_polling_sleep(view_.polling_sleep, interval)) {
+            controller.scheduler.set_server_interval(interval);
+        }
+        if (view_.has_deployment && !stopping_) {
+            std::string action_id = ddi_unescape(view_.id);
+            if (action_id != controller.completed_action_id) {
+                controller.action_id = action_id;
+                if (options_.download_artifacts) {
+                    start_download(index, ddi_unescape(view_.primary_artifact()->href()));
+                } else {
+                    start_report(index, "SUCCESS");
+                }
+                return;
+            }
+        }
+    }
+    finish_cycle(index);
+}
+
+void FleetSimulator::start_download(size_t index, const std::string& url) {
+    AsyncRequest request;
+    request.url = url;
+    request.expected_status = 200;
+    request.on_data = [this](const char*, size_t size) {
+        downloaded_bytes_ += size;
+        return true;
+    };
+
+    Clock::time_point started = Clock::now();
+    engine_.submit(std::move(request), [this, index, started](HttpResponse& response) {
+        bool success = response.status_code == 200;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            download_ms_.push_back(elapsed_ms(started));
+            if (success) {
+                report_.downloads++;
+            } else {
+                report_.download_failures++;
+            }
+        }
+        if (stopping_) {
+            finish_cycle(index);
+            return;
+        }
+        start_report(index, success ? "SUCCESS" : "FAILURE");
+    });
+}
+
+void FleetSimulator::start_report(size_t index, const std::string& status) {
+    Controller& controller = controllers_[index];
+
+    AsyncRequest request;
+    request.url = controller.poll_url + "/deploymentBase/" + controller.action_id;
+    request.method = "POST";
+    request.body = "{\"id\":\"" + controller.action_id + "\",\"time\":\"" + utc_timestamp() +
+                   "\",\"status\":\"" + status + "\",\"details\":[]}";
+    request.headers.push_back("Content-Type: application/json");
+    request.timeout_seconds = 30;
+    request.accept_encoding = options_.accept_encoding;
+    request.compress_body = options_.compress_reports;
+
+    Clock::time_point started = Clock::now();
+    engine_.submit(std::move(request), [this, index, started](HttpResponse& response) {
+        Controller& controller = controllers_[index];
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            report_ms_.push_back(elapsed_ms(started));
+            if (response.status_code == 200) {
+                report_.reports++;
+            } else {
+                report_.report_failures++;
+            }
+        }
+        // 보고에 실패해도 같은 action을 반복 실행하지 않음 (HawkbitClient와 동일)
+        controller.completed_action_id = controller.action_id;
+        controller.scheduler.on_action_completed();
+        finish_cycle(index);
+    });
+}
+
+void FleetSimulator::finish_cycle(size_t index) {
+    Clock::time_point next = Clock::now() + controllers_[index].scheduler.next_delay();
+    std::lock_guard<std::mutex> lock(mutex_);
+    --in_flight_;
+    if (!stopping_) {
+        due_.push(Due(next, index));
+    }
+    changed_.notify_one();
+}
+
+LatencySummary FleetSimulator::summarize(std::vector<float>& samples_ms) {
+    LatencySummary summary;
+    summary.samples = samples_ms.size();
+    if (samples_ms.empty()) {
+        return summary;
+    }
+    std::sort(samples_ms.begin(), samples_ms.end());
+    // nearest-rank percentile
+    auto percentile = [&samples_ms](double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p * samples_ms.size()));
+        return static_cast<double>(samples_ms[rank > 0 ? rank - 1 : 0]);
+    };
+    summary.p50 = percentile(0.50);
+    summary.p90 = percentile(0.90);
+    summary.p99 = percentile(0.99);
+    summary.max = samples_ms.back();
+    return summary;
+}
+
+float FleetSimulator::elapsed_ms(Clock::time_point started) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - started).count();
+}
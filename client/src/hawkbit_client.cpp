@@ -3,29 +3,66 @@
  * @brief hawkBit DDI 클라이언트 로직 구현 파일
  *
  * English:
- * Implements the methods declared in `hawkbit_client.h` using a simple
- * string-based JSON parsing approach and a blocking polling loop.
+ * Implements the methods declared in `hawkbit_client.h` using the zero-copy
+ * DDI parser (`ddi_parser.h`) and a blocking polling loop.
  *
  * 한국어:
- * `hawkbit_client.h`에 선언된 메서드를 구현합니다. 간단한 문자열 기반 JSON 파싱과
- * 블로킹 폴링 루프를 사용합니다. 실제 제품에서는 신뢰성/유지보수를 위해 JSON 라이브러리
- * 사용(nlohmann/json 등)과 견고한 에러 처리, 비동기/스레드 설계가 권장됩니다.
+ * `hawkbit_client.h`에 선언된 메서드를 구현합니다. 할당 없는 DDI 파서(`ddi_parser.h`)와
+ * 블로킹 폴링 루프를 사용합니다.
  */
 #include "hawkbit_client.h"
-#include <iostream>
+#include "logger.h"
+#include "threaded_sink.h"
+#include <cstdio>
 #include <sstream>
 #include <thread>
 #include <chrono>
 #include <ctime>
 
+namespace {
+
+/// 이 크기 이상의 artifact는 여러 range로 나누어 병렬 다운로드
+const size_t kSegmentedDownloadThreshold = 8 * 1024 * 1024;
+
+/// HTTP/2 poll/상태 보고 stream weight (다운로드는 기본값 16) - 작은 요청이 먼저 전송됨
+const long kControlStreamWeight = 256;
+
+/** @brief 배포 limiter의 실제 속도와 제한 값 출력 (받은 것이 없으면 생략 - 캐시 hit 등) */
+void log_rate_stats(const char* label, const RateLimitStats& rate) {
+    if (rate.bytes == 0) {
+        return;
+    }
+    std::string cap = "unlimited";
+    if (rate.cap > 0) {
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.1f KiB/s (%.0f%% used)", rate.cap / 1024.0,
+                      100.0 * rate.achieved_rate() / rate.cap);
+        cap = text;
+    }
+    HAWKBIT_LOG_INFO("%s: %.1f KiB/s achieved, cap %s, enforcing %.1f KiB/s (%llu bytes in %.1f s, "
+                     "held back %.1f s)",
+                     label, rate.achieved_rate() / 1024.0, cap.c_str(), rate.rate / 1024.0,
+                     static_cast<unsigned long long>(rate.bytes), rate.elapsed_seconds, rate.throttled_seconds);
+    if (rate.rtt_samples > 0) {
+        HAWKBIT_LOG_INFO("%s: low priority, RTT base %.1f ms, current %.1f ms (%lu samples)", label,
+                         rate.base_rtt.count() / 1000.0, rate.current_rtt.count() / 1000.0, rate.rtt_samples);
+    }
+}
+
+} // namespace
+
 /**
  * @brief 생성자: 서버 URL과 컨트롤러 ID를 저장
  *
  * - 멤버 이니셜라이저 리스트를 사용하여 `server_url_`, `controller_id_` 초기화
- * - `http_client_`는 기본 생성자 사용
+ * - `http_client_`, `engine_`은 기본 생성자 사용
+ * - `segmented_downloader_`는 먼저 선언된 `engine_`을 참조
  */
-HawkbitClient::HawkbitClient(const std::string& server_url, const std::string& controller_id)
-    : server_url_(server_url), controller_id_(controller_id) {
+HawkbitClient::HawkbitClient(const std::string& server_url, const std::string& controller_id,
+                             HttpVersion http_version)
+    : server_url_(server_url), controller_id_(controller_id), engine_(0, http_version),
+      segmented_downloader_(engine_), has_cached_poll_(false), not_modified_polls_(0),
+      download_stats_(new DownloadStats()) {
 }
 
 /**
@@ -51,44 +88,32 @@ std::string HawkbitClient::build_status_url(const std::string& deployment_id) {
  * @brief 서버의 배포 응답(JSON 문자열)에서 핵심 필드 추출
  *
  * 반환값: 파싱된 `DeploymentInfo` (없으면 `has_deployment=false`).
- * 주의: 단순 문자열 탐색 기반 구현으로 포맷 변경에 취약합니다.
+ * DdiParser가 응답 버퍼를 그대로 가리키는 view를 만들고, 여기서는 첫 번째
+ * 다운로드 가능한 artifact만 소유 문자열로 복사합니다.
  */
 DeploymentInfo HawkbitClient::parse_deployment_response(const std::string& json_response) {
     DeploymentInfo deployment;
+    deployment.file_size = 0;
     deployment.has_deployment = false;
     
-    // Simple JSON parsing (in production, use a proper JSON library)
-    size_t deployment_pos = json_response.find("\"deploymentBase\"");
-    if (deployment_pos == std::string::npos) {
+    if (!parse_ddi_response(json_response, ddi_view_)) {
+        HAWKBIT_LOG_WARN("Malformed DDI response");
         return deployment;
     }
-    
-    // Extract deployment ID
-    size_t id_pos = json_response.find("\"id\":", deployment_pos);
-    if (id_pos != std::string::npos) {
-        size_t id_start = json_response.find("\"", id_pos + 5) + 1;
-        size_t id_end = json_response.find("\"", id_start);
-        deployment.id = json_response.substr(id_start, id_end - id_start);
-    }
-    
-    // Extract download URL
-    size_t href_pos = json_response.find("\"href\":");
-    if (href_pos != std::string::npos) {
-        size_t url_start = json_response.find("\"", href_pos + 7) + 1;
-        size_t url_end = json_response.find("\"", url_start);
-        deployment.download_url = json_response.substr(url_start, url_end - url_start);
-    }
-    
-    // Extract file size
-    size_t size_pos = json_response.find("\"size\":");
-    if (size_pos != std::string::npos) {
-        size_t size_start = size_pos + 7;
-        size_t size_end = json_response.find_first_of(",}", size_start);
-        std::string size_str = json_response.substr(size_start, size_end - size_start);
-        deployment.file_size = std::stoull(size_str);
+    if (!ddi_view_.has_deployment) {
+        return deployment;
     }
     
-    deployment.has_deployment = !deployment.id.empty() && !deployment.download_url.empty();
+    const DdiArtifact* artifact = ddi_view_.primary_artifact();
+    deployment.id = ddi_unescape(ddi_view_.id);
+    deployment.download_url = ddi_unescape(artifact->href());
+    deployment.file_size = static_cast<size_t>(artifact->size);
+    deployment.hashes.sha256 = ddi_unescape(artifact->hashes.sha256);
+    deployment.hashes.sha1 = ddi_unescape(artifact->hashes.sha1);
+    deployment.hashes.md5 = ddi_unescape(artifact->hashes.md5);
+    deployment.artifact_coding = coding_from_filename(artifact->filename);
+    deployment.forced = ddi_view_.download_type == "forced";
+    deployment.has_deployment = true;
     return deployment;
 }
 
@@ -98,15 +123,59 @@ DeploymentInfo HawkbitClient::parse_deployment_response(const std::string& json_
  * 반환값: 배포 정보 (`has_deployment`가 false면 업데이트 없음).
  */
 DeploymentInfo HawkbitClient::poll_for_updates() {
-    std::cout << "Polling for updates..." << std::endl;
+    HAWKBIT_LOG_INFO("Polling for updates...");
     
-    HttpResponse response = http_client_.get(build_polling_url());
+    // 이전 응답의 검증자를 보내 변경이 없으면 304로 body 전송/파싱 생략
+    std::vector<std::string> conditional_headers;
+    if (has_cached_poll_) {
+        if (!poll_etag_.empty()) {
+            conditional_headers.push_back("If-None-Match: " + poll_etag_);
+        }
+        if (!poll_last_modified_.empty()) {
+            conditional_headers.push_back("If-Modified-Since: " + poll_last_modified_);
+        }
+    }
     
-    if (response.status_code == 200) {
-        std::cout << "Poll response: " << response.body << std::endl;
-        return parse_deployment_response(response.body);
+    // 응답 객체를 재사용하여 body buffer 할당을 poll 사이에 유지
+    HttpResponse& response = poll_response_;
+    if (multiplexed()) {
+        AsyncRequest request;
+        request.url = build_polling_url();
+        request.headers = conditional_headers;
+        request.accept_encoding = compression_.accept_encoding;
+        response = send_multiplexed(std::move(request));
     } else {
-        std::cout << "Poll failed with status code: " << response.status_code << std::endl;
+        http_client_.get_into(build_polling_url(), response, conditional_headers);
+    }
+    
+    if (response.status_code == 304 && has_cached_poll_) {
+        ++not_modified_polls_;
+        HAWKBIT_LOG_INFO("Poll response not modified - reusing last deployment info");
+        poll_scheduler_.on_success();
+        return cached_deployment_;
+    } else if (response.status_code == 200) {
+        HAWKBIT_LOG_DEBUG("Poll response: %.*s", static_cast<int>(response.body.size()), response.body.data());
+        poll_scheduler_.on_success();
+        DeploymentInfo deployment = parse_deployment_response(response.body);
+        
+        // 서버가 지정한 polling 간격 (config.polling.sleep) 적용
+        std::chrono::seconds interval;
+        if (!ddi_view_.polling_sleep.empty() && parse_polling_sleep(ddi_view_.polling_sleep, interval) &&
+            interval != poll_scheduler_.interval()) {
+            poll_scheduler_.set_server_interval(interval);
+            HAWKBIT_LOG_INFO("Server polling interval: %lld s",
+                             static_cast<long long>(poll_scheduler_.interval().count()));
+        }
+        
+        // 다음 poll의 조건부 요청을 위해 검증자와 결과 보관
+        poll_etag_ = response.headers.get(HttpHeaders::kETag);
+        poll_last_modified_ = response.headers.get(HttpHeaders::kLastModified);
+        cached_deployment_ = deployment;
+        has_cached_poll_ = !poll_etag_.empty() || !poll_last_modified_.empty();
+        return deployment;
+    } else {
+        HAWKBIT_LOG_WARN("Poll failed with status code: %ld", response.status_code);
+        poll_scheduler_.on_failure();
         DeploymentInfo empty_deployment;
         empty_deployment.has_deployment = false;
         return empty_deployment;
@@ -119,27 +188,282 @@ DeploymentInfo HawkbitClient::poll_for_updates() {
  * 반환값: 성공 여부.
  */
 bool HawkbitClient::download_firmware(const DeploymentInfo& deployment, const std::string& local_path) {
-    std::cout << "Downloading firmware from: " << deployment.download_url << std::endl;
-    std::cout << "Expected file size: " << deployment.file_size << " bytes" << std::endl;
+    HAWKBIT_LOG_INFO("Downloading firmware from: %s (%zu bytes)",
+                     deployment.download_url.c_str(), deployment.file_size);
     
-    bool success = http_client_.download_file(deployment.download_url, local_path);
+    // 이어받기(resume)를 지원하는 백그라운드 경로를 그대로 사용하고 완료까지 대기
+    bool success = start_firmware_download(deployment, local_path).get();
     
     if (success) {
-        std::cout << "Firmware downloaded successfully to: " << local_path << std::endl;
+        HAWKBIT_LOG_INFO("Firmware downloaded successfully to: %s", local_path.c_str());
     } else {
-        std::cout << "Firmware download failed!" << std::endl;
+        HAWKBIT_LOG_ERROR("Firmware download failed!");
     }
     
     return success;
 }
 
+/**
+ * @brief 펌웨어 다운로드를 백그라운드에서 시작
+ *
+ * 반환값: 완료시 성공 여부를 전달하는 future.
+ */
+std::future<bool> HawkbitClient::start_firmware_download(const DeploymentInfo& deployment,
+                                                         const std::string& local_path) {
+    HAWKBIT_LOG_INFO("Starting background download from: %s (%zu bytes)",
+                     deployment.download_url.c_str(), deployment.file_size);
+    
+    if (deployment.hashes.empty()) {
+        HAWKBIT_LOG_WARN("No artifact hashes in deployment - skipping verification");
+    }
+    // 배포마다 limiter 하나: 병렬 range, delta range 등 이 배포의 전송이 모두 같은 제한을 나눠 씀
+    download_limiter_.reset();
+    RateLimitOptions rate_limit = rate_limit_;
+    if (deployment.forced) {
+        rate_limit.windows.clear();
+        rate_limit.low_priority = false;
+    }
+    if (rate_limit.enabled()) {
+        download_limiter_ = std::make_shared<RateLimiter>(rate_limit);
+    }
+    // 같은 해시의 artifact를 이미 받았으면 (rollback, 재할당) 네트워크를 쓰지 않음
+    if (cache_ && cache_->lookup(deployment.hashes, deployment.file_size)) {
+        return start_cached_install(deployment, local_path);
+    }
+    // gateway를 쓰면 다운로드 URL만 바꾸고 이후 경로(range, 이어받기, sink)는 그대로
+    std::string gateway_url;
+    if (!gateway_url_.empty()) {
+        gateway_url = ArtifactGateway::artifact_url(gateway_url_, deployment.download_url, deployment.file_size,
+                                                    deployment.hashes);
+    }
+    if (!gateway_url.empty()) {
+        HAWKBIT_LOG_INFO("Downloading through gateway %s", gateway_url_.c_str());
+        DeploymentInfo via_gateway = deployment;
+        via_gateway.download_url = gateway_url;
+        return start_direct_download(via_gateway, local_path, false);
+    }
+    return start_direct_download(deployment, local_path, delta_.enabled);
+}
+
+/**
+ * @brief 다운로드 방식 선택: delta, sink로 스트리밍, 압축 해제, 병렬 range
+ */
+std::future<bool> HawkbitClient::start_direct_download(const DeploymentInfo& deployment,
+                                                       const std::string& local_path, bool try_delta) {
+    // 압축 artifact는 chunk가 압축된 바이트 기준이라 seed와 맞지 않으므로 delta 대상 아님
+    if (try_delta && deployment.artifact_coding == ContentCoding::kIdentity) {
+        return start_delta_download(deployment, local_path);
+    }
+    if (sink_factory_) {
+        return start_streaming_install(deployment, sink_factory_());
+    }
+    // 압축을 풀면서 기록하면 파일 offset이 받은 바이트와 달라 range/이어받기를 쓸 수 없음
+    if (deployment.artifact_coding != ContentCoding::kIdentity || compression_.decode_downloads) {
+        return start_streaming_install(deployment,
+                                       std::unique_ptr<DownloadSink>(new FileSink(local_path, file_options_)));
+    }
+    
+    // 크기를 알면 저널 기반 이어받기 사용, 큰 artifact는 여러 range로 병렬 다운로드
+    // HTTP/2에서는 range들이 한 연결(한 TCP 혼잡 window)을 나눠 쓰므로 나누지 않음
+    size_t segments = 1;
+    if (deployment.file_size >= kSegmentedDownloadThreshold && !multiplexed()) {
+        segments = segmented_downloader_.segments();
+        HAWKBIT_LOG_INFO("Using %zu parallel range segments", segments);
+    }
+    std::future<bool> download = segmented_downloader_.download(deployment.download_url, local_path,
+                                                                deployment.file_size, segments,
+                                                                deployment.hashes, download_limiter_);
+    if (!cache_ || ArtifactCache::key(deployment.hashes).empty()) {
+        return download;
+    }
+    // range들이 순서 없이 기록되므로 sink로 함께 기록하지 않고 완료된 파일을 복사
+    std::shared_ptr<std::future<bool>> pending(new std::future<bool>(std::move(download)));
+    std::shared_ptr<ArtifactCache> cache = cache_;
+    ArtifactHashes hashes = deployment.hashes;
+    return std::async(std::launch::async, [pending, cache, hashes, local_path]() {
+        bool success = pending->get();
+        if (success) {
+            cache->insert_file(hashes, local_path);
+        }
+        return success;
+    });
+}
+
+/**
+ * @brief 받은 데이터를 sink(slot, 설치 명령 등)로 바로 전달 (임시 파일 없음)
+ *
+ * sink는 순차 스트림이므로 병렬 range/이어받기 대신 단일 연결로 받습니다.
+ * 전용 HttpClient를 쓰는 별도 스레드에서 실행되어, blocking write로 sink 속도에
+ * 맞춰 느려지더라도 polling 루프와 engine_의 다른 전송을 막지 않습니다.
+ * 압축 artifact는 DecompressingSink가 writer 스레드에서 풀므로 압축 해제 CPU 시간도
+ * 소켓 수신을 막지 않습니다.
+ */
+std::future<bool> HawkbitClient::start_streaming_install(const DeploymentInfo& deployment,
+                                                         std::unique_ptr<DownloadSink> sink) {
+    DecompressingSink* decoder = nullptr;
+    if (deployment.artifact_coding != ContentCoding::kIdentity) {
+        decoder = new DecompressingSink(std::move(sink), deployment.artifact_coding);
+        sink.reset(decoder);
+    }
+    // 캐시에는 받은 바이트(해시 대상) 그대로 - 압축 artifact도 압축된 채로 보관
+    if (cache_) {
+        sink.reset(new CachingSink(std::move(sink), cache_, deployment.hashes));
+    }
+    // 저장 장치/설치 명령의 지연은 writer 스레드의 버퍼 풀이 흡수
+    std::shared_ptr<DownloadSink> threaded(new ThreadedSink(std::move(sink)));
+    HAWKBIT_LOG_INFO("Streaming firmware into %s", threaded->describe().c_str());
+    std::string url = deployment.download_url;
+    ArtifactHashes hashes = deployment.hashes;
+    uint64_t size = deployment.file_size;
+    HttpCompressionOptions compression = compression_;
+    std::shared_ptr<DownloadStats> stats = download_stats_;
+    std::shared_ptr<RateLimiter> limiter = download_limiter_;
+    return std::async(std::launch::async, [url, threaded, decoder, hashes, size, compression, stats, limiter]() {
+        HttpClient client;
+        client.set_compression_options(compression);
+        client.set_rate_limiter(limiter);
+        bool success = client.download_to_sink(url, *threaded, hashes, size);
+        HttpCompressionStats download = client.compression_stats();
+        // .gz/.zst artifact: curl이 본 body는 압축된 그대로이므로 풀린 크기로 바꿔서 집계
+        // (decoder는 threaded가 소유하며 finish() 후에는 writer 스레드가 건드리지 않음)
+        if (decoder && success) {
+            download.compressed_downloads++;
+            download.download_body_bytes = decoder->bytes_out();
+        }
+        std::lock_guard<std::mutex> lock(stats->mutex);
+        stats->compression.add(download);
+        return success;
+    });
+}
+
+/**
+ * @brief chunk index를 받아 설치된 이미지와 다른 chunk만 내려받음
+ *
+ * 파일 다운로드는 이전에 받은 이미지(local_path)가 seed이므로 "<local_path>.delta"에
+ * 조립하고 검증이 끝난 뒤 rename합니다. index가 없는 서버면 같은 sink로 전체 다운로드하여
+ * delta를 지원하지 않는 서버와도 동작합니다.
+ */
+std::future<bool> HawkbitClient::start_delta_download(const DeploymentInfo& deployment,
+                                                      const std::string& local_path) {
+    DeltaOptions options = delta_;
+    std::string temp_path;
+    std::unique_ptr<DownloadSink> inner;
+    if (sink_factory_) {
+        inner = sink_factory_();
+    } else {
+        if (options.seed_path.empty()) {
+            options.seed_path = local_path;
+        }
+        temp_path = local_path + ".delta";
+        inner.reset(new FileSink(temp_path, file_options_));
+    }
+    if (cache_) {
+        inner.reset(new CachingSink(std::move(inner), cache_, deployment.hashes));
+    }
+    std::shared_ptr<DownloadSink> sink(new ThreadedSink(std::move(inner)));
+    std::string url = deployment.download_url;
+    ArtifactHashes hashes = deployment.hashes;
+    uint64_t size = deployment.file_size;
+    HttpCompressionOptions compression = compression_;
+    std::shared_ptr<RateLimiter> limiter = download_limiter_;
+    return std::async(std::launch::async, [url, sink, hashes, size, compression, options, temp_path,
+                                           local_path, limiter]() {
+        HttpClient client;
+        client.set_compression_options(compression);
+        client.set_rate_limiter(limiter);
+        DeltaUpdater updater(client, options);
+        ChunkIndex index;
+        bool success;
+        if (updater.fetch_index(DeltaUpdater::index_url(url), index) && (size == 0 || index.size == size)) {
+            HAWKBIT_LOG_INFO("Delta update into %s (%zu chunks)", sink->describe().c_str(), index.chunks.size());
+            success = updater.apply(url, index, *sink, hashes);
+        } else {
+            HAWKBIT_LOG_INFO("Delta update not available - downloading the whole artifact");
+            success = client.download_to_sink(url, *sink, hashes, size);
+        }
+        if (success && !temp_path.empty() && std::rename(temp_path.c_str(), local_path.c_str()) != 0) {
+            HAWKBIT_LOG_ERROR("Cannot move %s to %s", temp_path.c_str(), local_path.c_str());
+            success = false;
+        }
+        return success;
+    });
+}
+
+/**
+ * @brief 캐시에 있는 artifact를 local_path/sink로 복사 (다운로드 없음)
+ *
+ * 복사하면서 해시를 다시 확인하므로 저장 장치에서 손상된 항목은 설치되지 않습니다.
+ * 그 경우 항목이 삭제되고, 같은 대상으로 한 스트림 다운로드하면서 캐시를 다시 채웁니다.
+ */
+std::future<bool> HawkbitClient::start_cached_install(const DeploymentInfo& deployment,
+                                                      const std::string& local_path) {
+    DownloadSinkFactory factory = sink_factory_;
+    if (!factory) {
+        FileWriteOptions options = file_options_;
+        factory = [local_path, options]() {
+            return std::unique_ptr<DownloadSink>(new FileSink(local_path, options));
+        };
+    }
+    ContentCoding coding = deployment.artifact_coding;
+    std::shared_ptr<ArtifactCache> cache = cache_;
+    std::string url = deployment.download_url;
+    ArtifactHashes hashes = deployment.hashes;
+    uint64_t size = deployment.file_size;
+    HttpCompressionOptions compression = compression_;
+    std::shared_ptr<RateLimiter> limiter = download_limiter_;
+    return std::async(std::launch::async, [factory, coding, cache, url, hashes, size, compression, limiter]() {
+        std::unique_ptr<DownloadSink> sink = factory();
+        if (coding != ContentCoding::kIdentity) {
+            sink.reset(new DecompressingSink(std::move(sink), coding));
+        }
+        HAWKBIT_LOG_INFO("Installing cached artifact %s into %s", ArtifactCache::key(hashes).c_str(),
+                         sink->describe().c_str());
+        if (cache->deliver(hashes, size, *sink)) {
+            return true;
+        }
+        if (!cache->entry_path(hashes).empty()) {
+            return false;   // 캐시는 정상, 기록 대상이 실패
+        }
+        HAWKBIT_LOG_WARN("Cached artifact unusable - downloading it again");
+        sink = factory();
+        if (coding != ContentCoding::kIdentity) {
+            sink.reset(new DecompressingSink(std::move(sink), coding));
+        }
+        ThreadedSink threaded(std::unique_ptr<DownloadSink>(new CachingSink(std::move(sink), cache, hashes)));
+        HttpClient client;
+        client.set_compression_options(compression);
+        client.set_rate_limiter(limiter);
+        return client.download_to_sink(url, threaded, hashes, size);
+    });
+}
+
+void HawkbitClient::set_compression_options(const HttpCompressionOptions& options) {
+    compression_ = options;
+    http_client_.set_compression_options(options);
+}
+
+void HawkbitClient::set_file_write_options(const FileWriteOptions& options) {
+    file_options_ = options;
+    http_client_.set_file_write_options(options);
+    segmented_downloader_.set_file_write_options(options);
+}
+
+/**
+ * @brief HTTP/2 모드의 poll/상태 보고: 다운로드와 같은 연결에 높은 weight stream으로 전송
+ */
+HttpResponse HawkbitClient::send_multiplexed(AsyncRequest request) {
+    request.timeout_seconds = 30;
+    request.stream_weight = kControlStreamWeight;
+    return engine_.submit(std::move(request)).get();
+}
+
 /**
  * @brief 배포 결과 상태를 서버에 보고
  *
  * 반환값: 성공 여부.
  */
 bool HawkbitClient::report_status(const std::string& deployment_id, const std::string& status) {
-    std::cout << "Reporting status: " << status << " for deployment: " << deployment_id << std::endl;
+    HAWKBIT_LOG_INFO("Reporting status: %s for deployment: %s", status.c_str(), deployment_id.c_str());
     
     // Get current time
     auto now = std::chrono::system_clock::now();
@@ -156,15 +480,26 @@ bool HawkbitClient::report_status(const std::string& deployment_id, const std::s
                  << "\"details\":[]"
                  << "}";
     
-    HttpResponse response = http_client_.post(build_status_url(deployment_id), 
-                                             json_payload.str(), 
-                                             "application/json");
+    HttpResponse response;
+    if (multiplexed()) {
+        AsyncRequest request;
+        request.url = build_status_url(deployment_id);
+        request.method = "POST";
+        request.body = json_payload.str();
+        request.headers.push_back("Content-Type: application/json");
+        request.accept_encoding = compression_.accept_encoding;
+        request.compress_body = compression_.compress_requests &&
+                                request.body.size() >= compression_.min_request_size;
+        response = send_multiplexed(std::move(request));
+    } else {
+        response = http_client_.post(build_status_url(deployment_id), json_payload.str(), "application/json");
+    }
     
     if (response.status_code == 200) {
-        std::cout << "Status reported successfully" << std::endl;
+        HAWKBIT_LOG_INFO("Status reported successfully");
         return true;
     } else {
-        std::cout << "Status report failed with code: " << response.status_code << std::endl;
+        HAWKBIT_LOG_WARN("Status report failed with code: %ld", response.status_code);
         return false;
     }
 }
@@ -172,44 +507,131 @@ bool HawkbitClient::report_status(const std::string& deployment_id, const std::s
 /**
  * @brief 무한 폴링 루프 실행 (학습용 구현)
  *
- * 루프: poll → download → report → sleep(10s)
- * - 실제 환경에서는 종료 조건, 신호 처리, 백오프 전략 등을 추가하세요.
+ * 루프: poll → (백그라운드 download 시작) → PollScheduler가 정한 시간만큼 대기 → ...
+ * - 대기 시간은 서버의 config.polling.sleep (jitter 포함), 실패시 지수 백오프
+ * - 다운로드는 AsyncHttpEngine에서 진행되므로 그동안에도 polling과 보고가 계속됨
+ * - 다운로드가 끝나면 대기 중에 즉시 결과를 보고하고 바로 다시 poll
+ * - 실제 환경에서는 종료 조건, 신호 처리 등을 추가하세요.
  */
 void HawkbitClient::run_polling_loop() {
-    std::cout << "Starting hawkBit client polling loop..." << std::endl;
-    std::cout << "Controller ID: " << controller_id_ << std::endl;
-    std::cout << "Server URL: " << server_url_ << std::endl;
+    HAWKBIT_LOG_INFO("Starting hawkBit client polling loop...");
+    HAWKBIT_LOG_INFO("Controller ID: %s", controller_id_.c_str());
+    HAWKBIT_LOG_INFO("Server URL: %s", server_url_.c_str());
+    
+    const std::string firmware_path = "downloaded_firmware.bin";
     
     while (true) {
         try {
             DeploymentInfo deployment = poll_for_updates();
             
-            if (deployment.has_deployment) {
-                std::cout << "New deployment found: " << deployment.id << std::endl;
-                
-                // Download firmware
-                std::string firmware_path = "downloaded_firmware.bin";
-                bool download_success = download_firmware(deployment, firmware_path);
-                
-                // Report status
-                std::string status = download_success ? "SUCCESS" : "FAILURE";
-                report_status(deployment.id, status);
-                
-                if (download_success) {
-                    std::cout << "Firmware update completed successfully!" << std::endl;
+            if (deployment.has_deployment && deployment.id == completed_deployment_id_) {
+                // Result already reported - the server has not moved on yet
+                HAWKBIT_LOG_INFO("Deployment %s already processed", deployment.id.c_str());
+            } else if (deployment.has_deployment) {
+                if (pending_download_.valid()) {
+                    // Download still in flight - keep polling without restarting it
+                    HAWKBIT_LOG_INFO("Deployment %s is still downloading", pending_deployment_id_.c_str());
+                } else if (!deployment.forced && RateLimiter::blocked(rate_limit_, std::time(nullptr))) {
+                    // 다운로드 금지 시간대 - 배포는 서버에 그대로 남으므로 다음 poll에서 다시 확인
+                    HAWKBIT_LOG_INFO("Deployment %s deferred: downloads are blocked at this time of day",
+                                     deployment.id.c_str());
                 } else {
-                    std::cout << "Firmware update failed!" << std::endl;
+                    HAWKBIT_LOG_INFO("New deployment found: %s", deployment.id.c_str());
+                    
+                    // Download firmware in the background
+                    pending_deployment_id_ = deployment.id;
+                    pending_download_ = start_firmware_download(deployment, firmware_path);
+                    report_status(deployment.id, "RUNNING");
                 }
             } else {
-                std::cout << "No updates available" << std::endl;
+                HAWKBIT_LOG_INFO("No updates available");
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error in polling loop: " << e.what() << std::endl;
+            HAWKBIT_LOG_ERROR("Error in polling loop: %s", e.what());
+            poll_scheduler_.on_failure();
+        }
+        
+        // Wait for the scheduled poll, reporting a finished download right away
+        std::chrono::milliseconds delay = poll_scheduler_.next_delay();
+        if (poll_scheduler_.consecutive_failures() > 0) {
+            HAWKBIT_LOG_WARN("Poll failed %u time(s), backing off %lld ms",
+                             poll_scheduler_.consecutive_failures(), static_cast<long long>(delay.count()));
+        } else {
+            HAWKBIT_LOG_INFO("Waiting %lld ms before next poll...", static_cast<long long>(delay.count()));
         }
+        std::chrono::steady_clock::time_point next_poll = std::chrono::steady_clock::now() + delay;
         
-        // Wait 10 seconds before next poll
-        std::cout << "Waiting 10 seconds before next poll..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(10));
+        if (pending_download_.valid() &&
+            pending_download_.wait_until(next_poll) == std::future_status::ready) {
+            bool download_success = pending_download_.get();
+            if (download_limiter_) {
+                log_rate_stats("Download rate", download_limiter_->stats());
+                download_limiter_.reset();
+            }
+            
+            // Report status
+            std::string status = download_success ? "SUCCESS" : "FAILURE";
+            report_status(pending_deployment_id_, status);
+            completed_deployment_id_ = pending_deployment_id_;
+            
+            if (download_success) {
+                HAWKBIT_LOG_INFO("Firmware update completed successfully!");
+            } else {
+                HAWKBIT_LOG_ERROR("Firmware update failed!");
+            }
+            
+            // Action finished - ask the server for the next one right away
+            poll_scheduler_.on_action_completed();
+            next_poll = std::chrono::steady_clock::now() + poll_scheduler_.next_delay();
+        }
+        
+        // Connection reuse vs. new handshakes since start
+        const HttpConnectionStats& stats = http_client_.connection_stats();
+        HttpConnectionStats download_stats = engine_.connection_stats();
+        HAWKBIT_LOG_INFO("Connections: %lu reused, %lu new handshakes (%lu requests, %lu polls not modified), "
+                         "engine: %lu reused, %lu new (%lu over HTTP/2)",
+                         stats.reused_connections, stats.new_connections, stats.requests, not_modified_polls_,
+                         download_stats.reused_connections, download_stats.new_connections,
+                         download_stats.http2_requests);
+        
+        // poll/상태 보고 압축으로 줄어든 전송량 (HTTP/1.1 client와 엔진 합계)
+        HttpCompressionStats compression = http_client_.compression_stats();
+        compression.add(engine_.compression_stats());
+        {
+            std::lock_guard<std::mutex> lock(download_stats_->mutex);
+            compression.add(download_stats_->compression);
+        }
+        if (compression.compressed_responses > 0 || compression.compressed_requests > 0 ||
+            compression.compressed_downloads > 0) {
+            HAWKBIT_LOG_INFO("Compression: responses %llu -> %llu bytes (%lu compressed), "
+                             "requests %llu -> %llu bytes (%lu compressed), "
+                             "downloads %llu -> %llu bytes (%lu compressed), %lld bytes saved",
+                             static_cast<unsigned long long>(compression.response_body_bytes),
+                             static_cast<unsigned long long>(compression.response_wire_bytes),
+                             compression.compressed_responses,
+                             static_cast<unsigned long long>(compression.request_body_bytes),
+                             static_cast<unsigned long long>(compression.request_wire_bytes),
+                             compression.compressed_requests,
+                             static_cast<unsigned long long>(compression.download_body_bytes),
+                             static_cast<unsigned long long>(compression.download_wire_bytes),
+                             compression.compressed_downloads,
+                             static_cast<long long>(compression.saved_bytes()));
+        }
+        
+        if (cache_) {
+            ArtifactCacheStats cache = cache_->stats();
+            HAWKBIT_LOG_INFO("Artifact cache: %lu hits, %lu misses, %llu bytes saved, %zu entries (%llu bytes), "
+                             "%lu evictions",
+                             cache.hits, cache.misses, static_cast<unsigned long long>(cache.bytes_saved),
+                             cache.entries, static_cast<unsigned long long>(cache.bytes), cache.evictions);
+        }
+        
+        // 진행 중인 다운로드의 실제 속도 vs. 제한 값
+        if (download_limiter_) {
+            log_rate_stats("Download rate (in progress)", download_limiter_->stats());
+        }
+        
+        std::this_thread::sleep_until(next_poll);
     }
-}
\ No newline at end of file
+}
@@ -9,11 +9,96 @@
 
 // 헤더 파일 포함 - 클래스 선언부
 #include "http_client.h"
+#include "download_sink.h"
+#include "threaded_sink.h"
+#include "logger.h"
 // C 라이브러리 - HTTP 통신을 위한 libcurl
 #include <curl/curl.h>
-// 표준 라이브러리 - 콘솔 출력 및 파일 입출력
-#include <iostream>
-#include <fstream>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+
+/**
+ * @brief WriteSinkCallback에 전달되는 컨텍스트
+ */
+struct SinkWriteContext {
+    DownloadSink* sink;
+    StreamingHasher* hasher;
+    uint64_t bytes;         ///< sink로 넘긴 (디코딩된) 바이트 수
+    void* handle;
+    RateLimiter* limiter;   ///< nullptr: 속도 제한 없음
+    const int* socket;      ///< RTT sample 대상 (HttpClient::socket_, 연결 시 갱신됨)
+};
+
+/**
+ * @brief WriteCallback에 전달되는 컨텍스트
+ *
+ * handle은 첫 body 조각에서 Content-Length를 조회하는 데 사용합니다.
+ */
+struct BodyWriteContext {
+    void* handle;
+    std::string* body;
+    bool reserved;
+    RateLimiter* limiter;   ///< nullptr: 속도 제한 없음 (API 요청)
+    const int* socket;      ///< RTT sample 대상 (HttpClient::socket_, 연결 시 갱신됨)
+};
+
+/**
+ * @brief curl이 열어 두고 아직 닫지 않은 소켓 목록
+ *
+ * 연결은 multi handle의 풀(AsyncHttpEngine)에서 그 연결을 연 전송보다 오래 살 수 있으므로
+ * close callback은 전송/client를 가리킬 수 없음 - 닫힌 소켓(과 재사용된 fd 번호)은 이 목록으로 걸러냄.
+ * 종료 중 마지막 연결이 닫힐 때도 쓰이므로 해제하지 않음.
+ */
+struct OpenSockets {
+    std::mutex mutex;
+    std::unordered_set<curl_socket_t> sockets;
+};
+
+OpenSockets& open_sockets() {
+    static OpenSockets* sockets = new OpenSockets();
+    return *sockets;
+}
+
+/**
+ * @brief 새 연결의 소켓을 만들고 clientp(HttpClient::socket_ 또는 전송별 socket)에 기록
+ */
+curl_socket_t OpenSocketCallback(void* clientp, curlsocktype purpose, curl_sockaddr* address) {
+    (void)purpose;
+    curl_socket_t socket = ::socket(address->family, address->socktype | SOCK_CLOEXEC, address->protocol);
+    if (socket != CURL_SOCKET_BAD) {
+        OpenSockets& registry = open_sockets();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.sockets.insert(socket);
+        *static_cast<int*>(clientp) = socket;
+    }
+    return socket;
+}
+
+int CloseSocketCallback(void* clientp, curl_socket_t socket) {
+    (void)clientp;
+    {
+        OpenSockets& registry = open_sockets();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.sockets.erase(socket);
+    }
+    return close(socket);
+}
+
+/// Content-Length로 미리 예약할 최대 크기 - 잘못된 header로 큰 메모리를 잡지 않도록 제한
+const curl_off_t kMaxBodyReserve = 16 * 1024 * 1024;
+
+} // namespace
+
+void HttpResponse::clear() {
+    status_code = 0;
+    body.clear();
+    headers.clear();
+}
 
 /**
  * @brief HttpClient 생성자 - curl 리소스 초기화
@@ -21,7 +106,7 @@
  * RAII 패턴의 핵심: 생성자에서 모든 필요한 리소스를 획득합니다.
  * 
  * curl 초기화 과정:
- * 1. curl_global_init(): 전역 curl 라이브러리 초기화
+ * 1. CurlGlobal::acquire(): 전역 curl 라이브러리 초기화 (프로세스에서 처음 한 번만)
  * 2. curl_easy_init(): 이 인스턴스만의 curl handle 생성
  * 
  * CURL_GLOBAL_DEFAULT는 다음을 포함합니다:
@@ -33,13 +118,18 @@
  * - 생성자에서 예외 발생시 자동으로 이미 생성된 멤버들의 소멸자 호출
  * - 리소스 누수 방지를 위한 RAII 패턴 적용
  */
-HttpClient::HttpClient() {
-    // 전역 curl 라이브러리 초기화 (thread-safe하지 않으므로 주의 필요)
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+HttpClient::HttpClient(bool persistent_connections, bool shared_caches)
+    : persistent_(persistent_connections), curl_global_(CurlGlobal::acquire()),
+      shared_caches_(shared_caches), socket_(-1) {
     
     // 이 인스턴스용 curl easy handle 생성
     // 실패시 nullptr 반환, 성공시 유효한 포인터 반환
     curl_handle = curl_easy_init();
+
+    // 연결 유지 모드에서는 정적 옵션을 한 번만 설정
+    if (curl_handle && persistent_) {
+        apply_static_options();
+    }
 }
 
 /**
@@ -49,7 +139,7 @@ HttpClient::HttpClient() {
  * 
  * 정리 순서:
  * 1. curl easy handle 정리 (생성의 역순)
- * 2. 전역 curl 라이브러리 정리
+ * 2. curl_global_ 참조 해제 (마지막 참조일 때만 전역 curl 라이브러리 정리)
  * 
  * 안전 장치:
  * - curl_handle이 nullptr인지 확인 후 정리
@@ -64,11 +154,7 @@ HttpClient::~HttpClient() {
     if (curl_handle) {
         curl_easy_cleanup(curl_handle);
     }
-    
-    // 전역 curl 라이브러리 정리
-    // 주의: 다른 curl 인스턴스가 있다면 문제가 될 수 있음
-    // 실제 프로덕션에서는 reference counting 등의 기법 필요
-    curl_global_cleanup();
+    // curl_global_은 멤버 소멸 순서에 따라 easy handle 정리 후 해제됨
 }
 
 /**
@@ -77,7 +163,7 @@ HttpClient::~HttpClient() {
  * @param contents curl이 전달하는 데이터 버퍼
  * @param size 각 데이터 요소의 크기 (보통 1)
  * @param nmemb 데이터 요소의 개수 (실제 바이트 수)
- * @param userp 사용자 포인터 (std::string*로 캐스팅됨)
+ * @param userp 사용자 포인터 (BodyWriteContext*로 캐스팅됨)
  * @return 처리한 바이트 수 (size * nmemb와 같아야 함)
  * 
  * Static 함수인 이유:
@@ -87,9 +173,10 @@ HttpClient::~HttpClient() {
  * 
  * 동작 방식:
  * 1. 실제 데이터 크기 계산 (size * nmemb)
- * 2. userp를 std::string* 타입으로 캐스팅
- * 3. 받은 데이터를 string에 추가 (append)
- * 4. 처리한 바이트 수 반환 (성공 표시)
+ * 2. userp를 BodyWriteContext* 타입으로 캐스팅
+ * 3. 첫 조각이면 Content-Length만큼 body 용량 예약 (재할당 방지)
+ * 4. 받은 데이터를 string에 추가 (append)
+ * 5. 처리한 바이트 수 반환 (성공 표시)
  * 
  * 메모리 안전성:
  * - static_cast로 안전한 타입 변환
@@ -100,26 +187,56 @@ size_t HttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, void
     // 실제 데이터 크기 계산
     size_t realsize = size * nmemb;
     
-    // userp를 std::string 포인터로 안전하게 캐스팅
-    // 이 포인터는 HTTP 응답 body를 저장할 string 객체를 가리킴
-    std::string* response = static_cast<std::string*>(userp);
+    // userp는 HTTP 응답 body를 저장할 string과 curl handle을 담은 컨텍스트
+    BodyWriteContext* context = static_cast<BodyWriteContext*>(userp);
+    
+    // 첫 조각 도착 시점에는 header가 모두 처리되어 Content-Length를 알 수 있음
+    if (!context->reserved) {
+        reserve_body(context->handle, *context->body);
+        context->reserved = true;
+    }
     
     // 받은 데이터를 string 끝에 추가
-    // append()는 메모리를 자동으로 확장하므로 안전함
-    response->append(static_cast<char*>(contents), realsize);
+    // 예약된 용량 안에서는 재할당 없이 복사만 수행
+    context->body->append(static_cast<char*>(contents), realsize);
+    
+    // 속도 제한: 빚을 갚을 때까지 curl이 소켓을 읽지 않도록 여기서 대기
+    if (context->limiter) {
+        sample_rtt(context->handle, *context->socket, *context->limiter);
+        context->limiter->throttle(realsize);
+    }
     
     // curl에게 모든 데이터를 처리했음을 알림
     // 반환값이 realsize와 다르면 curl은 전송을 중단함
     return realsize;
 }
 
+/**
+ * @brief Content-Length만큼 body 용량을 미리 확보
+ *
+ * append()만으로 키우면 큰 응답은 용량을 두 배씩 늘리며 여러 번 재할당/복사됩니다.
+ * 길이를 모르는 응답(chunked, -1)과 상한을 넘는 값은 무시하고 기존 방식으로 키웁니다.
+ * 재사용 buffer의 용량이 이미 충분하면 아무것도 하지 않습니다.
+ */
+void HttpClient::reserve_body(void* handle, std::string& body) {
+    curl_off_t length = -1;
+    if (curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) != CURLE_OK ||
+        length <= 0 || length > kMaxBodyReserve) {
+        return;
+    }
+    size_t wanted = body.size() + static_cast<size_t>(length);
+    if (body.capacity() < wanted) {
+        body.reserve(wanted);
+    }
+}
+
 /**
  * @brief HTTP 응답 header를 파싱하는 static callback 함수
  * 
  * @param buffer curl이 전달하는 header 라인 버퍼
  * @param size 각 문자의 크기 (항상 1)
  * @param nitems header 라인의 문자 수
- * @param userdata 사용자 포인터 (std::map*로 캐스팅됨)
+ * @param userdata 사용자 포인터 (HttpHeaders*로 캐스팅됨, nullptr이면 버림)
  * @return 처리한 바이트 수
  * 
  * HTTP Header 형식:
@@ -127,53 +244,24 @@ size_t HttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, void
  * - 각 header는 별도의 라인으로 전달됨
  * - 마지막에 \r\n (CRLF) 포함
  * 
- * 파싱 과정:
- * 1. header 라인을 string으로 변환
- * 2. ':' 문자 위치 찾기 (key/value 구분자)
- * 3. key 부분 추출 (colon 앞)
- * 4. value 부분 추출 (colon 뒤, 공백 제거)
- * 5. CRLF 문자들 제거
- * 6. map에 key-value 쌍으로 저장
+ * 파싱 과정 (HttpHeaders::add_line):
+ * 1. ':' 위치로 key/value 구분 (임시 문자열 없이 포인터로 자름)
+ * 2. 앞뒤 공백과 CRLF 제거
+ * 3. header arena에 이름과 값을 이어 붙이고 offset 기록
  * 
  * 에러 처리:
- * - colon이 없는 라인은 무시 (status line 등)
+ * - status line은 새 응답 블록의 시작 (redirect 이전 header 삭제)
+ * - colon이 없는 라인은 무시
  * - 빈 값도 허용
- * - \r\n 문자 자동 제거
  */
 size_t HttpClient::HeaderCallback(char* buffer, size_t size, size_t nitems, void* userdata) {
     // 실제 header 라인 크기 계산
     size_t realsize = size * nitems;
     
-    // userdata를 header map 포인터로 캐스팅
-    std::map<std::string, std::string>* headers = 
-        static_cast<std::map<std::string, std::string>*>(userdata);
-    
-    // buffer를 std::string으로 변환 (안전한 문자열 처리를 위해)
-    std::string header(buffer, realsize);
-    
-    // ':' 문자 위치 찾기 (header key와 value의 구분자)
-    size_t colon_pos = header.find(':');
-    
-    if (colon_pos != std::string::npos) {
-        // Key 부분 추출 (colon 앞부분)
-        std::string key = header.substr(0, colon_pos);
-        
-        // Value 부분 추출 (colon 뒤부분, +2는 ": " 건너뛰기)
-        std::string value = header.substr(colon_pos + 2);
-        
-        // 줄바꿈 문자 제거 (\n)
-        if (!value.empty() && value.back() == '\n') {
-            value.pop_back();
-        }
-        
-        // 캐리지 리턴 문자 제거 (\r)
-        if (!value.empty() && value.back() == '\r') {
-            value.pop_back();
-        }
-        
-        // map에 key-value 쌍 저장
-        // operator[]는 새 key 삽입 또는 기존 value 업데이트
-        (*headers)[key] = value;
+    // header를 저장하지 않는 요청 (예: 파일 다운로드)은 userdata가 nullptr
+    HttpHeaders* headers = static_cast<HttpHeaders*>(userdata);
+    if (headers) {
+        headers->add_line(buffer, realsize);
     }
     
     // curl에게 header 라인을 성공적으로 처리했음을 알림
@@ -181,46 +269,184 @@ size_t HttpClient::HeaderCallback(char* buffer, size_t size, size_t nitems, void
 }
 
 /**
- * @brief 파일 다운로드를 위한 static callback 함수
- * 
- * @param contents curl이 전달하는 파일 데이터 버퍼
- * @param size 각 데이터 요소의 크기
- * @param nmemb 데이터 요소의 개수
- * @param userp 사용자 포인터 (std::ofstream*로 캐스팅됨)
- * @return 파일에 쓴 바이트 수
- * 
- * 스트리밍 다운로드:
- * - 받은 데이터를 즉시 파일에 기록
- * - 메모리에 전체 파일을 로드하지 않음
- * - 대용량 파일 다운로드에 적합
- * - 메모리 제약이 있는 IoT 기기에 필수적
- * 
- * 장점:
- * - 메모리 사용량 최소화
- * - 네트워크 중단시 부분 다운로드 보존 가능
- * - 실시간 처리 가능 (압축 해제 등)
- * 
- * 주의사항:
- * - 파일이 열려있는지 미리 확인 필요
- * - 디스크 공간 부족시 에러 처리 필요
- * - 파일 권한 확인 필요
+ * @brief 받은 데이터를 DownloadSink로 전달하는 정적 콜백
+ *
+ * sink.write()가 대기하는 동안 curl은 소켓을 읽지 않으므로 설치 속도에 맞춰
+ * 전송이 느려집니다 (backpressure). sink가 거부하면 0을 반환하여 전송을 중단합니다.
  */
-size_t HttpClient::WriteFileCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    // 실제 데이터 크기 계산
+size_t HttpClient::WriteSinkCallback(void* contents, size_t size, size_t nmemb, void* userp) {
     size_t realsize = size * nmemb;
+    SinkWriteContext* context = static_cast<SinkWriteContext*>(userp);
     
-    // userp를 파일 스트림 포인터로 캐스팅
-    std::ofstream* file = static_cast<std::ofstream*>(userp);
-    
-    // 받은 데이터를 파일에 직접 기록
-    // binary 모드로 열린 파일이므로 데이터 변환 없이 그대로 쓰기
-    file->write(static_cast<char*>(contents), realsize);
-    
-    // 실제 쓴 바이트 수 반환
-    // 파일 쓰기 실패시 실제 쓴 크기와 다를 수 있음
+    context->bytes += realsize;
+    if (context->hasher) {
+        context->hasher->update(contents, realsize);
+    }
+    if (!context->sink->write(static_cast<const char*>(contents), realsize)) {
+        return 0;
+    }
+    if (context->limiter) {
+        sample_rtt(context->handle, *context->socket, *context->limiter);
+        context->limiter->throttle(realsize);
+    }
     return realsize;
 }
 
+/**
+ * @brief 이 handle이 여는 연결의 소켓을 socket에 기록하도록 설정
+ */
+void HttpClient::track_sockets(void* handle, int* socket) {
+    curl_easy_setopt(handle, CURLOPT_OPENSOCKETFUNCTION, OpenSocketCallback);
+    curl_easy_setopt(handle, CURLOPT_OPENSOCKETDATA, socket);
+    curl_easy_setopt(handle, CURLOPT_CLOSESOCKETFUNCTION, CloseSocketCallback);
+}
+
+/**
+ * @brief 저우선순위 limiter가 요청할 때만 연결 소켓의 RTT를 전달
+ *
+ * 기록된 소켓이 아직 열려 있고 현재 전송의 local port와 같을 때만 사용합니다
+ * (기록 이후 다른 연결로 바뀌었으면 sample을 건너뜀).
+ */
+void HttpClient::sample_rtt(void* handle, int socket, RateLimiter& limiter) {
+    if (socket < 0 || !limiter.wants_rtt_sample()) {
+        return;
+    }
+    long local_port = 0;
+    if (curl_easy_getinfo(handle, CURLINFO_LOCAL_PORT, &local_port) != CURLE_OK || local_port <= 0) {
+        return;
+    }
+    // 확인하는 동안 curl이 소켓을 닫고 fd 번호가 재사용되지 않도록 잠금을 유지
+    OpenSockets& registry = open_sockets();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    sockaddr_storage address = {};
+    socklen_t length = sizeof(address);
+    if (registry.sockets.count(socket) == 0 ||
+        getsockname(socket, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return;
+    }
+    unsigned short port = 0;
+    if (address.ss_family == AF_INET) {
+        port = ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+    } else if (address.ss_family == AF_INET6) {
+        port = ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+    }
+    if (port == local_port) {
+        limiter.sample_socket(socket);
+    }
+}
+
+/**
+ * @brief 모든 요청에 공통인 정적 옵션 설정
+ *
+ * 연결 유지 모드에서는 생성자에서 한 번만 호출되고, 이후 요청들은
+ * 이 설정을 그대로 재사용합니다.
+ *
+ * 설정 항목:
+ * - HTTP redirect 자동 처리
+ * - 저속 전송 감지: 60초 동안 1 byte/s 미만이면 중단 (전체 timeout 대신 사용)
+ * - TCP keep-alive: NAT/방화벽이 idle 연결을 끊지 않도록 probe 전송
+ * - DNS 캐시 수명 연장 (기본 60초 → 10분)
+ * - 캐시된 연결의 최대 유휴 시간 연장 (polling 간격보다 길게)
+ * - header callback (모든 요청에서 동일)
+ */
+void HttpClient::apply_static_options() {
+    curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_LOW_SPEED_TIME, 60L);
+    curl_easy_setopt(curl_handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPIDLE, 60L);
+    curl_easy_setopt(curl_handle, CURLOPT_TCP_KEEPINTVL, 30L);
+    curl_easy_setopt(curl_handle, CURLOPT_DNS_CACHE_TIMEOUT, 600L);
+    curl_easy_setopt(curl_handle, CURLOPT_MAXAGE_CONN, 600L);
+    curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    // 저우선순위 RTT sample용으로 연결 소켓을 기록
+    track_sockets(curl_handle, &socket_);
+    // 비연결 유지 모드는 매 요청 새 handshake가 목적이므로 공유하지 않음
+    // (share는 DNS/TLS session만 - 연결 캐시는 이 handle의 것을 사용)
+    if (persistent_ && shared_caches_ && curl_global_->share_handle()) {
+        curl_easy_setopt(curl_handle, CURLOPT_SHARE, curl_global_->share_handle());
+    }
+}
+
+/**
+ * @brief 새 요청을 위해 curl handle 준비
+ *
+ * 연결 유지 모드:
+ * - curl_easy_reset()을 호출하지 않으므로 연결/DNS/TLS session 캐시와
+ *   정적 옵션이 그대로 유지됨
+ * - 요청마다 바뀌는 옵션(URL, method, 추가 header)만 교체
+ *
+ * 비연결 유지 모드:
+ * - 모든 설정을 리셋하고 매 요청마다 새 연결을 강제 (기존 동작과 동일한 비용)
+ */
+void HttpClient::prepare_request(const std::string& url) {
+    if (!persistent_) {
+        curl_easy_reset(curl_handle);
+        apply_static_options();
+        curl_easy_setopt(curl_handle, CURLOPT_FRESH_CONNECT, 1L);
+        curl_easy_setopt(curl_handle, CURLOPT_FORBID_REUSE, 1L);
+    }
+
+    // 이전 요청이 POST였을 수 있으므로 method와 추가 header를 기본값으로 되돌림
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPGET, 1L);
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, nullptr);
+    curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
+    // 압축 협상은 get()/post()만 다시 켬 - 다운로드는 artifact 원본 바이트 그대로 받음
+    curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING, nullptr);
+    curl_easy_setopt(curl_handle, CURLOPT_RANGE, nullptr);
+    
+    // 요청 timeout 설정 (30초)
+    // IoT 환경에서는 네트워크가 불안정할 수 있으므로 timeout 필수
+    // (파일 다운로드는 요청별로 해제하고 저속 전송 감지에 맡김)
+    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);
+}
+
+/**
+ * @brief 준비된 요청을 실행하고 연결 재사용 통계 갱신
+ *
+ * CURLINFO_NUM_CONNECTS는 이번 전송을 위해 새로 맺은 연결 수를 반환합니다.
+ * 0이면 캐시된 연결을 재사용한 것입니다.
+ */
+int HttpClient::perform_request() {
+    CURLcode res = curl_easy_perform(curl_handle);
+
+    long connects = 0;
+    curl_easy_getinfo(curl_handle, CURLINFO_NUM_CONNECTS, &connects);
+    stats_.requests++;
+    if (connects > 0) {
+        stats_.new_connections++;
+    } else if (res == CURLE_OK) {
+        stats_.reused_connections++;
+    }
+    long version = 0;
+    curl_easy_getinfo(curl_handle, CURLINFO_HTTP_VERSION, &version);
+    if (version == CURL_HTTP_VERSION_2_0) {
+        stats_.http2_requests++;
+    }
+
+    return res;
+}
+
+/**
+ * @brief 응답 body의 수신 크기와 디코딩 후 크기를 압축 통계에 누적
+ *
+ * CURLINFO_SIZE_DOWNLOAD_T는 content coding을 풀기 전, 실제로 받은 body 바이트 수입니다.
+ */
+void HttpClient::record_response_size(const HttpResponse& response) {
+    curl_off_t wire_bytes = 0;
+    curl_easy_getinfo(curl_handle, CURLINFO_SIZE_DOWNLOAD_T, &wire_bytes);
+    if (response.body.empty() && wire_bytes == 0) {
+        return;
+    }
+    compression_stats_.responses++;
+    compression_stats_.response_wire_bytes += static_cast<uint64_t>(wire_bytes);
+    compression_stats_.response_body_bytes += response.body.size();
+    if (is_content_encoded(response.headers.get(HttpHeaders::kContentEncoding))) {
+        compression_stats_.compressed_responses++;
+    }
+}
+
 /**
  * @brief HTTP GET 요청을 수행하는 메서드
  * 
@@ -240,58 +466,107 @@ size_t HttpClient::WriteFileCallback(void* contents, size_t size, size_t nmemb,
  * 
  * curl 설정 순서:
  * 1. curl handle 초기화 확인
- * 2. 이전 설정 리셋 (clean state)
+ * 2. 요청별 옵션만 교체 (연결 유지 모드에서는 리셋하지 않음)
  * 3. 필요한 옵션들 설정
  * 4. 요청 실행
  * 5. 결과 확인 및 반환
  */
-HttpResponse HttpClient::get(const std::string& url) {
+HttpResponse HttpClient::get(const std::string& url, const std::vector<std::string>& extra_headers) {
     // 응답 데이터를 저장할 구조체 초기화
     HttpResponse response;
+    get_into(url, response, extra_headers);
+    
+    // 응답 구조체 반환 (move semantics로 효율적)
+    return response;
+}
+
+/**
+ * @brief 호출자가 유지하는 HttpResponse로 GET 요청 수행
+ *
+ * response.clear()는 body 용량을 유지하므로, polling loop가 같은 객체를 계속 넘기면
+ * body buffer를 매번 새로 할당하지 않습니다.
+ */
+void HttpClient::get_into(const std::string& url, HttpResponse& response,
+                          const std::vector<std::string>& extra_headers) {
+    response.clear();
     
     // curl handle 유효성 검사 (생성자에서 실패했을 가능성)
     if (!curl_handle) {
         response.status_code = 0;  // 0은 curl 에러를 의미
-        return response;
+        return;
     }
     
-    // 이전 설정을 모두 리셋 (clean state 보장)
-    // 이는 이전 요청의 설정이 현재 요청에 영향주는 것을 방지
-    curl_easy_reset(curl_handle);
+    // 요청별 옵션 준비 (URL, GET method)
+    // redirect, timeout, keep-alive 등 정적 옵션은 apply_static_options()에서 설정됨
+    prepare_request(url);
     
-    // 요청할 URL 설정
-    curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
+    // 조건부 요청 등 추가 header (없으면 nullptr 유지)
+    struct curl_slist* headers = nullptr;
+    for (size_t i = 0; i < extra_headers.size(); ++i) {
+        headers = curl_slist_append(headers, extra_headers[i].c_str());
+    }
+    if (headers) {
+        curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
+    }
+    
+    // gzip/deflate/br/zstd 중 빌드된 coding을 모두 제안, 응답은 curl이 스트리밍으로 풀어 전달
+    if (compression_.accept_encoding) {
+        curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING, "");
+    }
     
     // 응답 body를 처리할 callback 함수 설정
+    BodyWriteContext body_context = {curl_handle, &response.body, false, nullptr, nullptr};
     curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &body_context);
     
-    // HTTP header를 처리할 callback 함수 설정
-    curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    // HTTP header를 저장할 map 설정 (callback 함수는 정적 옵션)
     curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, &response.headers);
     
-    // HTTP redirect 자동 처리 (3xx 응답시 Location header 따라가기)
-    curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
-    
-    // 요청 timeout 설정 (30초)
-    // IoT 환경에서는 네트워크가 불안정할 수 있으므로 timeout 필수
-    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);
-    
     // HTTP 요청 실행
-    CURLcode res = curl_easy_perform(curl_handle);
+    CURLcode res = static_cast<CURLcode>(perform_request());
     
     // 요청 결과 확인
     if (res == CURLE_OK) {
         // 성공시 HTTP status code 추출
         curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response.status_code);
+        record_response_size(response);
     } else {
         // 실패시 에러 처리
         response.status_code = 0;
-        std::cerr << "cURL GET 에러: " << curl_easy_strerror(res) << std::endl;
+        HAWKBIT_LOG_ERROR("cURL GET 에러: %s", curl_easy_strerror(res));
     }
     
-    // 응답 구조체 반환 (move semantics로 효율적)
-    return response;
+    // slist는 여기서 해제되므로 handle에 남은 포인터 제거
+    if (headers) {
+        curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, nullptr);
+        curl_slist_free_all(headers);
+    }
+}
+
+void HttpClient::get_range_into(const std::string& url, uint64_t first, uint64_t last, HttpResponse& response) {
+    response.clear();
+    if (!curl_handle) {
+        return;
+    }
+    
+    prepare_request(url);
+    std::string range = std::to_string(first) + "-" + std::to_string(last);
+    curl_easy_setopt(curl_handle, CURLOPT_RANGE, range.c_str());
+    // 큰 range는 느린 링크에서 30초를 넘길 수 있음 - 저속 전송 감지에 맡김
+    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 0L);
+    
+    BodyWriteContext body_context = {curl_handle, &response.body, false, rate_limiter_.get(), &socket_};
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &body_context);
+    curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, &response.headers);
+    
+    CURLcode res = static_cast<CURLcode>(perform_request());
+    if (res == CURLE_OK) {
+        curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response.status_code);
+    } else {
+        response.status_code = 0;
+        HAWKBIT_LOG_ERROR("Range request %s failed: %s", range.c_str(), curl_easy_strerror(res));
+    }
 }
 
 HttpResponse HttpClient::post(const std::string& url, const std::string& data, 
@@ -303,65 +578,119 @@ HttpResponse HttpClient::post(const std::string& url, const std::string& data,
         return response;
     }
     
-    // Reset all options first
-    curl_easy_reset(curl_handle);
+    // Swap per-request options only (keeps the connection cache alive)
+    prepare_request(url);
     
     struct curl_slist* headers = nullptr;
     std::string content_type_header = "Content-Type: " + content_type;
     headers = curl_slist_append(headers, content_type_header.c_str());
     
-    curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, data.c_str());
+    // Large enough bodies go out gzip-compressed when that actually saves bytes
+    const std::string* body = &data;
+    std::string compressed;
+    if (compression_.compress_requests && data.size() >= compression_.min_request_size &&
+        gzip_compress(data.data(), data.size(), compressed) && compressed.size() < data.size()) {
+        body = &compressed;
+        headers = curl_slist_append(headers, "Content-Encoding: gzip");
+        compression_stats_.compressed_requests++;
+    }
+    compression_stats_.request_body_bytes += data.size();
+    compression_stats_.request_wire_bytes += body->size();
+    if (compression_.accept_encoding) {
+        curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING, "");
+    }
+    
+    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(body->size()));
+    curl_easy_setopt(curl_handle, CURLOPT_POSTFIELDS, body->data());
     curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
+    BodyWriteContext body_context = {curl_handle, &response.body, false, nullptr, nullptr};
     curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &response.body);
-    curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &body_context);
     curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, &response.headers);
-    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);
     
-    CURLcode res = curl_easy_perform(curl_handle);
+    CURLcode res = static_cast<CURLcode>(perform_request());
     
     if (res == CURLE_OK) {
         curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response.status_code);
+        record_response_size(response);
     } else {
         response.status_code = 0;
-        std::cerr << "cURL error: " << curl_easy_strerror(res) << std::endl;
+        HAWKBIT_LOG_ERROR("cURL error: %s", curl_easy_strerror(res));
     }
     
+    // The slist is freed below, so drop the dangling pointer from the handle
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, nullptr);
     curl_slist_free_all(headers);
     return response;
 }
 
-bool HttpClient::download_file(const std::string& url, const std::string& filepath) {
+bool HttpClient::download_file(const std::string& url, const std::string& filepath,
+                               const ArtifactHashes& expected_hashes, uint64_t expected_size) {
+    // 파일도 하나의 sink: 디스크 기록은 writer 스레드가 담당하므로 쓰기 지연이
+    // 수신(TCP window)을 막지 않음. 실패/해시 불일치시 부분 파일 삭제
+    ThreadedSink sink(std::unique_ptr<DownloadSink>(new FileSink(filepath, file_options_)));
+    return download_to_sink(url, sink, expected_hashes, expected_size);
+}
+
+bool HttpClient::download_to_sink(const std::string& url, DownloadSink& sink,
+                                  const ArtifactHashes& expected_hashes, uint64_t expected_size) {
     if (!curl_handle) {
         return false;
     }
     
-    std::ofstream file(filepath, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file for writing: " << filepath << std::endl;
+    if (!sink.open(expected_size)) {
+        HAWKBIT_LOG_ERROR("Failed to open %s", sink.describe().c_str());
         return false;
     }
     
-    // Reset all options first
-    curl_easy_reset(curl_handle);
+    // Swap per-request options only (keeps the connection cache alive)
+    prepare_request(url);
     
-    curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteFileCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &file);
-    curl_easy_setopt(curl_handle, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 30L);
+    StreamingHasher hasher(expected_hashes);
+    SinkWriteContext context = {&sink, hasher.enabled() ? &hasher : nullptr, 0, curl_handle, rate_limiter_.get(),
+                                &socket_};
     
-    CURLcode res = curl_easy_perform(curl_handle);
-    file.close();
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteSinkCallback);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &context);
+    // A slow installer can stretch the transfer; rely on stall detection instead
+    curl_easy_setopt(curl_handle, CURLOPT_TIMEOUT, 0L);
     
-    if (res != CURLE_OK) {
-        std::cerr << "Download failed: " << curl_easy_strerror(res) << std::endl;
-        return false;
+    // 압축 전송을 받으면 curl이 풀어서 넘기므로 해시는 원본 이미지 기준으로 계산됨
+    HttpHeaders headers;
+    if (compression_.decode_downloads) {
+        curl_easy_setopt(curl_handle, CURLOPT_ACCEPT_ENCODING, "");
+        curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, &headers);
+    } else {
+        curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, nullptr);
     }
     
-    long response_code;
-    curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
+    CURLcode res = static_cast<CURLcode>(perform_request());
+    
+    long response_code = 0;
+    if (res == CURLE_OK) {
+        curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
+        
+        curl_off_t wire_bytes = 0;
+        curl_easy_getinfo(curl_handle, CURLINFO_SIZE_DOWNLOAD_T, &wire_bytes);
+        compression_stats_.downloads++;
+        compression_stats_.download_wire_bytes += static_cast<uint64_t>(wire_bytes);
+        compression_stats_.download_body_bytes += context.bytes;
+        if (is_content_encoded(headers.get(HttpHeaders::kContentEncoding))) {
+            compression_stats_.compressed_downloads++;
+        }
+    } else {
+        HAWKBIT_LOG_ERROR("Download failed: %s", curl_easy_strerror(res));
+    }
     
-    return response_code == 200;
-}
\ No newline at end of file
+    // 검증이 끝나기 전에는 sink를 확정하지 않음 (설치 명령은 아직 EOF를 받지 않은 상태)
+    if (res != CURLE_OK || response_code != 200) {
+        sink.abort();
+        return false;
+    }
+    if (!hasher.verify()) {
+        HAWKBIT_LOG_ERROR("Hash mismatch for streamed artifact - aborting %s", sink.describe().c_str());
+        sink.abort();
+        return false;
+    }
+    return sink.finish();
+}
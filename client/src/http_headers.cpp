@@ -0,0 +1,142 @@
+/**
+ * @file http_headers.cpp
+ * @brief HttpHeaders 구현
+ *
+ * 파싱:
+ * - curl header callback이 넘기는 줄을 임시 문자열 없이 포인터로 잘라 arena에 추가
+ * - 이름이 인식 대상(Content-Length, ETag 등)이면 known_에 entry index 기록
+ */
+#include "http_headers.h"
+#include <strings.h>
+
+namespace {
+
+/// 첫 header에서 arena를 이 크기로 예약 - 일반적인 응답 header 전체가 한 번에 들어감
+const size_t kArenaReserve = 512;
+
+/// HttpHeaders::Known 순서와 같아야 함
+const std::string_view kKnownNames[HttpHeaders::kKnownCount] = {
+    "Content-Length",
+    "ETag",
+    "Last-Modified",
+    "Content-Encoding",
+    "Retry-After",
+};
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && strncasecmp(a.data(), b.data(), a.size()) == 0;
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && is_space(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && is_space(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+} // namespace
+
+HttpHeaders::HttpHeaders() : inline_(), count_(0) {
+    for (int i = 0; i < kKnownCount; ++i) {
+        known_[i] = -1;
+    }
+}
+
+void HttpHeaders::clear() {
+    arena_.clear();
+    overflow_.clear();
+    count_ = 0;
+    for (int i = 0; i < kKnownCount; ++i) {
+        known_[i] = -1;
+    }
+}
+
+void HttpHeaders::add_line(const char* line, size_t length) {
+    std::string_view text(line, length);
+
+    // 새 응답 블록 (redirect, 100 Continue) - 최종 응답의 header만 유지
+    if (text.compare(0, 5, "HTTP/") == 0) {
+        clear();
+        return;
+    }
+
+    size_t colon = text.find(':');
+    if (colon == std::string_view::npos) {
+        return;   // 블록 끝의 빈 줄 또는 잘못된 줄
+    }
+    std::string_view name = trim(text.substr(0, colon));
+    if (name.empty()) {
+        return;
+    }
+    add(name, trim(text.substr(colon + 1)));
+}
+
+void HttpHeaders::add(std::string_view name, std::string_view value) {
+    if (arena_.capacity() < kArenaReserve) {
+        arena_.reserve(kArenaReserve);
+    }
+    Entry e;
+    e.name_offset = static_cast<uint32_t>(arena_.size());
+    e.name_length = static_cast<uint32_t>(name.size());
+    arena_.append(name.data(), name.size());
+    e.value_offset = static_cast<uint32_t>(arena_.size());
+    e.value_length = static_cast<uint32_t>(value.size());
+    arena_.append(value.data(), value.size());
+
+    if (count_ < kInlineFields) {
+        inline_[count_] = e;
+    } else {
+        overflow_.push_back(e);
+    }
+
+    // 같은 이름이 반복되면 마지막 값이 조회됨 (이전 std::map 동작과 동일)
+    for (int i = 0; i < kKnownCount; ++i) {
+        if (equals_ignore_case(name, kKnownNames[i])) {
+            known_[i] = static_cast<int>(count_);
+            break;
+        }
+    }
+    count_++;
+}
+
+std::string_view HttpHeaders::get(Known known) const {
+    int index = known_[known];
+    return index < 0 ? std::string_view() : field(entry(static_cast<size_t>(index))).value;
+}
+
+std::string_view HttpHeaders::get(std::string_view name) const {
+    for (size_t i = count_; i > 0; --i) {
+        Field f = field(entry(i - 1));
+        if (equals_ignore_case(f.name, name)) {
+            return f.value;
+        }
+    }
+    return std::string_view();
+}
+
+bool HttpHeaders::contains(std::string_view name) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (equals_ignore_case(field(entry(i)).name, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+HttpHeaders::Field HttpHeaders::operator[](size_t index) const {
+    return field(entry(index));
+}
+
+HttpHeaders::Field HttpHeaders::field(const Entry& e) const {
+    Field f;
+    f.name = std::string_view(arena_.data() + e.name_offset, e.name_length);
+    f.value = std::string_view(arena_.data() + e.value_offset, e.value_length);
+    return f;
+}
@@ -0,0 +1,259 @@
+/**
+ * @file logger.cpp
+ * @brief 비동기 로거 구현
+ *
+ * Ring buffer는 슬롯마다 sequence 번호를 두는 bounded MPMC 큐(Vyukov 방식)를
+ * 단일 소비자로 사용합니다.
+ * - 생산자: enqueue_pos_를 CAS로 하나 증가시켜 슬롯을 예약하고, 메시지를 쓴 뒤
+ *   sequence = pos + 1로 공개(release)
+ * - 소비자: sequence == pos + 1인 슬롯만 읽고, sequence = pos + kCapacity로 반환
+ * 생산자끼리 lock 없이 CAS 한 번으로 경쟁하며 writer와는 전혀 경쟁하지 않습니다.
+ */
+#include "logger.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <strings.h>
+#include <unistd.h>
+
+/**
+ * @brief 메시지 하나를 담는 슬롯 (생성 후 재할당 없음)
+ */
+struct Logger::Slot {
+    std::atomic<size_t> sequence;
+    LogLevel level;
+    uint32_t length;
+    int64_t timestamp_ms;           ///< system_clock, ms since epoch
+    char text[kMaxMessageLength];
+};
+
+namespace {
+
+static_assert((Logger::kCapacity & (Logger::kCapacity - 1)) == 0, "capacity must be a power of two");
+
+/// 긴급하지 않은 메시지는 이 주기로 모아서 출력
+const std::chrono::milliseconds kWriterInterval(50);
+
+/// write(2) 한 번에 내보낼 최대 크기
+const size_t kBatchBytes = 64 * 1024;
+
+const char* level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::kTrace: return "TRACE";
+    case LogLevel::kDebug: return "DEBUG";
+    case LogLevel::kInfo:  return "INFO ";
+    case LogLevel::kWarn:  return "WARN ";
+    case LogLevel::kError: return "ERROR";
+    default:               return "?    ";
+    }
+}
+
+/** @brief HAWKBIT_LOG_LEVEL 환경 변수 (없거나 모르는 값이면 info) */
+int level_from_environment() {
+    const char* value = std::getenv("HAWKBIT_LOG_LEVEL");
+    if (!value) {
+        return static_cast<int>(LogLevel::kInfo);
+    }
+    static const char* const kNames[] = {"trace", "debug", "info", "warn", "error", "off"};
+    for (int i = 0; i <= static_cast<int>(LogLevel::kOff); ++i) {
+        if (strcasecmp(value, kNames[i]) == 0) {
+            return i;
+        }
+    }
+    return static_cast<int>(LogLevel::kInfo);
+}
+
+/** @brief 부분 쓰기/EINTR을 처리하며 전부 출력 */
+void write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+/** @brief fd별 출력 묶음 */
+class Batch {
+public:
+    Batch() : fd_(-1), size_(0) {}
+    ~Batch() { flush(); }
+
+    void append(int fd, const char* data, size_t size) {
+        if (fd != fd_ || size_ + size > sizeof(buffer_)) {
+            flush();
+            fd_ = fd;
+        }
+        if (size > sizeof(buffer_)) {
+            write_all(fd, data, size);
+            return;
+        }
+        std::memcpy(buffer_ + size_, data, size);
+        size_ += size;
+    }
+
+    void flush() {
+        if (size_ > 0) {
+            write_all(fd_, buffer_, size_);
+            size_ = 0;
+        }
+    }
+
+private:
+    int fd_;
+    size_t size_;
+    char buffer_[kBatchBytes];
+};
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : slots_(new Slot[kCapacity]), enqueue_pos_(0), dequeue_pos_(0), written_pos_(0),
+      dropped_(0), reported_dropped_(0), level_(level_from_environment()), stop_(false) {
+    for (size_t i = 0; i < kCapacity; ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer_ = std::thread(&Logger::run_writer, this);
+}
+
+Logger::~Logger() {
+    stop_ = true;
+    wake_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void Logger::log(LogLevel level, const char* format, ...) {
+    // 슬롯 예약 (가득 차면 버림 - 호출 스레드는 절대 기다리지 않음)
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &slots_[pos & (kCapacity - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(slot->text, kMaxMessageLength, format, args);
+    va_end(args);
+    if (length < 0) {
+        length = 0;
+    } else if (static_cast<size_t>(length) >= kMaxMessageLength) {
+        // 잘린 메시지 표시
+        std::memcpy(slot->text + kMaxMessageLength - 4, "...", 4);
+        length = static_cast<int>(kMaxMessageLength - 1);
+    }
+    slot->length = static_cast<uint32_t>(length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    // 경고/에러와 버퍼 절반 초과시에만 writer를 깨움 (나머지는 주기적으로 모아서 출력)
+    if (level >= LogLevel::kWarn || pos - written_pos_.load(std::memory_order_relaxed) >= kCapacity / 2) {
+        wake_.notify_one();
+    }
+}
+
+void Logger::flush() {
+    size_t target = enqueue_pos_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_.notify_one();
+    while (written_pos_.load(std::memory_order_acquire) < target && !stop_) {
+        written_.wait_for(lock, kWriterInterval);
+        wake_.notify_one();
+    }
+}
+
+/**
+ * @brief 공개된 슬롯을 순서대로 출력하고 반환
+ *
+ * @return 출력한 메시지 수
+ */
+size_t Logger::drain() {
+    Batch batch;
+    size_t count = 0;
+    time_t cached_second = -1;
+    char prefix_time[32] = {0};
+
+    for (;;) {
+        Slot& slot = slots_[dequeue_pos_ & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+            break;   // 비었거나 생산자가 아직 쓰는 중
+        }
+
+        // "YYYY-MM-DD HH:MM:SS" 는 초가 바뀔 때만 다시 계산
+        time_t seconds = static_cast<time_t>(slot.timestamp_ms / 1000);
+        if (seconds != cached_second) {
+            std::tm local;
+            localtime_r(&seconds, &local);
+            std::strftime(prefix_time, sizeof(prefix_time), "%Y-%m-%d %H:%M:%S", &local);
+            cached_second = seconds;
+        }
+        char prefix[64];
+        int prefix_length = std::snprintf(prefix, sizeof(prefix), "%s.%03d %s ", prefix_time,
+                                          static_cast<int>(slot.timestamp_ms % 1000),
+                                          level_name(slot.level));
+
+        int fd = slot.level >= LogLevel::kWarn ? STDERR_FILENO : STDOUT_FILENO;
+        batch.append(fd, prefix, static_cast<size_t>(prefix_length));
+        batch.append(fd, slot.text, slot.length);
+        batch.append(fd, "\n", 1);
+
+        slot.sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+        ++dequeue_pos_;
+        ++count;
+    }
+    batch.flush();
+
+    unsigned long dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped > reported_dropped_) {
+        char notice[96];
+        int length = std::snprintf(notice, sizeof(notice), "[logger] %lu messages dropped (buffer full)\n",
+                                   dropped - reported_dropped_);
+        write_all(STDERR_FILENO, notice, static_cast<size_t>(length));
+        reported_dropped_ = dropped;
+    }
+
+    written_pos_.store(dequeue_pos_, std::memory_order_release);
+    return count;
+}
+
+void Logger::run_writer() {
+    while (!stop_) {
+        if (drain() > 0) {
+            written_.notify_all();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait_for(lock, kWriterInterval);
+    }
+    drain();
+    written_.notify_all();
+}
@@ -3,34 +3,104 @@
  * @brief hawkBit DDI C++ 클라이언트의 진입점(엔트리 포인트)
  *
  * English:
- * Minimal CLI that constructs a `HawkbitClient` and starts the polling loop.
+ * Minimal CLI that constructs a `HawkbitClient` and starts the polling loop,
+ * or runs a fleet of virtual controllers for server capacity tests (`--fleet`).
  *
  * 한국어:
  * 간단한 CLI로 `HawkbitClient` 객체를 생성하여 폴링 루프를 시작합니다.
+ * `--fleet N`을 주면 N개의 가상 컨트롤러로 서버 부하 테스트를 수행합니다.
  * C++ 기본 문법 요소도 함께 확인할 수 있습니다:
  * - `int main(int argc, char* argv[])`: 프로그램 시작점 및 인자 처리
  * - `std::string`: 동적 길이 문자열 클래스
  * - 예외 처리(`try/catch`)와 표준 입출력(`std::cout`, `std::cerr`)
  */
 #include "hawkbit_client.h"
+#include "fleet_simulator.h"
+#include "logger.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <string>
 
+namespace {
+
+/**
+ * @brief `--fleet N [--duration S] [--connections C] [--no-download] [--no-accept-encoding]
+ *        [--compress-reports]` 실행
+ *
+ * 예시:
+ *   ./build/client --fleet 10000 --duration 120 http://localhost:8000
+ */
+int run_fleet(int argc, char* argv[]) {
+    FleetOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--fleet" && has_value) {
+            options.controllers = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--duration" && has_value) {
+            options.duration = std::chrono::seconds(std::strtol(argv[++i], nullptr, 10));
+        } else if (arg == "--connections" && has_value) {
+            options.max_connections = std::strtol(argv[++i], nullptr, 10);
+        } else if (arg == "--in-flight" && has_value) {
+            options.max_in_flight = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--prefix" && has_value) {
+            options.id_prefix = argv[++i];
+        } else if (arg == "--no-download") {
+            options.download_artifacts = false;
+        } else if (arg == "--no-accept-encoding") {
+            options.accept_encoding = false;
+        } else if (arg == "--compress-reports") {
+            options.compress_reports = true;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            options.server_url = arg;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    
+    std::cout << "hawkBit DDI fleet simulator: " << options.controllers << " controllers, "
+              << options.duration.count() << " s, " << options.max_connections
+              << " connections -> " << options.server_url << std::endl;
+    
+    FleetSimulator fleet(options);
+    FleetReport report = fleet.run();
+    print_fleet_report(report, std::cout);
+    return 0;
+}
+
+} // namespace
+
 /**
  * @brief 프로그램 시작 함수 (C++ 표준 시그니처)
  *
  * English:
  * Parses optional CLI arguments: `[server_url] [controller_id]` and runs the client.
+ * If any argument is `--fleet N`, runs the fleet simulator instead.
  *
  * 한국어:
  * 선택적 CLI 인자 `[server_url] [controller_id]`를 파싱하여 클라이언트를 실행합니다.
+ * 인자에 `--fleet N`이 있으면 대신 fleet 시뮬레이터를 실행합니다.
  * - `argc`: 인자의 개수 (프로그램 경로 포함)
  * - `argv`: 인자 문자열 배열 (`argv[0]`는 실행 파일 경로)
  *
  * 예시:
  *   ./build/client http://localhost:8000 device001
+ *   ./build/client --fleet 1000 --duration 60 http://localhost:8000
  */
 int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--fleet") == 0) {
+            try {
+                return run_fleet(argc, argv);
+            } catch (const std::exception& e) {
+                std::cerr << "Fleet error: " << e.what() << std::endl;
+                return 1;
+            }
+        }
+    }
+    
     std::string server_url = "http://localhost:8000";
     std::string controller_id = "device001";
     
@@ -46,10 +116,144 @@ int main(int argc, char* argv[]) {
     std::cout << "==================" << std::endl;
     
     try {
-        HawkbitClient client(server_url, controller_id);
+        // HAWKBIT_HTTP_VERSION=2: HTTP/2 (https), =h2c: HTTP/2 prior knowledge (http, 로컬 테스트)
+        HttpVersion http_version = HttpVersion::kAuto;
+        const char* version = std::getenv("HAWKBIT_HTTP_VERSION");
+        if (version && std::string(version) == "2") {
+            http_version = HttpVersion::kHttp2;
+        } else if (version && std::string(version) == "h2c") {
+            http_version = HttpVersion::kHttp2PriorKnowledge;
+        }
+        // client보다 먼저 선언 - client의 다운로드가 끝난 뒤에 종료
+        std::unique_ptr<ArtifactGateway> gateway;
+        HawkbitClient client(server_url, controller_id, http_version);
+        // HAWKBIT_ACCEPT_ENCODING=0: 압축 poll 응답 사용 안 함, HAWKBIT_COMPRESS_STATUS=1: 상태 보고 gzip 전송
+        // HAWKBIT_DOWNLOAD_ENCODING=1: firmware도 압축 전송으로 받아 풀면서 기록
+        HttpCompressionOptions compression;
+        const char* accept_encoding = std::getenv("HAWKBIT_ACCEPT_ENCODING");
+        const char* compress_status = std::getenv("HAWKBIT_COMPRESS_STATUS");
+        const char* download_encoding = std::getenv("HAWKBIT_DOWNLOAD_ENCODING");
+        compression.accept_encoding = !(accept_encoding && std::string(accept_encoding) == "0");
+        compression.compress_requests = compress_status && std::string(compress_status) == "1";
+        compression.decode_downloads = download_encoding && std::string(download_encoding) == "1";
+        client.set_compression_options(compression);
+        // HAWKBIT_DELTA=1: 바뀐 chunk만 받음 (seed 기본값은 이전에 받은 파일, slot 설치시 HAWKBIT_DELTA_SEED로 활성 slot 지정)
+        const char* delta = std::getenv("HAWKBIT_DELTA");
+        if (delta && std::string(delta) == "1") {
+            DeltaOptions delta_options;
+            delta_options.enabled = true;
+            const char* seed = std::getenv("HAWKBIT_DELTA_SEED");
+            const char* store = std::getenv("HAWKBIT_CHUNK_STORE");
+            delta_options.seed_path = seed ? seed : "";
+            delta_options.store_dir = store ? store : "";
+            client.set_delta_options(delta_options);
+        }
+        // HAWKBIT_DOWNLOAD_RATE_KBPS=<KiB/s>: 다운로드 속도 상한 (배포 단위, 모든 병렬 전송 합계)
+        // HAWKBIT_DOWNLOAD_WINDOWS="08:00-18:00=64,22:00-06:00=0": 시간대별 상한 (0 = 그 시간에는 받지 않음)
+        // HAWKBIT_DOWNLOAD_LOW_PRIORITY=1: RTT가 늘면 양보하는 저우선순위 다운로드 (LEDBAT)
+        RateLimitOptions rate_limit;
+        const char* rate_kbps = std::getenv("HAWKBIT_DOWNLOAD_RATE_KBPS");
+        const char* rate_windows = std::getenv("HAWKBIT_DOWNLOAD_WINDOWS");
+        const char* low_priority = std::getenv("HAWKBIT_DOWNLOAD_LOW_PRIORITY");
+        if (rate_kbps && *rate_kbps) {
+            rate_limit.max_rate = std::strtoull(rate_kbps, nullptr, 10) * 1024;
+        }
+        if (rate_windows && *rate_windows && !parse_rate_windows(rate_windows, rate_limit.windows)) {
+            HAWKBIT_LOG_ERROR("Invalid HAWKBIT_DOWNLOAD_WINDOWS: %s (expected HH:MM-HH:MM=<KiB/s>,...)",
+                              rate_windows);
+            return 1;
+        }
+        rate_limit.low_priority = low_priority && std::string(low_priority) == "1";
+        client.set_rate_limit(rate_limit);
+        // HAWKBIT_FILE_SYNC=none|end|periodic: 파일 다운로드를 디스크에 반영하는 시점 (기본 end)
+        // (periodic: HAWKBIT_FILE_SYNC_INTERVAL_MB마다 writeback 시작, 기본 8)
+        // HAWKBIT_FILE_IO_URING=1: FileSink 버퍼를 io_uring으로 비동기 기록 (병렬 range 다운로드는 해당 없음)
+        FileWriteOptions file_options;
+        const char* file_sync = std::getenv("HAWKBIT_FILE_SYNC");
+        const char* sync_interval = std::getenv("HAWKBIT_FILE_SYNC_INTERVAL_MB");
+        const char* io_uring = std::getenv("HAWKBIT_FILE_IO_URING");
+        if (file_sync && *file_sync) {
+            std::string policy = file_sync;
+            if (policy == "none") {
+                file_options.sync_policy = SyncPolicy::kNone;
+            } else if (policy == "periodic") {
+                file_options.sync_policy = SyncPolicy::kPeriodic;
+            } else if (policy != "end") {
+                HAWKBIT_LOG_ERROR("Invalid HAWKBIT_FILE_SYNC: %s (expected none, end or periodic)", file_sync);
+                return 1;
+            }
+        }
+        if (sync_interval && std::strtoull(sync_interval, nullptr, 10) > 0) {
+            file_options.sync_interval = static_cast<size_t>(std::strtoull(sync_interval, nullptr, 10)) * 1024 * 1024;
+        }
+        file_options.io_uring = io_uring && std::string(io_uring) == "1";
+        client.set_file_write_options(file_options);
+        // HAWKBIT_ARTIFACT_CACHE=<dir>: 받은 artifact를 해시 이름으로 보관하여 재배포시 다시 받지 않음
+        // (HAWKBIT_ARTIFACT_CACHE_MB: 전체 크기 제한, 기본 1024 / HAWKBIT_ARTIFACT_CACHE_ENTRIES: 기본 16)
+        // HAWKBIT_GATEWAY_PORT=<port>: gateway 모드 - artifact를 한 번만 받아 LAN의 형제 기기에 전달
+        // (캐시 필요, 기본 디렉터리 artifact-cache / HAWKBIT_GATEWAY_UPSTREAM: 받을 URL prefix, 기본 서버 URL)
+        const char* gateway_port = std::getenv("HAWKBIT_GATEWAY_PORT");
+        const char* cache_dir = std::getenv("HAWKBIT_ARTIFACT_CACHE");
+        if (gateway_port && *gateway_port && !(cache_dir && *cache_dir)) {
+            cache_dir = "artifact-cache";
+        }
+        std::shared_ptr<ArtifactCache> cache;
+        if (cache_dir && *cache_dir) {
+            ArtifactCacheOptions cache_options;
+            cache_options.directory = cache_dir;
+            const char* cache_mb = std::getenv("HAWKBIT_ARTIFACT_CACHE_MB");
+            const char* cache_entries = std::getenv("HAWKBIT_ARTIFACT_CACHE_ENTRIES");
+            if (cache_mb && *cache_mb) {
+                cache_options.max_bytes = std::strtoull(cache_mb, nullptr, 10) * 1024 * 1024;
+            }
+            if (cache_entries && *cache_entries) {
+                cache_options.max_entries = static_cast<size_t>(std::strtoul(cache_entries, nullptr, 10));
+            }
+            cache.reset(new ArtifactCache(cache_options));
+            if (cache->open()) {
+                client.set_artifact_cache(cache);
+            } else {
+                cache.reset();
+            }
+        }
+        if (gateway_port && *gateway_port) {
+            if (!cache) {
+                return 1;
+            }
+            GatewayOptions gateway_options;
+            gateway_options.port = static_cast<unsigned short>(std::strtoul(gateway_port, nullptr, 10));
+            const char* upstream = std::getenv("HAWKBIT_GATEWAY_UPSTREAM");
+            gateway_options.upstream_prefix = upstream && *upstream ? upstream : server_url;
+            gateway_options.uplink_rate_limit = rate_limit;
+            gateway.reset(new ArtifactGateway(cache, gateway_options));
+            if (!gateway->start()) {
+                return 1;
+            }
+            // gateway 자신의 다운로드도 gateway를 거쳐 형제 기기와 같은 upstream 다운로드를 공유
+            client.set_gateway_url("http://127.0.0.1:" + std::to_string(gateway->port()));
+        }
+        // HAWKBIT_GATEWAY_URL=<url>: 형제 기기 - artifact를 gateway에서 받음 (poll/상태 보고는 서버로)
+        const char* gateway_url = std::getenv("HAWKBIT_GATEWAY_URL");
+        if (gateway_url && *gateway_url) {
+            client.set_gateway_url(gateway_url);
+        }
+        // 설정하면 firmware를 임시 파일 없이 slot 장치나 설치 명령으로 바로 전달
+        const char* install_device = std::getenv("HAWKBIT_INSTALL_DEVICE");
+        const char* install_command = std::getenv("HAWKBIT_INSTALL_COMMAND");
+        if (install_device && *install_device) {
+            std::string device = install_device;
+            client.set_download_sink_factory([device]() {
+                return std::unique_ptr<DownloadSink>(new BlockDeviceSink(device));
+            });
+        } else if (install_command && *install_command) {
+            std::string command = install_command;
+            client.set_download_sink_factory([command]() {
+                return std::unique_ptr<DownloadSink>(new ProcessSink(command));
+            });
+        }
         client.run_polling_loop();
     } catch (const std::exception& e) {
-        std::cerr << "Client error: " << e.what() << std::endl;
+        HAWKBIT_LOG_ERROR("Client error: %s", e.what());
         return 1;
     }
     
@@ -0,0 +1,88 @@
+/**
+ * @file poll_scheduler.cpp
+ * @brief poll 간격/백오프 계산 구현
+ *
+ * 백오프는 "equal jitter" 방식입니다: 대기 시간 d의 절반은 고정, 나머지 절반은
+ * 무작위로 두어 최소 대기 시간을 보장하면서 재시도 시점을 흩어 놓습니다.
+ */
+#include "poll_scheduler.h"
+#include <algorithm>
+
+namespace {
+
+/// 서버 값이 비정상적으로 작거나 커도 이 범위로 제한
+const std::chrono::seconds kMinInterval(1);
+const std::chrono::seconds kMaxInterval(24 * 60 * 60);
+
+bool parse_two_digits(std::string_view text, size_t pos, unsigned int& value) {
+    if (text[pos] < '0' || text[pos] > '9' || text[pos + 1] < '0' || text[pos + 1] > '9') {
+        return false;
+    }
+    value = static_cast<unsigned int>((text[pos] - '0') * 10 + (text[pos + 1] - '0'));
+    return true;
+}
+
+} // namespace
+
+bool parse_polling_sleep(std::string_view text, std::chrono::seconds& interval) {
+    unsigned int hours = 0;
+    unsigned int minutes = 0;
+    unsigned int seconds = 0;
+    if (text.size() != 8 || text[2] != ':' || text[5] != ':' ||
+        !parse_two_digits(text, 0, hours) || !parse_two_digits(text, 3, minutes) ||
+        !parse_two_digits(text, 6, seconds) || minutes >= 60 || seconds >= 60) {
+        return false;
+    }
+    interval = std::chrono::seconds(hours * 3600 + minutes * 60 + seconds);
+    return true;
+}
+
+PollScheduler::PollScheduler(std::chrono::seconds default_interval,
+                             std::chrono::seconds initial_backoff,
+                             std::chrono::seconds max_backoff,
+                             double jitter_ratio)
+    : interval_(default_interval), initial_backoff_(initial_backoff), max_backoff_(max_backoff),
+      jitter_ratio_(jitter_ratio), failures_(0), poll_immediately_(false),
+      random_(std::random_device()()) {
+}
+
+void PollScheduler::set_server_interval(std::chrono::seconds interval) {
+    interval_ = std::min(std::max(interval, kMinInterval), kMaxInterval);
+}
+
+void PollScheduler::on_success() {
+    failures_ = 0;
+}
+
+void PollScheduler::on_failure() {
+    ++failures_;
+}
+
+void PollScheduler::on_action_completed() {
+    poll_immediately_ = true;
+}
+
+std::chrono::milliseconds PollScheduler::next_delay() {
+    typedef std::chrono::milliseconds ms;
+
+    if (poll_immediately_) {
+        poll_immediately_ = false;
+        return ms(0);
+    }
+
+    if (failures_ > 0) {
+        // initial * 2^(failures-1), 상한 적용 (shift overflow 방지)
+        ms backoff = std::chrono::duration_cast<ms>(max_backoff_);
+        if (failures_ <= 20) {
+            ms grown = std::chrono::duration_cast<ms>(initial_backoff_) * static_cast<ms::rep>(1L << (failures_ - 1));
+            backoff = std::min(backoff, grown);
+        }
+        std::uniform_int_distribution<ms::rep> half(0, backoff.count() / 2);
+        return ms(backoff.count() - backoff.count() / 2 + half(random_));
+    }
+
+    ms base = std::chrono::duration_cast<ms>(interval_);
+    ms::rep spread = static_cast<ms::rep>(base.count() * jitter_ratio_);
+    std::uniform_int_distribution<ms::rep> jitter(-spread, spread);
+    return ms(base.count() + jitter(random_));
+}
@@ -0,0 +1,251 @@
+/**
+ * @file rate_limiter.cpp
+ * @brief RateLimiter 구현 (token bucket + LEDBAT 방식 저우선순위 제어)
+ *
+ * 저우선순위 제어 (RFC 6817을 속도 기반으로 옮긴 것):
+ * - base RTT: 1분 단위 최소값 10개 중 최소 (경로가 바뀌어도 10분 뒤에는 갱신)
+ * - current RTT: 최근 4개 sample 중 최소 (순간적인 지연 튐 제거)
+ * - off_target = (target - (current - base)) / target
+ * - 0 이상: bucket이 실제로 전송을 막았을 때만 속도 증가 (링크가 병목이면 늘리지 않음)
+ * - 음수: 비례하여 감소, sample당 최대 절반
+ */
+#include "rate_limiter.h"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+/// bucket이 비어 있을 때 최소 burst (curl 수신 조각 몇 개)
+const double kMinBurst = 64 * 1024;
+
+/// 저우선순위 시작 속도 (제한이 없거나 더 클 때)
+const double kInitialLowPriorityRate = 256 * 1024;
+
+/// sample당 최대 증가/감소 비율
+const double kGain = 0.1;
+
+const std::chrono::milliseconds kSampleInterval(100);
+
+bool parse_two_digits(std::string_view text, size_t pos, int& value) {
+    if (text[pos] < '0' || text[pos] > '9' || text[pos + 1] < '0' || text[pos + 1] > '9') {
+        return false;
+    }
+    value = (text[pos] - '0') * 10 + (text[pos + 1] - '0');
+    return true;
+}
+
+/** @brief "HH:MM" → 자정 이후 분 (24:00 허용) */
+bool parse_clock(std::string_view text, size_t pos, int& minute) {
+    int hours = 0;
+    int minutes = 0;
+    if (text[pos + 2] != ':' || !parse_two_digits(text, pos, hours) || !parse_two_digits(text, pos + 3, minutes) ||
+        minutes >= 60 || hours * 60 + minutes > 24 * 60) {
+        return false;
+    }
+    minute = hours * 60 + minutes;
+    return true;
+}
+
+int local_minute(std::time_t now) {
+    std::tm local = {};
+    localtime_r(&now, &local);
+    return local.tm_hour * 60 + local.tm_min;
+}
+
+/** @brief 해당 시각을 포함하는 첫 번째 window (없으면 nullptr) */
+const RateWindow* window_at(const RateLimitOptions& options, int minute) {
+    for (const RateWindow& window : options.windows) {
+        bool inside = window.start_minute <= window.end_minute
+                          ? minute >= window.start_minute && minute < window.end_minute
+                          : minute >= window.start_minute || minute < window.end_minute;
+        if (inside) {
+            return &window;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool parse_rate_windows(std::string_view text, std::vector<RateWindow>& windows) {
+    std::vector<RateWindow> parsed;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        std::string_view entry = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+        // "HH:MM-HH:MM=<KiB/s>"
+        RateWindow window;
+        if (entry.size() < 13 || entry[5] != '-' || entry[11] != '=' ||
+            !parse_clock(entry, 0, window.start_minute) || !parse_clock(entry, 6, window.end_minute)) {
+            return false;
+        }
+        uint64_t kib = 0;
+        for (size_t i = 12; i < entry.size(); ++i) {
+            if (entry[i] < '0' || entry[i] > '9' || kib > (UINT64_MAX / 1024 - 9) / 10) {
+                return false;
+            }
+            kib = kib * 10 + static_cast<uint64_t>(entry[i] - '0');
+        }
+        window.rate = kib * 1024;
+        parsed.push_back(window);
+    }
+    windows.swap(parsed);
+    return true;
+}
+
+RateLimiter::RateLimiter(const RateLimitOptions& options)
+    : options_(options), tokens_(0), refilled_(Clock::now()), cap_(0), ledbat_rate_(0), limited_(false) {
+    update_cap(refilled_);
+    tokens_ = bucket_size(current_rate());
+    ledbat_rate_ = kInitialLowPriorityRate;
+    if (cap_ > 0) {
+        ledbat_rate_ = std::min(ledbat_rate_, static_cast<double>(cap_));
+    }
+    ledbat_rate_ = std::max(ledbat_rate_, static_cast<double>(options_.min_rate));
+    next_sample_ = refilled_;
+}
+
+bool RateLimiter::blocked(const RateLimitOptions& options, std::time_t now) {
+    const RateWindow* window = window_at(options, local_minute(now));
+    return window && window->rate == 0;
+}
+
+void RateLimiter::update_cap(Clock::time_point now) {
+    if (cap_checked_ != Clock::time_point() && now - cap_checked_ < std::chrono::seconds(1)) {
+        return;
+    }
+    cap_checked_ = now;
+    const RateWindow* window = window_at(options_, local_minute(std::time(nullptr)));
+    if (!window) {
+        cap_ = options_.max_rate;
+    } else {
+        // 금지 시간대에 이미 진행 중인 전송은 연결이 끊기지 않을 만큼만 받음
+        cap_ = window->rate > 0 ? window->rate : options_.min_rate;
+    }
+}
+
+double RateLimiter::current_rate() const {
+    if (!options_.low_priority) {
+        return static_cast<double>(cap_);
+    }
+    return cap_ > 0 ? std::min(ledbat_rate_, static_cast<double>(cap_)) : ledbat_rate_;
+}
+
+double RateLimiter::bucket_size(double rate) const {
+    if (options_.burst > 0) {
+        return static_cast<double>(options_.burst);
+    }
+    return std::max(kMinBurst, rate / 4);
+}
+
+std::chrono::microseconds RateLimiter::acquire(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    if (stats_.bytes == 0) {
+        first_byte_ = now;
+    }
+    last_byte_ = now;
+    stats_.bytes += bytes;
+
+    update_cap(now);
+    double rate = current_rate();
+    if (rate <= 0) {
+        refilled_ = now;
+        return std::chrono::microseconds(0);
+    }
+    double elapsed = std::chrono::duration<double>(now - refilled_).count();
+    refilled_ = now;
+    tokens_ = std::min(bucket_size(rate), tokens_ + elapsed * rate) - static_cast<double>(bytes);
+    if (tokens_ >= 0) {
+        return std::chrono::microseconds(0);
+    }
+    // 빚을 갚을 때까지 읽지 않음 - 공유하는 다른 전송도 같은 빚을 보고 기다림
+    double wait = -tokens_ / rate;
+    limited_ = true;
+    stats_.throttled_seconds += wait;
+    return std::chrono::microseconds(static_cast<long long>(wait * 1e6));
+}
+
+void RateLimiter::throttle(size_t bytes) {
+    std::chrono::microseconds wait = acquire(bytes);
+    if (wait.count() > 0) {
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+bool RateLimiter::wants_rtt_sample() {
+    if (!options_.low_priority) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    if (now < next_sample_) {
+        return false;
+    }
+    next_sample_ = now + kSampleInterval;
+    return true;
+}
+
+void RateLimiter::sample_socket(int fd) {
+    tcp_info info = {};
+    socklen_t length = sizeof(info);
+    if (fd < 0 || getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &length) != 0) {
+        return;
+    }
+    // 수신 측 추정값(데이터 도착 간격 기반)이 있으면 사용, 없으면 ACK 기반 RTT
+    unsigned int rtt = info.tcpi_rcv_rtt > 0 ? info.tcpi_rcv_rtt : info.tcpi_rtt;
+    if (rtt > 0) {
+        add_rtt_sample(std::chrono::microseconds(rtt));
+    }
+}
+
+void RateLimiter::add_rtt_sample(std::chrono::microseconds rtt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+    stats_.rtt_samples++;
+
+    if (base_history_.empty() || now - base_minute_ >= std::chrono::minutes(1)) {
+        base_history_.push_back(rtt);
+        base_minute_ = now;
+        if (base_history_.size() > kBaseHistory) {
+            base_history_.erase(base_history_.begin());
+        }
+    } else {
+        base_history_.back() = std::min(base_history_.back(), rtt);
+    }
+    current_filter_.push_back(rtt);
+    if (current_filter_.size() > kCurrentFilter) {
+        current_filter_.erase(current_filter_.begin());
+    }
+    stats_.base_rtt = *std::min_element(base_history_.begin(), base_history_.end());
+    stats_.current_rtt = *std::min_element(current_filter_.begin(), current_filter_.end());
+
+    double target = std::chrono::duration<double>(options_.target_delay).count();
+    double queuing = std::chrono::duration<double>(stats_.current_rtt - stats_.base_rtt).count();
+    double off_target = target > 0 ? (target - queuing) / target : 1;
+    if (off_target < 0) {
+        ledbat_rate_ *= std::max(0.5, 1 + kGain * off_target);
+    } else if (limited_) {
+        ledbat_rate_ *= 1 + kGain * off_target;
+    }
+    limited_ = false;
+
+    update_cap(now);
+    if (cap_ > 0) {
+        ledbat_rate_ = std::min(ledbat_rate_, static_cast<double>(cap_));
+    }
+    ledbat_rate_ = std::max(ledbat_rate_, static_cast<double>(options_.min_rate));
+}
+
+RateLimitStats RateLimiter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RateLimitStats stats = stats_;
+    stats.elapsed_seconds = std::chrono::duration<double>(last_byte_ - first_byte_).count();
+    stats.cap = cap_;
+    stats.rate = static_cast<uint64_t>(current_rate());
+    return stats;
+}
@@ -0,0 +1,532 @@
+/**
+ * @file segmented_downloader.cpp
+ * @brief 병렬 range 다운로드 구현 (이어받기 지원)
+ *
+ * 동작 방식:
+ * 1. DownloadJournal을 읽어 이미 받은 구간을 확인 (없으면 파일을 새로 생성)
+ * 2. 빠진 구간들을 segment 개수에 맞게 나누어 "Range: bytes=a-b" 요청 생성
+ * 3. 이벤트 루프 스레드는 segment별 버퍼에 복사만 하고, 가득 찬 버퍼를 offset과 함께
+ *    writer 스레드에 넘김 (HTTP/2에서는 poll/상태 보고도 같은 루프를 쓰므로 저장 장치
+ *    지연이 루프를 멈추지 않도록). writer 스레드가 pwrite(fd, offset)로 기록
+ *    (세그먼트마다 offset이 다르므로 파일 위치 공유 문제가 없음).
+ *    빈 버퍼가 없으면 루프에서 기다리지 않고 그 segment만 일시 정지(can_accept)했다가
+ *    writer가 버퍼를 반환하면 AsyncHttpEngine::resume_receiving()으로 재개
+ * 4. writer 스레드가 일정량마다 fdatasync 후 저널에 진행 상황 기록 (checkpoint)
+ * 5. 모두 성공하면 저널 삭제, 실패하면 받은 구간까지 저널에 남겨 다음 시도에서 이어받기
+ *
+ * 스트리밍 해시 검증:
+ * - 해시는 파일 처음부터 순서대로 계산해야 하므로 "hash frontier"(해시한 byte 수)를 유지
+ * - frontier 위치에 쓰이는 데이터는 메모리에서 바로 해시 (단일 segment 다운로드는 전부 해당)
+ * - frontier보다 앞서 도착한 다른 segment의 데이터와 이전 시도에서 받은 구간만
+ *   frontier가 도달했을 때 파일에서 한 번 읽어 해시 (대부분 page cache에서 읽힘)
+ */
+#include "segmented_downloader.h"
+#include "download_journal.h"
+#include "file_writer.h"
+#include "artifact_hasher.h"
+#include "io_util.h"
+#include "logger.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+const size_t SegmentedDownloader::kMinSegmentSize;
+const size_t SegmentedDownloader::kCheckpointInterval;
+
+namespace {
+
+/// writer 스레드에 한 번에 넘기는 양 (segment마다 이만큼 모아서 넘김)
+const size_t kWriteBufferSize = 256 * 1024;
+
+/// segment당 채우는 버퍼 외에 기록 대기열에 둘 수 있는 버퍼 수 (저장 장치 지연 흡수량)
+const size_t kSpareWriteBuffers = 8;
+
+/**
+ * @brief segment 하나의 진행 상태
+ */
+struct Segment {
+    size_t begin = 0;       ///< 파일 내 시작 offset
+    size_t length = 0;      ///< 요청한 byte 수
+    size_t received = 0;    ///< 지금까지 받은 byte 수 (이벤트 루프 스레드)
+    size_t written = 0;     ///< 지금까지 파일에 기록한 byte 수 (writer 스레드)
+    std::unique_ptr<char[]> buffer;     ///< 채우는 중인 버퍼 (이벤트 루프 스레드)
+    size_t filled = 0;
+};
+
+/**
+ * @brief writer 스레드에 넘긴 버퍼 (buffer가 nullptr이면 다운로드 종료)
+ */
+struct WriteJob {
+    size_t segment = 0;
+    size_t offset = 0;      ///< 파일 내 기록 위치
+    size_t size = 0;
+    std::unique_ptr<char[]> buffer;
+};
+
+/**
+ * @brief 모든 segment가 공유하는 다운로드 상태
+ *
+ * on_data와 completion callback은 이벤트 루프 스레드에서 실행되며 received와
+ * 채우는 중인 버퍼만 다룹니다. 파일 기록, 해시, fdatasync, 저널은 모두 writer
+ * 스레드가 넘겨받은 순서대로 처리하므로 checkpoint와 catch_up은 항상 이미 기록된
+ * 데이터만 봅니다. 두 스레드는 jobs/free_buffers(mutex)와 failed/write_failed(atomic)로만
+ * 통신합니다. segment(네트워크) 실패는 나머지 전송만 멈추고 이미 받은 버퍼는 계속 기록하여
+ * 다음 시도에서 이어받으며, 기록을 건너뛰는 것은 저장 장치 오류(write_failed)뿐입니다.
+ * 이벤트 루프 스레드는 절대 대기하지 않습니다 - 버퍼가 모자라면 전송을 멈추고(waiting),
+ * writer가 버퍼를 반환할 때 엔진에 재개를 요청합니다.
+ */
+struct SegmentedState {
+    explicit SegmentedState(const std::string& filepath) : journal(filepath) {}
+
+    ~SegmentedState() {
+        if (writer.joinable()) {
+            // writer 스레드가 마지막 참조를 놓으면 소멸자는 그 스레드에서 실행됨
+            if (writer.get_id() == std::this_thread::get_id()) {
+                writer.detach();
+            } else {
+                writer.join();
+            }
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    int fd = -1;
+    DownloadJournal journal;
+    std::vector<DownloadJournal::Range> existing;   ///< 이전 시도에서 받은 구간
+    std::vector<Segment> segments;
+    size_t remaining = 0;
+    size_t unsynced_bytes = 0;
+    std::atomic<bool> failed{false};               ///< segment 실패 (status/길이/연결) - 전송 중단
+    std::atomic<bool> write_failed{false};         ///< 기록 실패 - 이후 버퍼는 기록하지 않음
+    std::promise<bool> promise;
+    bool journaled = true;                          ///< false: 크기를 모르는 단일 스트림 (이어받기 없음)
+    bool sync_at_end = true;                        ///< false: SyncPolicy::kNone (마지막 fdatasync 생략)
+
+    std::unique_ptr<StreamingHasher> hasher;        ///< nullptr: 해시 검증 없음
+    size_t hashed = 0;                              ///< hash frontier: [0, hashed) 해시 완료
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable jobs_changed;           ///< 작업이 들어옴
+    std::deque<WriteJob> jobs;                      ///< 넘겨받은 순서대로 기록
+    std::vector<std::unique_ptr<char[]>> free_buffers;
+    size_t allocated_buffers = 0;
+    size_t max_buffers = 0;
+    unsigned long stalls = 0;                       ///< 버퍼가 없어 전송을 멈춘 횟수 (backpressure)
+    bool waiting = false;                           ///< 멈춘 segment가 버퍼 반환을 기다림
+    AsyncHttpEngine* engine = nullptr;              ///< 재개 요청 대상 (마지막 segment 완료 후 nullptr)
+
+    /**
+     * @brief writer 스레드 시작 (스레드가 끝날 때까지 상태를 유지하도록 참조를 넘김)
+     */
+    static void start_writer(const std::shared_ptr<SegmentedState>& state) {
+        state->max_buffers = state->segments.size() + kSpareWriteBuffers;
+        state->writer = std::thread([state]() { state->run_writer(); });
+    }
+
+    /**
+     * @brief size byte를 지금 복사할 버퍼가 있는지 확인 (이벤트 루프 스레드)
+     *
+     * 없으면 waiting을 표시하고 false - 엔진이 전송을 멈추고, writer가 버퍼를 반환하면
+     * resume_receiving()으로 같은 데이터부터 다시 받음. 이미 실패했으면 true를 반환하여
+     * 이어지는 on_data/append()가 바로 전송을 중단하도록 함.
+     */
+    bool can_accept(size_t index, size_t size) {
+        const Segment& segment = segments[index];
+        // 가득 찬 버퍼는 바로 넘기므로 채우는 중인 버퍼에는 항상 공간이 있음
+        size_t room = segment.buffer ? kWriteBufferSize - segment.filled : 0;
+        if (size <= room) {
+            return true;
+        }
+        size_t needed = (size - room + kWriteBufferSize - 1) / kWriteBufferSize;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failed || write_failed || free_buffers.size() + (max_buffers - allocated_buffers) >= needed) {
+            return true;
+        }
+        stalls++;
+        waiting = true;
+        return false;
+    }
+
+    /**
+     * @brief 받은 데이터를 segment 버퍼에 복사하고 가득 차면 writer에 넘김 (이벤트 루프 스레드)
+     *
+     * can_accept()가 허락한 뒤에만 호출되므로 버퍼를 기다리지 않습니다.
+     *
+     * @return writer가 기록에 실패했으면 false
+     */
+    bool append(size_t index, const char* data, size_t size) {
+        Segment& segment = segments[index];
+        while (size > 0) {
+            if (!segment.buffer) {
+                segment.buffer = take_buffer();
+                if (!segment.buffer) {
+                    return false;
+                }
+                segment.filled = 0;
+            }
+            size_t chunk = std::min(size, kWriteBufferSize - segment.filled);
+            std::memcpy(segment.buffer.get() + segment.filled, data, chunk);
+            segment.filled += chunk;
+            segment.received += chunk;
+            data += chunk;
+            size -= chunk;
+            if (segment.filled == kWriteBufferSize) {
+                hand_off(index);
+            }
+        }
+        return !write_failed;
+    }
+
+    /**
+     * @brief 채우던 버퍼를 writer 스레드에 넘김 (이벤트 루프 스레드)
+     */
+    void hand_off(size_t index) {
+        Segment& segment = segments[index];
+        if (!segment.buffer) {
+            return;
+        }
+        WriteJob job;
+        job.segment = index;
+        job.offset = segment.begin + segment.received - segment.filled;
+        job.size = segment.filled;
+        job.buffer = std::move(segment.buffer);
+        segment.filled = 0;
+        push(std::move(job));
+    }
+
+    /**
+     * @brief 모든 segment가 끝남: 남은 기록 후 writer 스레드에서 마무리 (이벤트 루프 스레드)
+     */
+    void finish() {
+        push(WriteJob());
+    }
+
+    void push(WriteJob job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+        }
+        jobs_changed.notify_one();
+    }
+
+    /**
+     * @brief 빈 버퍼를 가져오거나 한도 안에서 새로 할당 (기다리지 않음 - can_accept() 참고)
+     *
+     * @return 기록이 이미 실패했으면 nullptr
+     */
+    std::unique_ptr<char[]> take_buffer() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (write_failed) {
+            return nullptr;
+        }
+        if (free_buffers.empty()) {
+            allocated_buffers++;
+            return std::unique_ptr<char[]>(new char[kWriteBufferSize]);
+        }
+        std::unique_ptr<char[]> buffer = std::move(free_buffers.back());
+        free_buffers.pop_back();
+        return buffer;
+    }
+
+    void run_writer() {
+        for (;;) {
+            WriteJob job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobs_changed.wait(lock, [this]() { return !jobs.empty(); });
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            if (!job.buffer) {
+                complete();
+                return;
+            }
+            // 네트워크 실패 후에도 받은 데이터는 기록 (checkpoint로 다음 시도에서 이어받음)
+            if (!write_failed && !write(job)) {
+                HAWKBIT_LOG_ERROR("Failed to write segment %zu at offset %zu", job.segment, job.offset);
+                write_failed = true;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            free_buffers.push_back(std::move(job.buffer));
+            // 멈춘 segment 재개 (기록 실패시에도 - 재개된 segment가 on_data에서 중단됨)
+            if (waiting && engine) {
+                waiting = false;
+                engine->resume_receiving();
+            }
+        }
+    }
+
+    /**
+     * @brief 버퍼 하나를 기록하고 해시, 일정량마다 checkpoint (writer 스레드)
+     */
+    bool write(const WriteJob& job) {
+        Segment& segment = segments[job.segment];
+        if (!pwrite_fully(fd, job.buffer.get(), job.size, job.offset)) {
+            return false;
+        }
+        segment.written += job.size;
+        unsynced_bytes += job.size;
+        hash_in_order(job.offset, job.buffer.get(), job.size);
+        if (unsynced_bytes >= SegmentedDownloader::kCheckpointInterval) {
+            checkpoint();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 다운로드 마무리: fdatasync, 해시 확인, 저널 정리 (writer 스레드)
+     */
+    void complete() {
+        bool success = !failed && !write_failed;
+        if (success && sync_at_end) {
+            success = fdatasync(fd) == 0;
+        }
+        size_t total_size = journaled ? journal.total_size() : segments[0].written;
+        if (success && !verify_hashes(total_size)) {
+            // 손상된 데이터를 이어받지 않도록 저널을 지우고 실패 처리
+            journal.remove();
+            success = false;
+        } else if (success) {
+            journal.remove();
+        } else {
+            // 받은 구간까지 기록해 두고 다음 시도에서 이어받기
+            checkpoint();
+        }
+        if (stalls > 0) {
+            HAWKBIT_LOG_INFO("Segment writer: download waited %lu times for a free buffer", stalls);
+        }
+        close(fd);
+        fd = -1;
+        promise.set_value(success);
+    }
+
+    /**
+     * @brief frontier 위치의 데이터는 메모리에서 바로 해시
+     */
+    void hash_in_order(size_t offset, const char* data, size_t size) {
+        if (!hasher || offset != hashed) {
+            return;
+        }
+        hasher->update(data, size);
+        hashed += size;
+        catch_up();
+    }
+
+    /**
+     * @brief frontier에 닿은, 이미 디스크에 있는 구간을 읽어서 해시
+     *
+     * @return 읽기 실패시 false
+     */
+    bool catch_up() {
+        if (!hasher) {
+            return true;
+        }
+        char buffer[64 * 1024];
+        while (true) {
+            size_t end = hashed;
+            for (const DownloadJournal::Range& range : existing) {
+                if (range.first <= hashed && range.second > end) end = range.second;
+            }
+            for (const Segment& segment : segments) {
+                size_t written_end = segment.begin + segment.written;
+                if (segment.begin <= hashed && written_end > end) end = written_end;
+            }
+            if (end == hashed) {
+                return true;
+            }
+            while (hashed < end) {
+                size_t chunk = std::min(sizeof(buffer), end - hashed);
+                ssize_t n = pread(fd, buffer, chunk, static_cast<off_t>(hashed));
+                if (n <= 0) {
+                    return false;
+                }
+                hasher->update(buffer, static_cast<size_t>(n));
+                hashed += static_cast<size_t>(n);
+            }
+        }
+    }
+
+    /**
+     * @brief 전체 파일이 해시되었는지 확인하고 기대값과 비교
+     */
+    bool verify_hashes(size_t file_size) {
+        if (!hasher) {
+            return true;
+        }
+        if (!catch_up() || hashed != file_size || !hasher->verify()) {
+            HAWKBIT_LOG_ERROR("Hash mismatch for downloaded artifact (%zu/%zu bytes hashed)", hashed, file_size);
+            return false;
+        }
+        HAWKBIT_LOG_INFO("Artifact hash verified while streaming");
+        return true;
+    }
+
+    /**
+     * @brief 기록한 데이터를 디스크에 반영한 뒤 저널에 진행 상황 저장
+     */
+    void checkpoint() {
+        if (fdatasync(fd) != 0 || !journaled) {
+            return;
+        }
+        for (const Segment& segment : segments) {
+            journal.add_range(segment.begin, segment.begin + segment.written);
+        }
+        journal.save();
+        unsynced_bytes = 0;
+    }
+};
+
+/**
+ * @brief 빠진 구간들을 최대 count개 정도의 segment로 분할
+ */
+std::vector<Segment> plan_segments(const std::vector<DownloadJournal::Range>& missing,
+                                   size_t count, size_t min_size) {
+    size_t missing_bytes = 0;
+    for (const DownloadJournal::Range& range : missing) {
+        missing_bytes += range.second - range.first;
+    }
+    size_t piece = std::max(min_size, (missing_bytes + count - 1) / count);
+
+    std::vector<Segment> segments;
+    for (const DownloadJournal::Range& range : missing) {
+        for (size_t begin = range.first; begin < range.second; begin += piece) {
+            Segment segment;
+            segment.begin = begin;
+            segment.length = std::min(piece, range.second - begin);
+            segments.push_back(std::move(segment));
+        }
+    }
+    return segments;
+}
+
+} // namespace
+
+SegmentedDownloader::SegmentedDownloader(AsyncHttpEngine& engine, size_t segments)
+    : engine_(engine), segments_(segments == 0 ? 1 : segments) {
+}
+
+std::future<bool> SegmentedDownloader::download(const std::string& url,
+                                                const std::string& filepath,
+                                                size_t file_size,
+                                                size_t max_segments,
+                                                const ArtifactHashes& expected_hashes,
+                                                const std::shared_ptr<RateLimiter>& rate_limiter) {
+    std::shared_ptr<SegmentedState> state = std::make_shared<SegmentedState>(filepath);
+    std::future<bool> future = state->promise.get_future();
+
+    if (!expected_hashes.empty()) {
+        state->hasher.reset(new StreamingHasher(expected_hashes));
+    }
+
+    // 크기를 모르면 range를 나눌 수 없고 이어받을 수도 없으므로 저널 없이 단일 스트림으로 받음
+    // (해시 검증과 대역폭 제한은 분할 다운로드와 동일하게 적용)
+    state->journaled = file_size > 0;
+    state->sync_at_end = file_options_.sync_policy != SyncPolicy::kNone;
+
+    // 같은 artifact의 저널이 있으면 기존 파일을 유지하고 이어받기
+    // (해시를 알면 URL보다 확실한 식별자이므로 저널 key로 사용)
+    std::string journal_key = expected_hashes.sha256.empty() ? url : "sha256:" + expected_hashes.sha256;
+    bool resuming = state->journaled && state->journal.load(journal_key, file_size);
+    if (resuming && access(filepath.c_str(), F_OK) != 0) {
+        // 저널만 남고 파일이 사라졌으면 처음부터 다시 받음
+        state->journal.remove();
+        resuming = state->journal.load(journal_key, file_size);
+    }
+    // O_RDWR: 해시 frontier가 이미 기록된 구간을 다시 읽을 수 있도록
+    int flags = O_RDWR | O_CREAT | O_CLOEXEC | (resuming ? 0 : O_TRUNC);
+    state->fd = open(filepath.c_str(), flags, 0644);
+    // 전체 크기를 미리 할당: 단편화 방지, 공간 부족을 다운로드 전에 발견
+    if (state->fd < 0 || (file_size > 0 && file_options_.preallocate && !preallocate_file(state->fd, file_size))) {
+        HAWKBIT_LOG_ERROR("Failed to open file for writing: %s", filepath.c_str());
+        state->promise.set_value(false);
+        return future;
+    }
+
+    std::vector<DownloadJournal::Range> missing = state->journal.missing_ranges();
+    if (resuming) {
+        HAWKBIT_LOG_INFO("Resuming download: %zu/%zu bytes already on disk",
+                         state->journal.completed_bytes(), file_size);
+        state->existing = state->journal.completed_ranges();
+        // 이전에 받은 앞부분을 한 번 읽어 해시하고, 이후 데이터는 메모리에서 해시
+        state->catch_up();
+    }
+    if (missing.empty() && state->journaled) {
+        bool verified = state->verify_hashes(file_size);
+        state->journal.remove();
+        state->promise.set_value(verified);
+        return future;
+    }
+
+    if (state->journaled) {
+        state->segments = plan_segments(missing, max_segments == 0 ? segments_ : max_segments,
+                                        kMinSegmentSize);
+    } else {
+        // 길이를 모르는 segment 하나 (끝은 응답이 끝날 때 결정)
+        Segment segment;
+        segment.length = SIZE_MAX;
+        state->segments.push_back(std::move(segment));
+    }
+    state->remaining = state->segments.size();
+    state->engine = &engine_;
+    SegmentedState::start_writer(state);
+    // 처음부터 받는 단일 segment는 Range 없이 요청 (Range 미지원 서버 호환)
+    bool whole_file = state->segments.size() == 1 && state->segments[0].begin == 0 &&
+                      (state->segments[0].length == file_size || !state->journaled);
+
+    for (size_t i = 0; i < state->segments.size(); ++i) {
+        const Segment& segment = state->segments[i];
+
+        AsyncRequest request;
+        request.url = url;
+        request.expected_status = whole_file ? 200 : 206;
+        request.rate_limiter = rate_limiter;    // 모든 segment가 limiter 하나를 공유
+        if (!whole_file) {
+            request.headers.push_back("Range: bytes=" + std::to_string(segment.begin) + "-" +
+                                      std::to_string(segment.begin + segment.length - 1));
+        }
+        request.can_accept = [state, i](size_t size) {
+            return state->can_accept(i, size);
+        };
+        request.on_data = [state, i](const char* data, size_t size) {
+            const Segment& segment = state->segments[i];
+            if (state->failed || state->write_failed || segment.received + size > segment.length) {
+                return false;
+            }
+            return state->append(i, data, size);
+        };
+
+        engine_.submit(std::move(request), [state, i, whole_file](HttpResponse& response) {
+            // 받은 데이터는 실패한 segment라도 기록하여 다음 시도에서 이어받기
+            state->hand_off(i);
+            const Segment& segment = state->segments[i];
+            long expected_status = whole_file ? 200 : 206;
+            bool complete = !state->journaled || segment.received == segment.length;
+            if (response.status_code != expected_status || !complete) {
+                if (!state->failed.exchange(true)) {
+                    HAWKBIT_LOG_WARN("Segment %zu failed (status %ld, %zu/%zu bytes)",
+                                     i, response.status_code, segment.received, segment.length);
+                }
+            }
+            if (--state->remaining == 0) {
+                {
+                    // 이후 writer는 엔진에 접근하지 않음 (엔진이 먼저 소멸할 수 있음)
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->engine = nullptr;
+                }
+                state->finish();
+            }
+        });
+    }
+
+    return future;
+}
@@ -0,0 +1,231 @@
+/**
+ * @file threaded_sink.cpp
+ * @brief ThreadedSink 구현
+ *
+ * 잠금 규칙:
+ * - 채우는 중인 버퍼(current_, filled_)는 다운로드 스레드만 사용 → chunk마다 잠그지 않음
+ * - mutex_는 버퍼를 넘기거나 빈 버퍼를 가져올 때(buffer_size마다 한 번)만 잡음
+ * - writer 스레드는 잠금 없이 inner_->write()를 호출 (기록 중에도 다운로드는 계속 복사)
+ */
+#include "threaded_sink.h"
+#include "logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const size_t kNoBuffer = static_cast<size_t>(-1);
+
+} // namespace
+
+ThreadedSink::ThreadedSink(std::unique_ptr<DownloadSink> inner, size_t buffers, size_t buffer_size)
+    : inner_(std::move(inner)), buffer_size_(buffer_size == 0 ? 1 : buffer_size), current_(kNoBuffer),
+      filled_(0), writing_(false), waiting_(false), stop_(false), failed_(false), occupancy_sum_(0) {
+    buffers_.resize(buffers < 2 ? 2 : buffers);
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        buffers_[i].reset(new char[buffer_size_]);
+    }
+}
+
+ThreadedSink::~ThreadedSink() {
+    if (writer_.joinable()) {
+        abort();
+    }
+}
+
+bool ThreadedSink::open(uint64_t expected_size) {
+    if (!inner_->open(expected_size)) {
+        return false;
+    }
+    free_.clear();
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        free_.push_back(i);
+    }
+    pending_.clear();
+    current_ = kNoBuffer;
+    filled_ = 0;
+    writing_ = false;
+    waiting_ = false;
+    stop_ = false;
+    failed_ = false;
+    occupancy_sum_ = 0;
+    stats_ = ThreadedSinkStats();
+    stats_.buffers = buffers_.size();
+    stats_.buffer_size = buffer_size_;
+    writer_ = std::thread(&ThreadedSink::run_writer, this);
+    return true;
+}
+
+bool ThreadedSink::write(const char* data, size_t size) {
+    while (size > 0) {
+        if (current_ == kNoBuffer) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (free_.empty() && !failed_) {
+                // 모든 버퍼가 기록 대기 중 - 저장 장치가 따라올 때까지 대기 (backpressure)
+                std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+                free_changed_.wait(lock, [this]() { return !free_.empty() || failed_; });
+                stats_.stalls++;
+                stats_.stall_time += std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - started);
+            }
+            if (failed_) {
+                return false;
+            }
+            current_ = free_.back();
+            free_.pop_back();
+            filled_ = 0;
+        }
+
+        size_t chunk = std::min(size, buffer_size_ - filled_);
+        std::memcpy(buffers_[current_].get() + filled_, data, chunk);
+        filled_ += chunk;
+        data += chunk;
+        size -= chunk;
+        if (filled_ == buffer_size_ && !hand_off()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ThreadedSink::can_accept(size_t size) {
+    size_t room = current_ != kNoBuffer ? buffer_size_ - filled_ : 0;
+    if (size <= room) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failed_ || free_.size() * buffer_size_ >= size - room) {
+        return true;
+    }
+    // write()에서 기다리는 대신 호출자가 멈추고 writer가 버퍼를 반환하면 resume_으로 재개
+    if (!waiting_) {
+        waiting_ = true;
+        wait_started_ = std::chrono::steady_clock::now();
+        stats_.stalls++;
+    }
+    return false;
+}
+
+/**
+ * @brief 채운 버퍼를 writer 스레드에 넘김
+ *
+ * @return writer가 이미 실패했으면 false
+ */
+bool ThreadedSink::hand_off() {
+    Pending pending = {current_, filled_};
+    current_ = kNoBuffer;
+    filled_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_) {
+            free_.push_back(pending.index);
+            return false;
+        }
+        pending_.push_back(pending);
+        size_t occupancy = pending_.size() + (writing_ ? 1 : 0);
+        stats_.max_occupancy = std::max(stats_.max_occupancy, occupancy);
+        occupancy_sum_ += static_cast<double>(occupancy);
+        stats_.handoffs++;
+    }
+    pending_changed_.notify_one();
+    return true;
+}
+
+void ThreadedSink::run_writer() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        pending_changed_.wait(lock, [this]() { return !pending_.empty() || stop_; });
+        if (pending_.empty()) {
+            break;   // stop_ && 남은 버퍼 없음
+        }
+        Pending pending = pending_.front();
+        pending_.pop_front();
+        writing_ = true;
+        lock.unlock();
+
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        // failed_는 writer 스레드만 true로 바꾸므로 잠금 없이 읽어도 됨
+        bool ok = !failed_ && inner_->write(buffers_[pending.index].get(), pending.size);
+        std::chrono::microseconds elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started);
+
+        lock.lock();
+        writing_ = false;
+        stats_.write_time += elapsed;
+        if (ok && !failed_) {
+            stats_.bytes += pending.size;
+        } else {
+            failed_ = true;
+        }
+        free_.push_back(pending.index);
+        free_changed_.notify_all();
+        if (waiting_) {
+            waiting_ = false;
+            stats_.stall_time += std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - wait_started_);
+            if (resume_) {
+                resume_();
+            }
+        }
+    }
+}
+
+void ThreadedSink::stop_writer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    pending_changed_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+bool ThreadedSink::finish() {
+    if (current_ != kNoBuffer && filled_ > 0) {
+        hand_off();
+    }
+    bool failed;
+    {
+        // 넘긴 버퍼가 모두 기록될 때까지 대기
+        std::unique_lock<std::mutex> lock(mutex_);
+        free_changed_.wait(lock, [this]() { return (pending_.empty() && !writing_) || failed_; });
+        failed = failed_;
+        if (failed) {
+            pending_.clear();
+        }
+    }
+    stop_writer();
+    if (failed) {
+        inner_->abort();
+        return false;
+    }
+
+    ThreadedSinkStats summary = stats();
+    HAWKBIT_LOG_INFO("Writer thread: %lu buffers, max %zu/%zu queued (avg %.1f), %lu stalls (%lld ms), "
+                     "%lld ms writing",
+                     summary.handoffs, summary.max_occupancy, summary.buffers, summary.average_occupancy,
+                     summary.stalls, static_cast<long long>(summary.stall_time.count() / 1000),
+                     static_cast<long long>(summary.write_time.count() / 1000));
+    return inner_->finish();
+}
+
+void ThreadedSink::abort() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.clear();
+    }
+    stop_writer();
+    current_ = kNoBuffer;
+    filled_ = 0;
+    inner_->abort();
+}
+
+ThreadedSinkStats ThreadedSink::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ThreadedSinkStats result = stats_;
+    if (result.handoffs > 0) {
+        result.average_occupancy = occupancy_sum_ / static_cast<double>(result.handoffs);
+    }
+    return result;
+}
@@ -0,0 +1,125 @@
+"""
+Chunk index generator for delta updates / delta 업데이트용 chunk index 생성기
+
+English
+-------
+Splits an artifact into content-defined chunks and writes the index the
+client's delta mode downloads from "<artifact URL>.cidx". Chunk boundaries
+depend only on the bytes around them (gear rolling hash), so an insertion
+or a changed region in a new image only changes the chunks it touches; the
+device copies every other chunk from its installed image or chunk store and
+fetches the rest with Range requests.
+
+The chunker MUST stay identical to client/src/chunk_index.cpp:
+- gear table: 256 values of splitmix64, seed 0
+- per chunk: no cut in the first min_size bytes; from there on
+  h = (h << 1) + gear[byte] (64 bit), cut after the byte where the top
+  avg_bits bits of h are all zero, or at max_size / end of data
+
+This is a stand-in for casync/desync-style tooling so the feature can be
+tried offline with server/files; it is plain Python and handles a few
+hundred MB per minute.
+
+한국어
+-----
+artifact를 내용 기반(content-defined) chunk로 나누고, 클라이언트의 delta 모드가
+"<artifact URL>.cidx"에서 받는 index를 만듭니다. chunk 경계는 주변 바이트로만
+정해지므로(gear rolling hash) 새 이미지에서 바뀐 부분의 chunk만 달라지고, 기기는
+나머지 chunk를 설치된 이미지나 chunk 저장소에서 복사합니다. chunker는 클라이언트
+구현(client/src/chunk_index.cpp)과 반드시 같아야 합니다.
+
+Usage / 사용법:
+    python chunk_index.py files/firmware.bin          # writes files/firmware.bin.cidx
+    python chunk_index.py files/firmware.bin -o -     # prints the index
+
+Index format (text) / index 형식:
+    hawkbit-cidx 1 <size> <min_size> <avg_bits> <max_size>
+    <offset> <length> <sha256>
+    ...
+"""
+
+import argparse
+import hashlib
+import sys
+from typing import List, Tuple
+
+MIN_SIZE = 16 * 1024
+AVG_BITS = 16           # average chunk ~64 KiB
+MAX_SIZE = 256 * 1024
+
+_MASK64 = (1 << 64) - 1
+
+
+def _gear_table() -> List[int]:
+    """splitmix64 sequence - reproducible in C++ without shipping a table"""
+    table = []
+    state = 0
+    for _ in range(256):
+        state = (state + 0x9E3779B97F4A7C15) & _MASK64
+        z = state
+        z = ((z ^ (z >> 30)) * 0xBF58476D1CE4E5B9) & _MASK64
+        z = ((z ^ (z >> 27)) * 0x94D049BB133111EB) & _MASK64
+        table.append(z ^ (z >> 31))
+    return table
+
+
+GEAR = _gear_table()
+
+
+def chunk_boundaries(data: bytes, min_size: int = MIN_SIZE, avg_bits: int = AVG_BITS,
+                     max_size: int = MAX_SIZE) -> List[Tuple[int, int]]:
+    """
+    Content-defined chunks of data / 내용 기반 chunk 경계
+
+    Returns:
+        (offset, length) per chunk, covering data without gaps
+    """
+    mask = ((1 << avg_bits) - 1) << (64 - avg_bits)
+    gear = GEAR
+    chunks = []
+    start = 0
+    size = len(data)
+    while start < size:
+        end = min(start + max_size, size)
+        cut = end
+        h = 0
+        for i in range(start + min_size, end):
+            h = ((h << 1) + gear[data[i]]) & _MASK64
+            if h & mask == 0:
+                cut = i + 1
+                break
+        chunks.append((start, cut - start))
+        start = cut
+    return chunks
+
+
+def build_index(path: str) -> str:
+    """Index text for one artifact / artifact 하나의 index 문자열"""
+    with open(path, "rb") as f:
+        data = f.read()
+    lines = [f"hawkbit-cidx 1 {len(data)} {MIN_SIZE} {AVG_BITS} {MAX_SIZE}"]
+    for offset, length in chunk_boundaries(data):
+        digest = hashlib.sha256(data[offset:offset + length]).hexdigest()
+        lines.append(f"{offset} {length} {digest}")
+    return "\n".join(lines) + "\n"
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description="Generate a delta-update chunk index")
+    parser.add_argument("artifact", help="artifact file (e.g. files/firmware.bin)")
+    parser.add_argument("-o", "--output", help="index path (default: <artifact>.cidx, '-' = stdout)")
+    args = parser.parse_args()
+
+    index = build_index(args.artifact)
+    output = args.output or args.artifact + ".cidx"
+    if output == "-":
+        sys.stdout.write(index)
+    else:
+        with open(output, "w") as f:
+            f.write(index)
+        print(f"{output}: {index.count(chr(10)) - 1} chunks", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
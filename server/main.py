@@ -38,16 +38,48 @@ Eclipse hawkBit은 분산된 기기 플릿의 펌웨어/소프트웨어 업데
 """
 
 # Standard library imports
+import asyncio
+import functools
+import gzip
+import hashlib
+import json
 import os
+import re
 import uvicorn
 
+# Local module - content-defined chunk index for delta updates
+import chunk_index
+
 # Third-party imports - FastAPI ecosystem
-from fastapi import FastAPI, HTTPException
-from fastapi.responses import FileResponse
+from fastapi import FastAPI, HTTPException, Request
+from fastapi.responses import FileResponse, PlainTextResponse, Response, StreamingResponse
 from pydantic import BaseModel
 
 # Type hints for better code documentation and IDE support
-from typing import Dict, Any, List
+from typing import Dict, Any, List, AsyncIterator, Optional, Tuple
+
+# Injected latency for benchmarking (e.g. HAWKBIT_LATENCY_MS=50).
+# Applied before every response and between streamed 64 KiB chunks, so each
+# connection behaves like a window-limited link with that RTT.
+LATENCY_SECONDS = float(os.environ.get("HAWKBIT_LATENCY_MS", "0")) / 1000.0
+
+# Chunk size used when streaming (partial) file content
+STREAM_CHUNK_SIZE = 64 * 1024
+
+# Polling interval the controllers are told to use ("HH:MM:SS", DDI config.polling.sleep)
+POLLING_SLEEP = os.environ.get("HAWKBIT_POLLING_SLEEP", "00:00:10")
+
+# Extra software modules in the deployment (e.g. HAWKBIT_EXTRA_CHUNKS=20) to emulate
+# the verbose multi-chunk poll responses of real deployments
+EXTRA_CHUNKS = int(os.environ.get("HAWKBIT_EXTRA_CHUNKS", "0"))
+
+# Poll responses smaller than this are sent uncompressed (gzip overhead would dominate)
+GZIP_MIN_SIZE = 256
+
+# HAWKBIT_ARTIFACT_ENCODING=gzip: the deployment offers the firmware as a stored
+# "firmware.bin.gz" artifact (size and hashes of the compressed file, like an
+# artifact uploaded to hawkBit already compressed)
+ARTIFACT_ENCODING = os.environ.get("HAWKBIT_ARTIFACT_ENCODING", "")
 
 # FastAPI application instance with OpenAPI documentation
 # The title parameter automatically generates API documentation
@@ -60,6 +92,180 @@ app = FastAPI(
 )
 
 
+class GzipRequestMiddleware:
+    """
+    Decodes "Content-Encoding: gzip" request bodies / gzip 요청 body 디코딩
+
+    클라이언트가 상태 보고를 gzip으로 보내면(HAWKBIT_COMPRESS_STATUS=1) body를 풀어
+    Content-Length를 고친 뒤 다음 단계로 넘기므로, endpoint는 평소처럼 JSON을 받습니다.
+    """
+
+    def __init__(self, app):
+        self.app = app
+
+    async def __call__(self, scope, receive, send):
+        if scope["type"] != "http" or not any(
+                name == b"content-encoding" and value.strip().lower() == b"gzip"
+                for name, value in scope["headers"]):
+            await self.app(scope, receive, send)
+            return
+
+        body = b""
+        more_body = True
+        while more_body:
+            message = await receive()
+            body += message.get("body", b"")
+            more_body = message.get("more_body", False)
+        try:
+            body = gzip.decompress(body)
+        except (OSError, EOFError):
+            await PlainTextResponse("Invalid gzip request body", status_code=400)(scope, receive, send)
+            return
+
+        headers = [(name, value) for name, value in scope["headers"]
+                   if name not in (b"content-encoding", b"content-length")]
+        headers.append((b"content-length", str(len(body)).encode()))
+        body_sent = False
+
+        async def receive_decoded():
+            nonlocal body_sent
+            if not body_sent:
+                body_sent = True
+                return {"type": "http.request", "body": body, "more_body": False}
+            return await receive()
+
+        await self.app(dict(scope, headers=headers), receive_decoded, send)
+
+
+app.add_middleware(GzipRequestMiddleware)
+
+
+@app.middleware("http")
+async def inject_latency(request: Request, call_next):
+    """
+    Simulated network latency / 네트워크 지연 시뮬레이션
+
+    HAWKBIT_LATENCY_MS가 설정되면 모든 요청 처리 전에 지연을 추가합니다.
+    """
+    if LATENCY_SECONDS > 0:
+        await asyncio.sleep(LATENCY_SECONDS)
+    return await call_next(request)
+
+
+def parse_range_header(range_header: str, file_size: int) -> Optional[Tuple[int, int]]:
+    """
+    Parses a single "bytes=start-end" range / 단일 byte range 파싱
+
+    Returns:
+        (start, end) inclusive, or None if the header is unsupported/unsatisfiable
+    """
+    match = re.fullmatch(r"bytes=(\d*)-(\d*)", range_header.strip())
+    if not match or (not match.group(1) and not match.group(2)):
+        return None
+    if match.group(1):
+        start = int(match.group(1))
+        end = int(match.group(2)) if match.group(2) else file_size - 1
+    else:
+        # Suffix range: "bytes=-N" means the last N bytes
+        start = max(0, file_size - int(match.group(2)))
+        end = file_size - 1
+    end = min(end, file_size - 1)
+    if start > end:
+        return None
+    return start, end
+
+
+async def stream_file_range(path: str, start: int, end: int) -> AsyncIterator[bytes]:
+    """
+    Streams [start, end] of a file in chunks / 파일 구간을 chunk 단위로 스트리밍
+    """
+    with open(path, "rb") as f:
+        f.seek(start)
+        remaining = end - start + 1
+        while remaining > 0:
+            chunk = f.read(min(STREAM_CHUNK_SIZE, remaining))
+            if not chunk:
+                break
+            remaining -= len(chunk)
+            yield chunk
+            if LATENCY_SECONDS > 0:
+                await asyncio.sleep(LATENCY_SECONDS)
+
+
+@functools.lru_cache(maxsize=None)
+def compute_file_hashes(path: str) -> Dict[str, str]:
+    """
+    Artifact digests for the deployment descriptor / 배포 정보에 넣을 artifact 해시
+
+    hawkBit DDI는 artifact마다 sha1/md5/sha256 해시를 제공하며, 클라이언트는 다운로드
+    중에 이를 계산하여 무결성을 검증합니다. 파일은 한 번만 읽고 결과를 캐시합니다.
+    """
+    digests = {name: hashlib.new(name) for name in ("sha1", "md5", "sha256")}
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(STREAM_CHUNK_SIZE), b""):
+            for digest in digests.values():
+                digest.update(chunk)
+    return {name: digest.hexdigest() for name, digest in digests.items()}
+
+
+@functools.lru_cache(maxsize=None)
+def gzip_file(path: str) -> bytes:
+    """
+    gzip copy of an artifact / artifact의 gzip 압축본
+
+    한 번만 압축하여 메모리에 캐시합니다. mtime=0으로 만들어 재시작해도 바이트(와 해시)가
+    같으므로 클라이언트의 이어받기/캐시가 깨지지 않습니다.
+    """
+    with open(path, "rb") as f:
+        return gzip.compress(f.read(), compresslevel=9, mtime=0)
+
+
+@functools.lru_cache(maxsize=None)
+def compute_gzip_hashes(path: str) -> Dict[str, str]:
+    """Digests of the stored .gz artifact / 압축된 artifact 파일의 해시"""
+    data = gzip_file(path)
+    return {name: hashlib.new(name, data).hexdigest() for name in ("sha1", "md5", "sha256")}
+
+
+@functools.lru_cache(maxsize=8)
+def cached_chunk_index(path: str, mtime: float) -> str:
+    """
+    Chunk index of an artifact / artifact의 delta chunk index
+
+    파일 수정 시각을 key에 포함하여 이미지가 바뀌면 다시 만듭니다.
+    """
+    return chunk_index.build_index(path)
+
+
+def accepts_gzip(accept_encoding: Optional[str]) -> bool:
+    """
+    Accept-Encoding negotiation / Accept-Encoding 협상
+
+    gzip(또는 *)이 q=0이 아닌 값으로 포함되어 있으면 True. 표준 라이브러리만으로 만들 수 있는
+    gzip만 제공합니다 (클라이언트는 br, zstd도 제안하지만 gzip으로 충분히 비교 가능).
+    """
+    if not accept_encoding:
+        return False
+    for item in accept_encoding.split(","):
+        coding, _, params = item.strip().partition(";")
+        if coding.strip().lower() in ("gzip", "x-gzip", "*"):
+            q = params.strip()
+            return not (q.startswith("q=") and float(q[2:] or "0") == 0)
+    return False
+
+
+def etag_matches(if_none_match: Optional[str], etag: str) -> bool:
+    """
+    If-None-Match evaluation / If-None-Match 비교
+
+    "*" 또는 쉼표로 구분된 목록 중 하나가 일치하면 True (weak 비교, W/ 접두어 무시).
+    """
+    if not if_none_match:
+        return False
+    candidates = [tag.strip() for tag in if_none_match.split(",")]
+    return "*" in candidates or any((tag[2:] if tag.startswith("W/") else tag) == etag for tag in candidates)
+
+
 class StatusReport(BaseModel):
     """
     Pydantic model for device status reports
@@ -86,7 +292,7 @@ class StatusReport(BaseModel):
 
 
 @app.get("/rest/v1/ddi/v1/controller/device/{controller_id}")
-async def poll_controller(controller_id: str) -> Dict[str, Any]:
+async def poll_controller(controller_id: str, request: Request) -> Response:
     """
     DDI Polling Endpoint - Core of hawkBit's pull-based architecture
 
@@ -110,11 +316,17 @@ async def poll_controller(controller_id: str) -> Dict[str, Any]:
     HTTP Method: GET (멱등 연산)
     Response: 배포 정보가 포함된 JSON
 
+    Conditional polling / 조건부 폴링:
+    응답 body의 해시를 ETag로 보내고, 기기가 같은 값을 If-None-Match로 보내면
+    body 없이 304 Not Modified로 응답합니다. 변경이 없는 대부분의 poll에서
+    전송량과 양쪽의 파싱 비용이 거의 사라집니다.
+
     Args:
         controller_id (str): 기기 식별자 (예: "device001", MAC 주소 등)
+        request (Request): If-None-Match header 확인용
 
     Returns:
-        Dict[str, Any]: hawkBit 호환 배포 설명자
+        Response: hawkBit 호환 배포 설명자 (JSON) 또는 304 Not Modified
 
     Modern Python features / 현대 파이썬 특징:
     - async/await 비동기 I/O
@@ -129,32 +341,98 @@ async def poll_controller(controller_id: str) -> Dict[str, Any]:
     
     # Simulated deployment response following hawkBit DDI specification
     deployment_response = {
+        # How long the device should wait before polling again
+        "config": {
+            "polling": {
+                "sleep": POLLING_SLEEP
+            }
+        },
+
         "deploymentBase": {
             # Unique identifier for this deployment
             "id": "12345",
             
-            # Download section contains all artifacts to be downloaded
-            "download": {
-                "links": {
-                    # Named artifact links - "firmware" is a common artifact name
-                    "firmware": {
-                        # Absolute URL where device can download the file
-                        "href": f"http://localhost:8000/files/firmware.bin",
-                        
-                        # File size in bytes - helps devices validate complete download
-                        "size": 1048576  # 1MB = 1024 * 1024 bytes
+            "deployment": {
+                # Download/update handling hints ("skip" | "attempt" | "forced")
+                "download": "forced",
+                "update": "forced",
+
+                # Software modules (chunks) and their artifacts
+                "chunks": [
+                    {
+                        "part": "os",
+                        "version": "1.0.0",
+                        "name": "firmware",
+                        "artifacts": [
+                            {
+                                "filename": "firmware.bin",
+
+                                # File size in bytes - helps devices validate complete download
+                                "size": 1048576,  # 1MB = 1024 * 1024 bytes
+
+                                # Digests the device verifies while streaming the download
+                                "hashes": compute_file_hashes("files/firmware.bin"),
+
+                                # Absolute URLs where device can download the file
+                                "_links": {
+                                    "download-http": {
+                                        "href": f"http://localhost:8000/files/firmware.bin"
+                                    }
+                                }
+                            }
+                        ]
                     }
-                }
+                ]
             }
         }
     }
+
+    # Additional software modules (applications, configuration) like a real multi-chunk deployment
+    chunks = deployment_response["deploymentBase"]["deployment"]["chunks"]
+    if ARTIFACT_ENCODING == "gzip":
+        chunks[0]["artifacts"][0].update({
+            "filename": "firmware.bin.gz",
+            "size": len(gzip_file("files/firmware.bin")),
+            "hashes": compute_gzip_hashes("files/firmware.bin"),
+            "_links": {"download-http": {"href": "http://localhost:8000/files/firmware.bin.gz"}}
+        })
+    for index in range(EXTRA_CHUNKS):
+        chunks.append({
+            "part": "bApp",
+            "version": f"1.0.{index}",
+            "name": f"application-{index}",
+            "artifacts": [{
+                "filename": f"application-{index}.bin",
+                "size": 1048576,
+                "hashes": {name: hashlib.new(name, f"application-{index}".encode()).hexdigest()
+                           for name in ("sha1", "md5", "sha256")},
+                "_links": {
+                    "download-http": {"href": "http://localhost:8000/files/firmware.bin"}
+                }
+            }]
+        })
     
+    body = json.dumps(deployment_response, separators=(",", ":")).encode()
+    etag = hashlib.sha256(body).hexdigest()[:32]
+    headers = {"Vary": "Accept-Encoding"}
+
+    # Compressed representation: its own strong ETag, so a cached variant is never mixed up
+    if len(body) >= GZIP_MIN_SIZE and accepts_gzip(request.headers.get("accept-encoding")):
+        body = gzip.compress(body, compresslevel=6)
+        etag += "-gzip"
+        headers["Content-Encoding"] = "gzip"
+    headers["ETag"] = f'"{etag}"'
+
+    if etag_matches(request.headers.get("if-none-match"), headers["ETag"]):
+        print(f"Device {controller_id} polled for updates - not modified")
+        return Response(status_code=304, headers={"ETag": headers["ETag"], "Vary": headers["Vary"]})
+
     print(f"Device {controller_id} polled for updates - returning deployment 12345")
-    return deployment_response
+    return Response(content=body, media_type="application/json", headers=headers)
 
 
 @app.get("/files/firmware.bin")
-async def download_firmware():
+async def download_firmware(request: Request):
     """
     File Download Endpoint - Serves binary firmware files
 
@@ -172,11 +450,21 @@ async def download_firmware():
     - Rate limiting
     - 업로드 파일 바이러스 스캔
 
+    Range requests / 부분 요청:
+    - "Range: bytes=start-end" 요청에는 206 Partial Content로 해당 구간만 전송
+    - 클라이언트의 병렬 segment 다운로드와 이어받기(resume)에 사용
+
+    Transfer compression / 압축 전송:
+    - Range 없는 요청이 Accept-Encoding: gzip을 보내면 "Content-Encoding: gzip"으로 전송
+      (HAWKBIT_DOWNLOAD_ENCODING=1 클라이언트). 해시는 원본 기준이므로 클라이언트는 풀린
+      데이터로 검증합니다. Range 응답은 항상 원본 바이트입니다.
+
     Returns:
         FileResponse: 적절한 헤더와 함께 스트리밍 전송
+        StreamingResponse: Range 요청시 206 부분 응답
 
     Raises:
-        HTTPException: 파일을 찾을 수 없을 때 404 반환
+        HTTPException: 파일을 찾을 수 없을 때 404, 범위가 잘못되면 416 반환
     """
     
     # Relative path to firmware file
@@ -191,6 +479,50 @@ async def download_firmware():
             detail="Firmware file not found"
         )
     
+    file_size = os.path.getsize(firmware_path)
+    common_headers = {
+        "Accept-Ranges": "bytes",
+        "Cache-Control": "no-cache",
+        "X-Content-Type-Options": "nosniff"
+    }
+
+    # Partial content for range requests (segmented / resumed downloads)
+    range_header = request.headers.get("range")
+    if range_header:
+        byte_range = parse_range_header(range_header, file_size)
+        if byte_range is None:
+            raise HTTPException(
+                status_code=416,
+                detail="Requested range not satisfiable",
+                headers={"Content-Range": f"bytes */{file_size}"}
+            )
+        start, end = byte_range
+        return StreamingResponse(
+            stream_file_range(firmware_path, start, end),
+            status_code=206,
+            media_type="application/octet-stream",
+            headers={
+                **common_headers,
+                "Content-Range": f"bytes {start}-{end}/{file_size}",
+                "Content-Length": str(end - start + 1)
+            }
+        )
+
+    if accepts_gzip(request.headers.get("accept-encoding")):
+        return Response(
+            content=gzip_file(firmware_path),
+            media_type="application/octet-stream",
+            headers={**common_headers, "Content-Encoding": "gzip", "Vary": "Accept-Encoding"}
+        )
+
+    # With injected latency, stream in chunks so the delay applies per chunk
+    if LATENCY_SECONDS > 0:
+        return StreamingResponse(
+            stream_file_range(firmware_path, 0, file_size - 1),
+            media_type="application/octet-stream",
+            headers={**common_headers, "Content-Length": str(file_size)}
+        )
+
     # FileResponse streams file efficiently without loading into memory
     # This is superior to reading file into bytes for large files
     return FileResponse(
@@ -201,12 +533,72 @@ async def download_firmware():
         # Optional headers for better client handling:
         headers={
             "Content-Disposition": "attachment; filename=firmware.bin",
+            "Accept-Ranges": "bytes",  # Advertise range support
             "Cache-Control": "no-cache",  # Prevent caching of firmware
             "X-Content-Type-Options": "nosniff"  # Security header
         }
     )
 
 
+@app.get("/files/firmware.bin.cidx")
+async def download_chunk_index(request: Request) -> Response:
+    """
+    Delta update chunk index / delta 업데이트용 chunk index
+
+    클라이언트의 delta 모드(HAWKBIT_DELTA=1)가 artifact URL + ".cidx"로 요청합니다.
+    `python chunk_index.py files/firmware.bin`으로 미리 만든 파일이 있으면 그대로 보내고,
+    없으면 이미지에서 만들어 캐시합니다. 텍스트이므로 poll 응답처럼 gzip으로 보냅니다.
+    """
+    firmware_path = "files/firmware.bin"
+    if not os.path.exists(firmware_path):
+        raise HTTPException(status_code=404, detail="Firmware file not found")
+    index_path = firmware_path + ".cidx"
+    if os.path.exists(index_path) and os.path.getmtime(index_path) >= os.path.getmtime(firmware_path):
+        with open(index_path) as f:
+            index = f.read()
+    else:
+        index = cached_chunk_index(firmware_path, os.path.getmtime(firmware_path))
+
+    body = index.encode()
+    headers = {"Cache-Control": "no-cache", "Vary": "Accept-Encoding"}
+    if len(body) >= GZIP_MIN_SIZE and accepts_gzip(request.headers.get("accept-encoding")):
+        body = gzip.compress(body, compresslevel=6)
+        headers["Content-Encoding"] = "gzip"
+    return Response(content=body, media_type="text/plain", headers=headers)
+
+
+@app.get("/files/firmware.bin.gz")
+async def download_compressed_firmware(request: Request) -> Response:
+    """
+    Compressed artifact / 압축된 채로 저장된 artifact (HAWKBIT_ARTIFACT_ENCODING=gzip)
+
+    파일 자체가 .gz이므로 Content-Encoding 없이 그대로 보내며 Range 요청도 지원합니다.
+    클라이언트는 파일 이름으로 형식을 알아보고 받으면서 풀어 기록합니다.
+    """
+    if not os.path.exists("files/firmware.bin"):
+        raise HTTPException(status_code=404, detail="Firmware file not found")
+    data = gzip_file("files/firmware.bin")
+    headers = {"Accept-Ranges": "bytes", "Cache-Control": "no-cache"}
+
+    range_header = request.headers.get("range")
+    if range_header:
+        byte_range = parse_range_header(range_header, len(data))
+        if byte_range is None:
+            raise HTTPException(
+                status_code=416,
+                detail="Requested range not satisfiable",
+                headers={"Content-Range": f"bytes */{len(data)}"}
+            )
+        start, end = byte_range
+        return Response(
+            content=data[start:end + 1],
+            status_code=206,
+            media_type="application/gzip",
+            headers={**headers, "Content-Range": f"bytes {start}-{end}/{len(data)}"}
+        )
+    return Response(content=data, media_type="application/gzip", headers=headers)
+
+
 @app.post("/rest/v1/ddi/v1/controller/device/{controller_id}/deploymentBase/{deployment_id}")
 async def report_status(
     controller_id: str, 